@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkScan.h"
 #include "sk_tool_utils.h"
 
 enum Align {
@@ -84,3 +85,144 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// The same path, scaled up to fill a large canvas and stroked ahead of time, so that drawing it
+// is a single huge fill with tens of thousands of edges. It's drawn with delta AA, both serially
+// and with gSkUseThreadedDAA splitting it into bands that are scan converted in parallel.
+class ScaledBigPathBench : public Benchmark {
+    SkPath      fPath;
+    SkString    fName;
+    bool        fThreaded;
+
+    static constexpr int kWidth  = 4096;
+    static constexpr int kHeight = 2048;
+
+public:
+    ScaledBigPathBench(bool threaded) : fThreaded(threaded) {
+        fName.printf("bigpath_scaled_daa_%s", threaded ? "threaded" : "serial");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(kWidth, kHeight);
+    }
+
+    void onDelayedSetup() override {
+        SkPath path;
+        sk_tool_utils::make_big_path(path);
+        SkMatrix matrix;
+        matrix.setRectToRect(path.getBounds(), SkRect::MakeIWH(kWidth, kHeight),
+                             SkMatrix::kFill_ScaleToFit);
+        path.transform(matrix);
+
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(8);
+        paint.setStrokeJoin(SkPaint::kRound_Join);
+        paint.getFillPath(path, &fPath);
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fWasForcingDAA = gSkForceDeltaAA.exchange(true);
+        fWasThreaded   = gSkUseThreadedDAA.exchange(fThreaded);
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkForceDeltaAA   = fWasForcingDAA;
+        gSkUseThreadedDAA = fWasThreaded;
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    bool fWasForcingDAA = false;
+    bool fWasThreaded   = false;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ScaledBigPathBench(false); )
+DEF_BENCH( return new ScaledBigPathBench(true); )
+
+// A few large fills with mostly solid interiors (a circle, a star, an even-odd ring), drawn with
+// the default scan converters, or with sparse AA blitting whole interior tiles at once.
+class LargeFillBench : public Benchmark {
+    SkPath      fPaths[3];
+    SkString    fName;
+    bool        fSparse;
+
+    static constexpr int kSize = 2048;
+
+public:
+    LargeFillBench(bool sparse) : fSparse(sparse) {
+        fName.printf("largefill_%s", sparse ? "sparse" : "default");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(kSize, kSize);
+    }
+
+    void onDelayedSetup() override {
+        const SkScalar c = kSize * 0.5f;
+        fPaths[0].addCircle(c, c, c - 10);
+
+        for (int i = 0; i < 10; i++) {
+            SkScalar r = (i & 1) ? c * 0.45f : c - 10,
+                     a = i * SK_ScalarPI / 5;
+            SkPoint  p = { c + r * SkScalarSin(a), c - r * SkScalarCos(a) };
+            i ? fPaths[1].lineTo(p) : fPaths[1].moveTo(p);
+        }
+        fPaths[1].close();
+
+        fPaths[2].addCircle(c, c, c - 10);
+        fPaths[2].addCircle(c, c, c * 0.5f);
+        fPaths[2].setFillType(SkPath::kEvenOdd_FillType);
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fWasForcingSparse = gSkForceSparseAA.exchange(fSparse);
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkForceSparseAA = fWasForcingSparse;
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPaths[i % SK_ARRAY_COUNT(fPaths)], paint);
+        }
+    }
+
+private:
+    bool fWasForcingSparse = false;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new LargeFillBench(false); )
+DEF_BENCH( return new LargeFillBench(true); )
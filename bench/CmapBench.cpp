@@ -9,6 +9,9 @@
 #include "SkCanvas.h"
 #include "SkFont.h"
 #include "SkTypeface.h"
+#include "SkUTF.h"
+
+#include <vector>
 
 enum {
     NGLYPHS = 100
@@ -78,8 +81,76 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Converts a long run of text to glyphs with SkFont::textToGlyphs(), as UTF-8 or UTF-16. The
+// text is either all Latin, or a mix of Latin, Cyrillic, CJK and a few emoji beyond the BMP.
+class CMAPTextBench : public Benchmark {
+public:
+    CMAPTextBench(SkTextEncoding encoding, bool mixed) : fEncoding(encoding), fMixed(mixed) {
+        fName.printf("cmap_textToGlyphs_%s_%s", encoding == kUTF8_SkTextEncoding ? "utf8" : "utf16",
+                     mixed ? "mixed" : "latin");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        static const SkUnichar kMixed[] = { 0x0416, 0x0439, 0x4E2D, 0x6587, 0x1F600 };
+        std::vector<char> utf8;
+        for (int i = 0; i < kCharCount; ++i) {
+            SkUnichar c = 'a' + (i % 26);
+            if (i % 10 == 9) {
+                c = ' ';
+            } else if (fMixed && i % 7 == 3) {
+                c = kMixed[(i / 7) % SK_ARRAY_COUNT(kMixed)];
+            }
+            char bytes[SkUTF::kMaxBytesInUTF8Sequence];
+            utf8.insert(utf8.end(), bytes, bytes + SkUTF::ToUTF8(c, bytes));
+            uint16_t units[2];
+            size_t count = SkUTF::ToUTF16(c, units);
+            fUTF16.insert(fUTF16.end(), units, units + count);
+        }
+        fUTF8.append(utf8.data(), utf8.size());
+        fGlyphs.resize(kCharCount);
+        fFont.setTypeface(SkTypeface::MakeDefault());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const void* text = fUTF8.c_str();
+        size_t bytes = fUTF8.size();
+        if (fEncoding == kUTF16_SkTextEncoding) {
+            text = fUTF16.data();
+            bytes = fUTF16.size() * sizeof(uint16_t);
+        }
+        for (int i = 0; i < loops; ++i) {
+            fFont.textToGlyphs(text, bytes, fEncoding, fGlyphs.data(), kCharCount);
+        }
+    }
+
+private:
+    static constexpr int kCharCount = 2000;
+
+    const SkTextEncoding fEncoding;
+    const bool fMixed;
+    SkString fName;
+    SkString fUTF8;
+    std::vector<uint16_t> fUTF16;
+    std::vector<uint16_t> fGlyphs;
+    SkFont fFont;
+
+    typedef Benchmark INHERITED;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "paint_textToGlyphs"); )
 DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charsToGlyphs"); )
 DEF_BENCH( return new CMAPBench(charsToGlyphsNull_proc, "face_charsToGlyphs_null"); )
+
+DEF_BENCH( return new CMAPTextBench(kUTF8_SkTextEncoding,  false); )
+DEF_BENCH( return new CMAPTextBench(kUTF8_SkTextEncoding,  true); )
+DEF_BENCH( return new CMAPTextBench(kUTF16_SkTextEncoding, false); )
+DEF_BENCH( return new CMAPTextBench(kUTF16_SkTextEncoding, true); )
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkExecutor.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+#include "SkTime.h"
+
+// Runs batches of busy-looping tasks through a thread pool, to compare how much each kind of pool
+// costs per task.  With 10us tasks the pool's own overhead dominates; with 1ms tasks it shouldn't.
+class ExecutorBench : public Benchmark {
+public:
+    enum Pool { kFIFO, kLIFO, kWorkStealing };
+
+    ExecutorBench(Pool pool, int taskMicros, bool nested)
+        : fPool(pool), fTaskMicros(taskMicros), fNested(nested) {
+        static const char* kPoolNames[] = { "fifo", "lifo", "workstealing" };
+        fName.printf("executor_%s_%dus%s", kPoolNames[pool], taskMicros, nested ? "_nested" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        switch (fPool) {
+            case kFIFO:         fExecutor = SkExecutor::MakeFIFOThreadPool();         break;
+            case kLIFO:         fExecutor = SkExecutor::MakeLIFOThreadPool();         break;
+            case kWorkStealing: fExecutor = SkExecutor::MakeWorkStealingThreadPool(); break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // Aim for about 10ms of work per loop, whatever the task size.
+        const int tasks = SkTMax(1, 10000 / fTaskMicros);
+        const double taskNanos = fTaskMicros * 1000.0;
+        SkExecutor& executor = *fExecutor;
+
+        auto spin = [taskNanos] {
+            const double start = SkTime::GetNSecs();
+            while (SkTime::GetNSecs() - start < taskNanos) {}
+        };
+
+        while (loops-- > 0) {
+            SkTaskGroup group(executor);
+            if (fNested) {
+                // Tasks fan out into their own task groups, as e.g. per-tile work might.
+                const int outer = SkTMax(1, tasks / 16);
+                group.batch(outer, [&](int) {
+                    SkTaskGroup inner(executor);
+                    inner.batch(16, [&](int) { spin(); });
+                    inner.wait();
+                });
+            } else {
+                group.batch(tasks, [&](int) { spin(); });
+            }
+            group.wait();
+        }
+    }
+
+private:
+    Pool                        fPool;
+    int                         fTaskMicros;
+    bool                        fNested;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kFIFO,           10, false);)
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kLIFO,           10, false);)
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kWorkStealing,   10, false);)
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kFIFO,         1000, false);)
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kLIFO,         1000, false);)
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kWorkStealing, 1000, false);)
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kFIFO,           10, true);)
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kLIFO,           10, true);)
+DEF_BENCH(return new ExecutorBench(ExecutorBench::kWorkStealing,   10, true);)
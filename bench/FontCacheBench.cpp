@@ -16,6 +16,9 @@
 
 #include "gUniqueGlyphIDs.h"
 
+#include <thread>
+#include <vector>
+
 #define gUniqueGlyphIDs_Sentinel    0xFFFF
 
 static int count_glyphs(const uint16_t start[]) {
@@ -142,6 +145,65 @@ private:
 };
 DEF_BENCH( return new FontCacheBench(); )
 
+// Measures the same glyph runs as FontCacheBench on each of fThreads threads at once. Every
+// thread does the same work, so ideally the time stays flat as threads are added; the glyph
+// lookups per second are fThreads * glyphs in gUniqueGlyphIDs * loops / time.
+class FontCacheThreadedBench : public Benchmark {
+public:
+    FontCacheThreadedBench(int threads) : fThreads(threads) {
+        fName.printf("fontcache_threads_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fFont.setEdging(SkFont::Edging::kAntiAlias);
+        // Fill the cache, so we time lookups rather than the scaler context.
+        measure_all(fFont, 1);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < fThreads; ++i) {
+            threads.emplace_back([this, loops] { measure_all(fFont, loops); });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    static void measure_all(const SkFont& font, int loops) {
+        const uint16_t* array = gUniqueGlyphIDs;
+        while (*array != gUniqueGlyphIDs_Sentinel) {
+            int count = count_glyphs(array);
+            for (int i = 0; i < loops; ++i) {
+                (void)font.measureText(array, count * sizeof(uint16_t), kGlyphID_SkTextEncoding);
+            }
+            array += count + 1;    // skip the sentinel
+        }
+    }
+
+    const int fThreads;
+    SkString  fName;
+    SkFont    fFont;
+
+    typedef Benchmark INHERITED;
+};
+DEF_BENCH( return new FontCacheThreadedBench(1); )
+DEF_BENCH( return new FontCacheThreadedBench(2); )
+DEF_BENCH( return new FontCacheThreadedBench(4); )
+DEF_BENCH( return new FontCacheThreadedBench(8); )
+DEF_BENCH( return new FontCacheThreadedBench(16); )
+DEF_BENCH( return new FontCacheThreadedBench(32); )
+
 // undefine this to run the efficiency test
 //DEF_BENCH( return new FontCacheEfficiency(); )
 
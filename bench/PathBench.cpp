@@ -1242,3 +1242,58 @@ DEF_BENCH( return new CommonConvexBench(200, 16, false, false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, false, true); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  true); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkCoverageDelta.h"
+#include "SkOpts.h"
+
+// Delta AA spends most of its time turning rows of coverage deltas into alphas, both in
+// SkCoverageDeltaMask and for dense rows of SkCoverageDeltaList.  This times just that step.
+class CoverageDeltasToAlphaBench : public Benchmark {
+    enum { N = 1024 };
+
+    SkString    fName;
+    bool        fEvenOdd;
+    bool        fConvex;
+    SkFixed     fDeltas[N];
+    SkAlpha     fAlphas[N];
+
+public:
+    CoverageDeltasToAlphaBench(bool evenOdd, bool convex) : fEvenOdd(evenOdd), fConvex(convex) {
+        fName.printf("coverage_deltas_to_alpha_%s",
+                     convex ? "convex" : evenOdd ? "evenodd" : "nonzero");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        // Convex coverages stay within [-SK_Fixed1, SK_Fixed1]; the others wind a few times.
+        SkRandom rand;
+        SkFixed coverage = 0;
+        for (int i = 0; i < N; ++i) {
+            SkFixed next = fConvex ? rand.nextRangeU(0, SK_Fixed1)
+                                   : rand.nextRangeU(0, 4 * SK_Fixed1) - 2 * SK_Fixed1;
+            fDeltas[i] = next - coverage;
+            coverage = next;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkOpts::coverage_deltas_to_alpha(fDeltas, fAlphas, N, fEvenOdd, false, fConvex);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new CoverageDeltasToAlphaBench(false, false); )
+DEF_BENCH( return new CoverageDeltasToAlphaBench(true,  false); )
+DEF_BENCH( return new CoverageDeltasToAlphaBench(false, true); )
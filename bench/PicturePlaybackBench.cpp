@@ -5,14 +5,18 @@
  * found in the LICENSE file.
  */
 #include "Benchmark.h"
+#include "RecordingBench.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkData.h"
 #include "SkPaint.h"
+#include "SkPath.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkPoint.h"
 #include "SkRandom.h"
 #include "SkRect.h"
+#include "SkStream.h"
 #include "SkString.h"
 
 // This is designed to emulate about 4 screens of textual content
@@ -95,3 +99,144 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Draws 512px viewports of a 20k x 20k serialized picture, as a tiled viewer of a large SKP
+// would, reading either the whole picture or only the ops each viewport needs.
+class DeserializedTileBench : public Benchmark {
+public:
+    explicit DeserializedTileBench(bool culled) : fCulled(culled) {
+        fName.printf("deserialized_tile_512_%s", culled ? "culled" : "whole");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(kTile, kTile); }
+
+    void onDelayedSetup() override {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kSize, kSize, &factory);
+            SkRandom rand;
+            for (int i = 0; i < 100000; i++) {
+                SkScalar x = rand.nextRangeScalar(0, kSize),
+                         y = rand.nextRangeScalar(0, kSize);
+                SkPaint paint;
+                paint.setColor(rand.nextU() | 0xFF000000);
+                if (i % 4) {
+                    canvas->drawRect(SkRect::MakeXYWH(x, y, 64, 64), paint);
+                } else {
+                    SkPath path;
+                    path.moveTo(x, y);
+                    path.quadTo(x + 64, y, x + 64, y + 64);
+                    path.lineTo(x, y + 32);
+                    paint.setAntiAlias(true);
+                    canvas->drawPath(path, paint);
+                }
+            }
+        fData = recorder.finishRecordingAsPicture()->serialize();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            // The same viewports for both variants.
+            SkRandom rand;
+            for (int j = 0; j < 4; j++) {
+                SkRect tile = SkRect::MakeXYWH(kTile * rand.nextULessThan(kSize / kTile),
+                                               kTile * rand.nextULessThan(kSize / kTile),
+                                               kTile, kTile);
+                SkMemoryStream stream(fData);
+                sk_sp<SkPicture> pic = fCulled ? SkPicture::MakeFromStream(&stream, tile)
+                                               : SkPicture::MakeFromStream(&stream);
+                SkAutoCanvasRestore ar(canvas, true/*save now*/);
+                canvas->translate(-tile.x(), -tile.y());
+                canvas->clipRect(tile);
+                canvas->drawPicture(pic);
+            }
+        }
+    }
+
+private:
+    static constexpr int kSize = 20000;
+    static constexpr int kTile = 512;
+
+    bool          fCulled;
+    SkString      fName;
+    sk_sp<SkData> fData;
+};
+
+DEF_BENCH( return new DeserializedTileBench(false); )
+DEF_BENCH( return new DeserializedTileBench(true ); )
+
+// Plays back a dashboard-like picture, with and without SkRecordOptimize2(): panels that
+// cover up what was drawn under them, bar charts drawn a rect at a time, and the redundant
+// clips and translates of code that lays out each panel in steps.
+class OptimizedPlaybackBench : public Benchmark {
+public:
+    explicit OptimizedPlaybackBench(bool optimize) : fOptimize(optimize) {
+        fName.printf("optimized_playback_%s", optimize ? "on" : "off");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(kSize, kSize); }
+
+    void onDelayedSetup() override {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kSize, kSize, &factory);
+            SkRandom rand;
+            // Placeholders, mostly hidden by the backgrounds of the panels.
+            SkPaint paint;
+            for (int i = 0; i < 500; i++) {
+                paint.setColor(rand.nextU() | 0xFF000000);
+                canvas->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, kSize - 64),
+                                                  rand.nextRangeScalar(0, kSize - 64), 64, 64),
+                                 paint);
+            }
+            paint.setColor(SK_ColorWHITE);
+            for (int y = 0; y < kSize; y += kPanel) {
+                for (int x = 0; x < kSize; x += kPanel) {
+                    canvas->drawRect(SkRect::MakeXYWH(x, y, kPanel, kPanel), paint);
+                }
+            }
+            for (int y = 0; y < kSize; y += kPanel) {
+                for (int x = 0; x < kSize; x += kPanel) {
+                    canvas->save();
+                    canvas->translate(x, y);
+                    canvas->translate(8, 8);
+                    canvas->clipRect(SkRect::MakeWH(kPanel - 16, kPanel - 16));
+                    SkPaint bar;
+                    for (int i = 0; i < 60; i++) {
+                        SkScalar h = rand.nextRangeScalar(8, kPanel - 16);
+                        bar.setColor(rand.nextU() | 0xFF000000);
+                        canvas->drawRect(SkRect::MakeXYWH(i * 4, kPanel - 16 - h, 3, h), bar);
+                    }
+                    canvas->clipRect(SkRect::MakeWH(kPanel - 16, kPanel - 16));
+                    bar.setColor(SK_ColorBLACK);
+                    canvas->drawRect(SkRect::MakeXYWH(0, kPanel - 17, kPanel - 16, 1), bar);
+                    canvas->restore();
+                }
+            }
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+        fPicture = picture;
+        if (fOptimize) {
+            fPicture = OptimizePicture(picture.get(), true/*useBBH*/, nullptr);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPicture(fPicture);
+        }
+    }
+
+private:
+    static constexpr int kSize  = 1024;
+    static constexpr int kPanel = 256;
+
+    bool             fOptimize;
+    SkString         fName;
+    sk_sp<SkPicture> fPicture;
+};
+
+DEF_BENCH( return new OptimizedPlaybackBench(false); )
+DEF_BENCH( return new OptimizedPlaybackBench(true ); )
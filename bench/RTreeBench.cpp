@@ -7,10 +7,14 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
 #include "SkString.h"
 
+DECLARE_bool(verbose);
+
 // confine rectangles to a smallish area, so queries generally hit something, and overlap occurs:
 static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
@@ -19,11 +23,19 @@ static const int GRID_WIDTH = 100;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
+// The benches below run with either tree; their names start with its prefix.
+template <typename Tree> struct TreeTraits;
+template <> struct TreeTraits<SkRTree>       { static const char* Prefix() { return "rtree"; } };
+template <> struct TreeTraits<SkPackedRTree> {
+    static const char* Prefix() { return "packed_rtree"; }
+};
+
 // Time how long it takes to build an R-Tree.
+template <typename Tree>
 class RTreeBuildBench : public Benchmark {
 public:
     RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+        fName.printf("%s_%s_build", TreeTraits<Tree>::Prefix(), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -42,7 +54,7 @@ protected:
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
+            Tree tree;
             tree.insert(rects.get(), NUM_BUILD_RECTS);
             SkASSERT(rects != nullptr);  // It'd break this bench if the tree took ownership of rects.
         }
@@ -54,10 +66,11 @@ private:
 };
 
 // Time how long it takes to perform queries on an R-Tree.
+template <typename Tree>
 class RTreeQueryBench : public Benchmark {
 public:
     RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+        fName.printf("%s_%s_query", TreeTraits<Tree>::Prefix(), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -74,6 +87,10 @@ protected:
             rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
         }
         fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        // Benchmarks only time things, so log the memory each tree takes to compare them.
+        if (FLAGS_verbose) {
+            SkDebugf("%s: %zu bytes\n", fName.c_str(), fTree.bytesUsed());
+        }
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -89,7 +106,7 @@ protected:
         }
     }
 private:
-    SkRTree fTree;
+    Tree fTree;
     MakeRectProc fProc;
     SkString fName;
     typedef Benchmark INHERITED;
@@ -127,12 +144,22 @@ static inline SkRect make_concentric_rects(SkRandom&, int index, int numRects) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeBuildBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeBuildBench("concentric", &make_concentric_rects));
-
-DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeBuildBench<SkPackedRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedRTree>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench<SkPackedRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedRTree>("concentric", &make_concentric_rects));
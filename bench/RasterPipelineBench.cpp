@@ -0,0 +1,243 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkOpts.h"
+#include "SkRasterPipeline.h"
+#include "SkTemplates.h"
+
+// These benches run a few small pipelines, each built around one interesting stage, with the
+// stages SkOpts built for each instruction set this CPU can run.  Every loop runs kPixels pixels,
+// so pixels/ns is kPixels divided by the reported time.  kPixels isn't a multiple of any stride,
+// so each row ends with a tail, as it usually does when drawing.
+static const int kPixels = 1000;
+
+enum class Pipeline {
+    kSrcover8888,   // lowp: load_8888, load_8888_dst, srcover, store_8888
+    kF16,           // highp: load_f16, premul, store_f16
+    kToSRGB,        // highp: load_f32, to_srgb, store_f32
+    kGradient,      // highp: seed_shader, matrix_scale_translate, gradient, store_8888
+    kBilerp,        // highp: seed_shader, matrix_scale_translate, bilerp_clamp_8888, store_8888
+};
+
+class RasterPipelineISABench : public Benchmark {
+public:
+    RasterPipelineISABench(Pipeline pipeline, const char* pipelineName, const char* isa)
+        : fPipeline(pipeline)
+        , fISA(isa) {
+        fName.printf("SkRasterPipeline_%s_%s", pipelineName, isa);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        if (backend != kNonRendering_Backend) {
+            return false;
+        }
+        const bool supported = SkOpts::SetRasterPipelineStagesForBenchmarks(fISA);
+        SkOpts::SetRasterPipelineStagesForBenchmarks("native");
+        return supported;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSrc8888.reset(kPixels);
+        fDst8888.reset(kPixels);
+        fF16    .reset(kPixels);
+        fF32    .reset(kPixels * 4);
+        for (int i = 0; i < kPixels; i++) {
+            fSrc8888[i] = 0x7f3f1f0f + i;
+            fDst8888[i] = 0xff204060;
+            fF16    [i] = 0x3c00380034003000;   // 1.0, 0.5, 0.25, 0.125 as halfs.
+        }
+        for (int i = 0; i < kPixels * 4; i++) {
+            fF32[i] = (i % 97) * (1/96.0f);
+        }
+
+        // Four stops, with each array padded to 8 floats like SkGradientShaderBase does.
+        for (int c = 0; c < 4; c++) {
+            for (int i = 0; i < 8; i++) {
+                fStops[c][i] = i < 4 ? 0.25f * c : 0;
+                fBias [c][i] = i < 4 ? 0.1f  * i : 0;
+            }
+            fGradient.fs[c] = fStops[c];
+            fGradient.bs[c] = fBias [c];
+        }
+        const float ts[] = { 0, 0.25f, 0.5f, 0.75f };
+        memcpy(fTs, ts, sizeof(ts));
+        fGradient.stopCount = 4;
+        fGradient.ts = fTs;
+        fGradient.interpolatedInPremul = false;
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        SkAssertResult(SkOpts::SetRasterPipelineStagesForBenchmarks(fISA));
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkOpts::SetRasterPipelineStagesForBenchmarks("native");
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRasterPipeline_MemoryCtx src = { fSrc8888.get(), kPixels },
+                                   dst = { fDst8888.get(), kPixels },
+                                   f16 = { fF16.get(),     kPixels },
+                                   f32 = { fF32.get(),     kPixels };
+        SkRasterPipeline_GatherCtx gather = { fSrc8888.get(), 32, 32, kPixels / 32 };
+        const float toUnit[] = { 1.0f / kPixels, 1, 0, 0 },
+                    toGrid[] = { 0.03125f, 1, 0, 0 };
+
+        SkRasterPipeline_<256> p;
+        switch (fPipeline) {
+            case Pipeline::kSrcover8888:
+                p.append(SkRasterPipeline::load_8888, &src);
+                p.append(SkRasterPipeline::load_8888_dst, &dst);
+                p.append(SkRasterPipeline::srcover);
+                p.append(SkRasterPipeline::store_8888, &dst);
+                break;
+            case Pipeline::kF16:
+                p.append(SkRasterPipeline::load_f16, &f16);
+                p.append(SkRasterPipeline::premul);
+                p.append(SkRasterPipeline::store_f16, &f16);
+                break;
+            case Pipeline::kToSRGB:
+                p.append(SkRasterPipeline::load_f32, &f32);
+                p.append(SkRasterPipeline::to_srgb);
+                p.append(SkRasterPipeline::store_f32, &f32);
+                break;
+            case Pipeline::kGradient:
+                p.append(SkRasterPipeline::seed_shader);
+                p.append(SkRasterPipeline::matrix_scale_translate, toUnit);
+                p.append(SkRasterPipeline::gradient, &fGradient);
+                p.append(SkRasterPipeline::store_8888, &dst);
+                break;
+            case Pipeline::kBilerp:
+                p.append(SkRasterPipeline::seed_shader);
+                p.append(SkRasterPipeline::matrix_scale_translate, toGrid);
+                p.append(SkRasterPipeline::bilerp_clamp_8888, &gather);
+                p.append(SkRasterPipeline::store_8888, &dst);
+                break;
+        }
+
+        while (loops --> 0) {
+            p.run(0,0,kPixels,1);
+        }
+    }
+
+private:
+    Pipeline    fPipeline;
+    const char* fISA;
+    SkString    fName;
+
+    SkAutoTMalloc<uint32_t> fSrc8888, fDst8888;
+    SkAutoTMalloc<uint64_t> fF16;
+    SkAutoTMalloc<float>    fF32;
+
+    float fStops[4][8], fBias[4][8], fTs[4];
+    SkRasterPipeline_GradientCtx fGradient;
+
+    typedef Benchmark INHERITED;
+};
+
+#define DEF_ISA_BENCHES(pipeline, name)                                       \
+    DEF_BENCH(return new RasterPipelineISABench(pipeline, name, "baseline");) \
+    DEF_BENCH(return new RasterPipelineISABench(pipeline, name, "sse41");)    \
+    DEF_BENCH(return new RasterPipelineISABench(pipeline, name, "avx");)      \
+    DEF_BENCH(return new RasterPipelineISABench(pipeline, name, "hsw");)      \
+    DEF_BENCH(return new RasterPipelineISABench(pipeline, name, "skx");)
+
+DEF_ISA_BENCHES(Pipeline::kSrcover8888, "srcover_8888")
+DEF_ISA_BENCHES(Pipeline::kF16,         "f16")
+DEF_ISA_BENCHES(Pipeline::kToSRGB,      "to_srgb")
+DEF_ISA_BENCHES(Pipeline::kGradient,    "gradient")
+DEF_ISA_BENCHES(Pipeline::kBilerp,      "bilerp")
+
+// Compares each of SkRasterPipeline's fused stages against the pair of stages it replaces.
+enum class Fusion { kLoadBGRA, kLoadBGRADst, kStoreBGRA, kGatherBGRA };
+
+class RasterPipelineFusionBench : public Benchmark {
+public:
+    RasterPipelineFusionBench(Fusion fusion, const char* fusionName, bool fused)
+        : fFusion(fusion)
+        , fFused(fused) {
+        fName.printf("SkRasterPipeline_fusion_%s_%s", fusionName, fused ? "fused" : "unfused");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSrc.reset(kPixels);
+        fDst.reset(kPixels);
+        for (int i = 0; i < kPixels; i++) {
+            fSrc[i] = 0x7f3f1f0f + i;
+            fDst[i] = 0xff204060;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRasterPipeline_MemoryCtx src = { fSrc.get(), kPixels },
+                                   dst = { fDst.get(), kPixels };
+        SkRasterPipeline_GatherCtx gather = { fSrc.get(), 32, 32, kPixels / 32 };
+        const float toGrid[] = { 0.03125f, 1, 0, 0 };
+
+        const bool wasFusing = gSkFuseRasterPipelineStages.exchange(fFused);
+        SkRasterPipeline_<256> p;
+        switch (fFusion) {
+            case Fusion::kLoadBGRA:
+                p.append(SkRasterPipeline::load_8888, &src);
+                p.append(SkRasterPipeline::swap_rb);
+                p.append(SkRasterPipeline::store_8888, &dst);
+                break;
+            case Fusion::kLoadBGRADst:
+                p.append(SkRasterPipeline::load_8888, &src);
+                p.append(SkRasterPipeline::load_8888_dst, &dst);
+                p.append(SkRasterPipeline::swap_rb_dst);
+                p.append(SkRasterPipeline::srcover);
+                p.append(SkRasterPipeline::store_8888, &dst);
+                break;
+            case Fusion::kStoreBGRA:
+                p.append(SkRasterPipeline::load_8888, &src);
+                p.append(SkRasterPipeline::premul);
+                p.append(SkRasterPipeline::swap_rb);
+                p.append(SkRasterPipeline::store_8888, &dst);
+                break;
+            case Fusion::kGatherBGRA:
+                p.append(SkRasterPipeline::seed_shader);
+                p.append(SkRasterPipeline::matrix_scale_translate, toGrid);
+                p.append(SkRasterPipeline::gather_8888, &gather);
+                p.append(SkRasterPipeline::swap_rb);
+                p.append(SkRasterPipeline::store_8888, &dst);
+                break;
+        }
+        gSkFuseRasterPipelineStages = wasFusing;
+
+        while (loops --> 0) {
+            p.run(0,0,kPixels,1);
+        }
+    }
+
+private:
+    Fusion   fFusion;
+    bool     fFused;
+    SkString fName;
+
+    SkAutoTMalloc<uint32_t> fSrc, fDst;
+
+    typedef Benchmark INHERITED;
+};
+
+#define DEF_FUSION_BENCHES(fusion, name)                                  \
+    DEF_BENCH(return new RasterPipelineFusionBench(fusion, name, true);)  \
+    DEF_BENCH(return new RasterPipelineFusionBench(fusion, name, false);)
+
+DEF_FUSION_BENCHES(Fusion::kLoadBGRA,    "load_bgra")
+DEF_FUSION_BENCHES(Fusion::kLoadBGRADst, "load_bgra_dst")
+DEF_FUSION_BENCHES(Fusion::kStoreBGRA,   "store_bgra")
+DEF_FUSION_BENCHES(Fusion::kGatherBGRA,  "gather_bgra")
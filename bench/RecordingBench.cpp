@@ -67,12 +67,21 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
+#include "SkPictureCommon.h"
+#include "SkPictureData.h"
+#include "SkReadBuffer.h"
 #include "SkSerialProcs.h"
 
-DeserializePictureBench::DeserializePictureBench(const char* name, sk_sp<SkData> data)
+DeserializePictureBench::DeserializePictureBench(const char* name, sk_sp<SkData> data,
+                                                 bool mapped)
     : fName(name)
     , fEncodedPicture(std::move(data))
-{}
+    , fMapped(mapped)
+{
+    if (fMapped) {
+        fName.append("_mapped");
+    }
+}
 
 const char* DeserializePictureBench::onGetName() {
     return fName.c_str();
@@ -86,8 +95,49 @@ SkIPoint DeserializePictureBench::onGetSize() {
     return SkIPoint::Make(128, 128);
 }
 
+void DeserializePictureBench::onDelayedSetup() {
+    if (!fMapped) {
+        return;
+    }
+    // Pictures saved before their data was padded can't be read in place, so save them again.
+    SkMemoryStream stream(fEncodedPicture);
+    SkPictInfo info;
+    if (SkPicture_StreamIsSKP(&stream, &info) &&
+        info.getVersion() < SkReadBuffer::kPadPictureData_Version) {
+        if (sk_sp<SkPicture> picture = SkPicture::MakeFromData(fEncodedPicture.get())) {
+            fEncodedPicture = picture->serialize();
+        }
+    }
+}
+
 void DeserializePictureBench::onDraw(int loops, SkCanvas*) {
     for (int i = 0; i < loops; ++i) {
-        SkPicture::MakeFromData(fEncodedPicture.get());
+        fPicture = fMapped ? SkPicture::MakeFromMappedData(fEncodedPicture)
+                           : SkPicture::MakeFromData(fEncodedPicture.get());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#include "SkBigPicture.h"
+#include "SkRTree.h"
+#include "SkRecordDraw.h"
+#include "SkRecordOpts.h"
+#include "SkRecorder.h"
+
+sk_sp<SkPicture> OptimizePicture(const SkPicture* pic, bool useBBH, SkRecordOptStats* stats) {
+    const SkRect cull = pic->cullRect();
+    sk_sp<SkRecord> record(new SkRecord);
+    SkRecorder recorder(record.get(), cull);
+    pic->playback(&recorder);
+    SkRecordOptimize2(record.get(), stats, true/*hardClip*/);
+
+    std::unique_ptr<SkBBoxHierarchy> bbh;
+    if (useBBH) {
+        bbh.reset(new SkRTree);
+        SkAutoTMalloc<SkRect> bounds(record->count());
+        SkRecordFillBounds(cull, *record, bounds);
+        bbh->insert(bounds, record->count());
     }
+    return sk_make_sp<SkBigPicture>(cull, record.release(), nullptr, bbh.release(),
+                                    recorder.approxBytesUsedBySubPictures());
 }
@@ -12,6 +12,8 @@
 #include "SkPicture.h"
 #include "SkLiteDL.h"
 
+struct SkRecordOptStats;
+
 class PictureCentricBench : public Benchmark {
 public:
     PictureCentricBench(const char* name, const SkPicture*);
@@ -42,21 +44,31 @@ private:
     typedef PictureCentricBench INHERITED;
 };
 
+// If mapped, reads the picture in place with SkPicture::MakeFromMappedData().
 class DeserializePictureBench : public Benchmark {
 public:
-    DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture);
+    DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture, bool mapped = false);
 
 protected:
     const char* onGetName() override;
     bool isSuitableFor(Backend) override;
     SkIPoint onGetSize() override;
+    void onDelayedSetup() override;
     void onDraw(int loops, SkCanvas*) override;
 
 private:
-    SkString      fName;
-    sk_sp<SkData> fEncodedPicture;
+    SkString         fName;
+    sk_sp<SkData>    fEncodedPicture;
+    bool             fMapped;
+    // The last picture read stays alive, so the memory it uses shows up in RSS.
+    sk_sp<SkPicture> fPicture;
 
     typedef Benchmark INHERITED;
 };
 
+// Re-records pic and runs SkRecordOptimize2() over it, with an R-Tree if useBBH, to compare the
+// playback of the two.  Benches play pictures back under hard clips, so this also no-ops covered
+// draws.
+sk_sp<SkPicture> OptimizePicture(const SkPicture* pic, bool useBBH, SkRecordOptStats* stats);
+
 #endif//RecordingBench_DEFINED
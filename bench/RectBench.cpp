@@ -14,6 +14,7 @@
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 DEFINE_double(strokeWidth, -1.0, "If set, use this stroke width in RectBench.");
 
@@ -332,6 +333,64 @@ private:
     SkString fName;
 };
 
+// Many small solid rects, like a dashboard or chart draws each frame, drawn one drawRect() at a
+// time or as one batch with per-rect colors. Each loop draws all count rects.
+class RectBatchBench : public Benchmark {
+public:
+    RectBatchBench(int count, bool batched) : fCount(count), fBatched(batched) {
+        fName.printf("rects_%s_%d", batched ? "batch" : "single", count);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(W, H); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        fRects.reset(fCount);
+        fColors.reset(fCount);
+        for (int i = 0; i < fCount; i++) {
+            int x = rand.nextU() % W,
+                y = rand.nextU() % H;
+            fRects[i].setXYWH(SkIntToScalar(x), SkIntToScalar(y),
+                              SkIntToScalar(rand.nextRangeU(2, 12)),
+                              SkIntToScalar(rand.nextRangeU(2, 12)));
+            fColors[i] = rand.nextU() | 0xFF000000;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < loops; i++) {
+            if (fBatched) {
+                canvas->experimental_DrawRectsV1(fRects.get(), fColors.get(), fCount, paint);
+            } else {
+                for (int j = 0; j < fCount; j++) {
+                    paint.setColor(fColors[j]);
+                    canvas->drawRect(fRects[j], paint);
+                }
+            }
+        }
+    }
+
+private:
+    enum {
+        W = 1024,
+        H = 768,
+    };
+    int                     fCount;
+    bool                    fBatched;
+    SkString                fName;
+    SkAutoTMalloc<SkRect>   fRects;
+    SkAutoTMalloc<SkColor>  fColors;
+
+    typedef Benchmark INHERITED;
+};
+
 // AA rects
 DEF_BENCH(return new RectBench(1, 0, true);)
 DEF_BENCH(return new RectBench(1, 4, true);)
@@ -368,6 +427,14 @@ DEF_BENCH(return new RectBench(1, 0, false, true);)
 DEF_BENCH(return new LocalCoordsRectBench(true, true);)
 DEF_BENCH(return new LocalCoordsRectBench(false, true);)
 
+// Batched rects
+DEF_BENCH(return new RectBatchBench(  1000, false);)
+DEF_BENCH(return new RectBatchBench(  1000, true);)
+DEF_BENCH(return new RectBatchBench( 10000, false);)
+DEF_BENCH(return new RectBatchBench( 10000, true);)
+DEF_BENCH(return new RectBatchBench(100000, false);)
+DEF_BENCH(return new RectBatchBench(100000, true);)
+
 /* init the blitmask bench
  */
 DEF_BENCH(return new BlitMaskBench(SkCanvas::kPoints_PointMode,
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if defined(SK_USING_SKSHAPER)
+
+#include "SkExecutor.h"
+#include "SkFont.h"
+#include "SkShaper.h"
+#include "SkString.h"
+#include "SkTypeface.h"
+
+#include <vector>
+
+namespace {
+
+// Gives the shaper somewhere to put its runs, and drops them.
+class DiscardRunHandler final : public SkShaper::RunHandler {
+public:
+    Buffer newRunBuffer(const RunInfo&, const SkFont&, int glyphCount,
+                        SkSpan<const char>) override {
+        if (glyphCount > (int)fGlyphs.size()) {
+            fGlyphs.resize(glyphCount);
+            fPositions.resize(glyphCount);
+        }
+        return { fGlyphs.data(), fPositions.data(), nullptr };
+    }
+    void commitRun() override {}
+    void commitLine() override {}
+
+private:
+    std::vector<SkGlyphID> fGlyphs;
+    std::vector<SkPoint> fPositions;
+};
+
+}  // namespace
+
+// Shapes a document of Latin, Arabic and CJK paragraphs with SkShaper::ShapeParagraphs(), on
+// this thread, or on a pool of that many threads.
+class ShapeParagraphsBench : public Benchmark {
+public:
+    explicit ShapeParagraphsBench(int threads) : fThreads(threads) {
+        fName.printf("shaper_paragraphs_%dthreads", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        static const char* kSentences[] = {
+            "The quick brown fox jumps over the lazy dog, and then it naps in the sun. ",
+            "\xd9\x86\xd8\xb5 \xd8\xb9\xd8\xb1\xd8\xa8\xd9\x8a \xd9\x82\xd8\xb5\xd9\x8a\xd8\xb1 "
+            "\xd9\x84\xd9\x84\xd8\xa7\xd8\xae\xd8\xaa\xd8\xa8\xd8\xa7\xd8\xb1. ",
+            "\xe8\xbf\x99\xe6\x98\xaf\xe4\xb8\x80\xe4\xb8\xaa\xe7\x94\xa8\xe4\xba\x8e\xe6\xb5\x8b"
+            "\xe8\xaf\x95\xe7\x9a\x84\xe4\xb8\xad\xe6\x96\x87\xe6\xae\xb5\xe8\x90\xbd\xe3\x80\x82",
+        };
+        for (int i = 0; i < kParagraphCount; i++) {
+            // Paragraphs are mostly in one script, and a few sentences long.
+            SkString text;
+            for (int j = 0; j < 2 + i % 5; j++) {
+                text.append(kSentences[(i + (j == 3)) % SK_ARRAY_COUNT(kSentences)]);
+            }
+            fTexts.push_back(text);
+        }
+        fHandlers.resize(kParagraphCount);
+        fFont = SkFont(SkTypeface::MakeDefault(), 14);
+        if (fThreads > 1) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::vector<SkShaper::Paragraph> paragraphs;
+        for (int i = 0; i < kParagraphCount; i++) {
+            paragraphs.push_back({&fHandlers[i], fFont, fTexts[i].c_str(), fTexts[i].size(), true,
+                                  {0, 0}, 400, {0, 0}});
+        }
+        for (int i = 0; i < loops; i++) {
+            SkShaper::ShapeParagraphs(SkSpan<SkShaper::Paragraph>(paragraphs), fExecutor.get(),
+                                      fThreads);
+        }
+    }
+
+private:
+    static constexpr int kParagraphCount = 300;
+
+    const int fThreads;
+    SkString fName;
+    std::vector<SkString> fTexts;
+    std::vector<DiscardRunHandler> fHandlers;
+    SkFont fFont;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new ShapeParagraphsBench(1);)
+DEF_BENCH(return new ShapeParagraphsBench(2);)
+DEF_BENCH(return new ShapeParagraphsBench(4);)
+DEF_BENCH(return new ShapeParagraphsBench(8);)
+
+#endif
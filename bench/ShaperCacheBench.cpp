@@ -0,0 +1,119 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if defined(SK_USING_SKSHAPER)
+
+#include "SkFont.h"
+#include "SkRandom.h"
+#include "SkShaperCache.h"
+#include "SkString.h"
+#include "SkTypeface.h"
+
+#include <vector>
+
+namespace {
+
+// Gives the shaper somewhere to put its runs, and drops them.
+class DiscardRunHandler final : public SkShaper::RunHandler {
+public:
+    Buffer newRunBuffer(const RunInfo&, const SkFont&, int glyphCount,
+                        SkSpan<const char>) override {
+        if (glyphCount > (int)fGlyphs.size()) {
+            fGlyphs.resize(glyphCount);
+            fPositions.resize(glyphCount);
+            fClusters.resize(glyphCount);
+        }
+        return { fGlyphs.data(), fPositions.data(), fClusters.data() };
+    }
+    void commitRun() override {}
+    void commitLine() override {}
+
+private:
+    std::vector<SkGlyphID> fGlyphs;
+    std::vector<SkPoint> fPositions;
+    std::vector<uint32_t> fClusters;
+};
+
+}  // namespace
+
+// Shapes 10k labels, like the cells of a table, of which repeatPercent repeat an earlier label.
+// Each loop starts with an empty cache, so the misses of the first time a label is shaped count.
+class ShaperCacheBench : public Benchmark {
+public:
+    ShaperCacheBench(int repeatPercent, bool cached)
+        : fRepeatPercent(repeatPercent), fCached(cached) {
+        fName.printf("shaper_labels_%drepeat_%s", repeatPercent, cached ? "cached" : "uncached");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        static const char* kWords[] = {
+            "Total", "Revenue", "Pending", "Shipped", "Invoice", "Customer", "Status",
+            "Overdue", "Paid", "Draft", "Account", "Balance", "Region", "North", "South",
+        };
+        SkRandom rand;
+        for (int i = 0; i < kLabelCount; i++) {
+            if (i > 0 && (int)rand.nextULessThan(100) < fRepeatPercent) {
+                fLabels.push_back(fLabels[rand.nextULessThan(i)]);
+                continue;
+            }
+            SkString label;
+            for (int words = 1 + rand.nextULessThan(3); words > 0; words--) {
+                label.appendf("%s ", kWords[rand.nextULessThan(SK_ARRAY_COUNT(kWords))]);
+            }
+            label.appendf("%u", rand.nextULessThan(100000));
+            fLabels.push_back(label);
+        }
+
+        fFont = SkFont(SkTypeface::MakeDefault(), 13);
+        fShaper = SkShaper::Make();
+        if (fCached) {
+            fShaper = SkShaperCache::Make(std::move(fShaper));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        DiscardRunHandler handler;
+        for (int i = 0; i < loops; i++) {
+            if (fCached) {
+                static_cast<SkShaperCache*>(fShaper.get())->purgeAll();
+            }
+            for (const SkString& label : fLabels) {
+                fShaper->shape(&handler, fFont, label.c_str(), label.size(), true, {0, 0}, 200);
+            }
+        }
+    }
+
+private:
+    static constexpr int kLabelCount = 10000;
+
+    const int fRepeatPercent;
+    const bool fCached;
+    SkString fName;
+    std::vector<SkString> fLabels;
+    SkFont fFont;
+    std::unique_ptr<SkShaper> fShaper;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new ShaperCacheBench(0, false);)
+DEF_BENCH(return new ShaperCacheBench(0, true);)
+DEF_BENCH(return new ShaperCacheBench(50, false);)
+DEF_BENCH(return new ShaperCacheBench(50, true);)
+DEF_BENCH(return new ShaperCacheBench(90, false);)
+DEF_BENCH(return new ShaperCacheBench(90, true);)
+
+#endif
@@ -10,12 +10,20 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkExecutor.h"
+#include "SkFontMgr.h"
+#include "SkGlyphRunPainter.h"
 #include "SkStrikeCache.h"
 #include "SkGraphics.h"
+#include "SkRemoteGlyphCache.h"
+#include "SkRemoteGlyphCacheImpl.h"
 #include "SkTaskGroup.h"
+#include "SkTextBlob.h"
 #include "SkTypeface.h"
 #include "sk_tool_utils.h"
 
+DECLARE_bool(verbose);
 
 static void do_font_stuff(SkFont* font) {
     SkPaint defaultPaint;
@@ -115,3 +123,322 @@ DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+
+// Times the first frame of a new process: making the strikes and glyph images for some text at a
+// few sizes in an empty cache, with or without a strike cache file from an earlier run.
+class SkStrikeCacheColdStartBench : public Benchmark {
+public:
+    explicit SkStrikeCacheColdStartBench(bool useFile) : fUseFile(useFile) { }
+
+protected:
+    const char* onGetName() override {
+        return fUseFile ? "SkStrikeCacheColdStart_file" : "SkStrikeCacheColdStart_nofile";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkFont font(SkTypeface::MakeDefault());
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        for (int c = ' '; c < 'z'; c++) {
+            fGlyphs[c - ' '] = font.unicharToGlyph(c);
+        }
+        if (fUseFile) {
+            // What an earlier run would have saved. The data is in memory, as a file read
+            // recently would be in the page cache.
+            SkStrikeCache cache;
+            this->firstFrame(&cache);
+            fData = SkStrikeCacheFile::Serialize(cache);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            // A new file each time, as a new process would open, so that indexing it and hashing
+            // the typeface's data are timed too.
+            SkStrikeCache cache;
+            if (fUseFile) {
+                cache.setPreloader(SkStrikeCacheFile::Make(fData));
+            }
+            this->firstFrame(&cache);
+        }
+    }
+
+private:
+    void firstFrame(SkStrikeCache* cache) {
+        SkFont font(SkTypeface::MakeDefault());
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        SkPaint defaultPaint;
+        for (SkScalar size : {12, 14, 16, 24, 36}) {
+            font.setSize(size);
+            auto strike = cache->findOrCreateStrike(
+                    font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I());
+            SkExclusiveStrikePtr exclusive(strike);
+            for (SkGlyphID glyph : fGlyphs) {
+                exclusive->findImage(exclusive->getGlyphIDMetrics(glyph));
+            }
+        }
+    }
+
+    const bool fUseFile;
+    SkGlyphID fGlyphs['z' - ' '];
+    sk_sp<SkData> fData;
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkStrikeCacheColdStartBench(false); )
+DEF_BENCH( return new SkStrikeCacheColdStartBench(true); )
+
+// A full frame of CJK text drawn into an empty font cache, with the glyph images either made one
+// at a time as they're drawn, or made ahead of the draw on a thread pool.
+class SkGlyphCacheCJKFrameBench : public Benchmark {
+public:
+    explicit SkGlyphCacheCJKFrameBench(bool prerasterize) : fPrerasterize(prerasterize) { }
+
+protected:
+    const char* onGetName() override {
+        return fPrerasterize ? "SkGlyphCacheCJKFrame_prerasterize" : "SkGlyphCacheCJKFrame_serial";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        static constexpr int kColumns = 64, kRows = 48;
+        static constexpr SkScalar kSize = 16;
+        // A typeface with ideographs, if there is one; otherwise this is a frame of whatever
+        // glyphs the default typeface has.
+        sk_sp<SkTypeface> typeface(SkFontMgr::RefDefault()->matchFamilyStyleCharacter(
+                nullptr, SkFontStyle(), nullptr, 0, 0x4E00));
+        SkFont font(typeface ? typeface : SkTypeface::MakeDefault(), kSize);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        font.setSubpixel(true);
+
+        SkTextBlobBuilder builder;
+        const auto& run = builder.allocRunPos(font, kColumns * kRows);
+        SkUnichar text[kColumns * kRows];
+        for (int i = 0; i < kColumns * kRows; i++) {
+            text[i] = 0x4E00 + i;
+        }
+        font.textToGlyphs(text, sizeof(text), kUTF32_SkTextEncoding, run.glyphs, kColumns * kRows);
+        int glyphCount = font.getTypefaceOrDefault()->countGlyphs();
+        for (int i = 0; i < kColumns * kRows; i++) {
+            if (run.glyphs[i] == 0) {
+                run.glyphs[i] = 1 + i % SkTMax(glyphCount - 1, 1);
+            }
+            run.points()[i] = {(i % kColumns) * kSize, (i / kColumns + 1) * kSize};
+        }
+        fBlob = builder.make();
+
+        fBitmap.allocN32Pixels(kColumns * kSize, kRows * kSize + kSize / 2);
+        if (fPrerasterize) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // Draw the way a raster surface would, with the same painter settings as its device.
+        SkCanvas canvas(fBitmap);
+        SkGlyphRunListPainter painter(SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType),
+                                      kN32_SkColorType, nullptr,
+                                      SkStrikeCache::GlobalStrikeCache());
+        SkPaint paint;
+        const SkTextBlob* blobs[] = { fBlob.get() };
+        const SkPoint origins[] = { {0, 0} };
+        for (int i = 0; i < loops; i++) {
+            SkGraphics::PurgeFontCache();
+            canvas.clear(SK_ColorWHITE);
+            if (fPrerasterize) {
+                painter.prerasterizeForBitmapDevice(SkSpan<const SkTextBlob* const>{blobs, 1},
+                                                    origins, paint, SkMatrix::I(),
+                                                    fExecutor.get());
+            }
+            canvas.drawTextBlob(fBlob, 0, 0, paint);
+        }
+    }
+
+private:
+    const bool fPrerasterize;
+    sk_sp<SkTextBlob> fBlob;
+    SkBitmap fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkGlyphCacheCJKFrameBench(false); )
+DEF_BENCH( return new SkGlyphCacheCJKFrameBench(true); )
+
+// Makes glyph images straight from a scaler context, either one getImage() call per glyph or one
+// getImages() call for each batch of batchSize glyphs.
+class SkScalerContextImagesBench : public Benchmark {
+public:
+    SkScalerContextImagesBench(int batchSize, bool batched)
+        : fBatchSize(batchSize), fBatched(batched) {
+        fName.printf("SkScalerContextImages_%s_%d", batched ? "batched" : "single", batchSize);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkFont font(SkTypeface::MakeDefault(), 16);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        SkAutoDescriptor ad;
+        SkScalerContextEffects effects;
+        auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+                font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+        fScaler = font.getTypefaceOrDefault()->createScalerContext(effects, desc);
+
+        // Enough glyphs to make the images of about a thousand each loop.
+        int glyphCount = SkTMax(2, (int)fScaler->getGlyphCount());
+        int total = SkTMax(fBatchSize, 1000 / fBatchSize * fBatchSize);
+        fGlyphs.reserve(total);
+        size_t imageSize = 0;
+        for (int i = 0; i < total; i++) {
+            fGlyphs.emplace_back(SkPackedGlyphID(1 + i % (glyphCount - 1)));
+            fScaler->getMetrics(&fGlyphs.back());
+            imageSize += fGlyphs.back().computeImageSize();
+        }
+        fImages.reset(imageSize);
+        char* image = fImages.get();
+        for (SkGlyph& glyph : fGlyphs) {
+            glyph.fImage = image;
+            image += glyph.computeImageSize();
+            fGlyphPtrs.push_back(&glyph);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            for (size_t start = 0; start < fGlyphPtrs.size(); start += fBatchSize) {
+                if (fBatched) {
+                    fScaler->getImages(SkSpan<const SkGlyph* const>{&fGlyphPtrs[start],
+                                                                    (size_t)fBatchSize});
+                } else {
+                    for (int j = 0; j < fBatchSize; j++) {
+                        fScaler->getImage(*fGlyphPtrs[start + j]);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const int fBatchSize;
+    const bool fBatched;
+    SkString fName;
+    std::unique_ptr<SkScalerContext> fScaler;
+    std::vector<SkGlyph> fGlyphs;
+    std::vector<const SkGlyph*> fGlyphPtrs;
+    SkAutoTMalloc<char> fImages;
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkScalerContextImagesBench(1, false); )
+DEF_BENCH( return new SkScalerContextImagesBench(1, true); )
+DEF_BENCH( return new SkScalerContextImagesBench(10, false); )
+DEF_BENCH( return new SkScalerContextImagesBench(10, true); )
+DEF_BENCH( return new SkScalerContextImagesBench(1000, false); )
+DEF_BENCH( return new SkScalerContextImagesBench(1000, true); )
+
+// Sends the images of some text at a few sizes and its paths from an SkStrikeServer to an
+// SkStrikeClient, in the original or the compressed format, and times either writing or reading
+// the data. With --verbose, setup logs the bytes sent per glyph.
+class SkStrikeServerBench : public Benchmark {
+public:
+    SkStrikeServerBench(bool compressed, bool decode) : fCompressed(compressed), fDecode(decode) {
+        fName.printf("SkStrikeServer_%s_%s", compressed ? "compressed" : "raw",
+                     decode ? "decode" : "encode");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fManager = sk_make_sp<DiscardableManager>();
+        this->writeGlyphs(&fData);
+        if (FLAGS_verbose) {
+            SkDebugf("%s: %d glyphs, %.1f bytes per glyph\n", fName.c_str(), fGlyphCount,
+                     (double)fData.size() / fGlyphCount);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::vector<uint8_t> data;
+        for (int i = 0; i < loops; i++) {
+            if (fDecode) {
+                SkStrikeCache strikeCache;
+                SkStrikeClient client(fManager, false, &strikeCache);
+                bool success = fCompressed ? client.readCompressedStrikeData(fData.data(),
+                                                                             fData.size())
+                                           : client.readStrikeData(fData.data(), fData.size());
+                SkAssertResult(success);
+            } else {
+                data.clear();
+                this->writeGlyphs(&data);
+            }
+        }
+    }
+
+private:
+    class DiscardableManager : public SkStrikeServer::DiscardableHandleManager,
+                               public SkStrikeClient::DiscardableHandleManager {
+    public:
+        SkDiscardableHandleId createHandle() override { return fNextHandleId++; }
+        bool lockHandle(SkDiscardableHandleId) override { return true; }
+        bool deleteHandle(SkDiscardableHandleId) override { return true; }
+
+    private:
+        SkDiscardableHandleId fNextHandleId = 0u;
+    };
+
+    void writeGlyphs(std::vector<uint8_t>* data) {
+        SkStrikeServer server(fManager.get());
+        SkFont font(SkTypeface::MakeDefault());
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        fGlyphCount = 0;
+        for (SkScalar size : {12, 16, 24, 36, 64}) {
+            font.setSize(size);
+            SkScalerContextEffects effects;
+            auto* cacheState = server.getOrCreateCache(
+                    SkPaint(), font, SkSurfaceProps(0, kUnknown_SkPixelGeometry), SkMatrix::I(),
+                    SkScalerContextFlags::kNone, &effects);
+            // The largest size is sent as paths.
+            for (SkUnichar c = ' '; c < 'z'; c++) {
+                cacheState->addGlyph(SkPackedGlyphID(font.unicharToGlyph(c)), size == 64);
+                fGlyphCount++;
+            }
+        }
+        if (fCompressed) {
+            server.writeCompressedStrikeData(data);
+        } else {
+            server.writeStrikeData(data);
+        }
+    }
+
+    const bool fCompressed;
+    const bool fDecode;
+    SkString fName;
+    sk_sp<DiscardableManager> fManager;
+    std::vector<uint8_t> fData;
+    int fGlyphCount = 0;
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkStrikeServerBench(false, false); )
+DEF_BENCH( return new SkStrikeServerBench(false, true); )
+DEF_BENCH( return new SkStrikeServerBench(true, false); )
+DEF_BENCH( return new SkStrikeServerBench(true, true); )
@@ -9,6 +9,7 @@
 #include "Resources.h"
 #include "SkCanvas.h"
 #include "SkFont.h"
+#include "SkGlyphAtlas.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkStream.h"
@@ -109,3 +110,63 @@ class TextBlobMakeBench : public SkTextBlobBench {
     }
 };
 DEF_BENCH( return new TextBlobMakeBench(); )
+
+/*
+ * A paragraph of small text on a raster canvas, with the glyph masks blitted either from their own
+ * images or from the strike's glyph atlas.
+ */
+class TextBlobRasterAtlasBench : public Benchmark {
+public:
+    explicit TextBlobRasterAtlasBench(bool useAtlas) : fUseAtlas(useAtlas) {}
+
+private:
+    const char* onGetName() override {
+        return fUseAtlas ? "TextBlobRasterAtlasBench_atlas" : "TextBlobRasterAtlasBench_glyph";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kRaster_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkFont font(sk_tool_utils::create_portable_typeface("serif", SkFontStyle()), 11);
+        font.setSubpixel(true);
+
+        const char* text = "Keep your sentences short, but not overly so. ";
+        SkTDArray<uint16_t> glyphs;
+        glyphs.setCount(font.countText(text, strlen(text), kUTF8_SkTextEncoding));
+        font.textToGlyphs(text, strlen(text), kUTF8_SkTextEncoding, glyphs.begin(), glyphs.count());
+        SkTDArray<SkScalar> xpos;
+        xpos.setCount(glyphs.count());
+        font.getXPos(glyphs.begin(), glyphs.count(), xpos.begin());
+
+        SkTextBlobBuilder builder;
+        for (int line = 0; line < 40; line++) {
+            for (int x = 0; x < 3; x++) {
+                const auto& run = builder.allocRunPosH(font, glyphs.count(), 14 + line * 13);
+                memcpy(run.glyphs, glyphs.begin(), glyphs.count() * sizeof(uint16_t));
+                for (int i = 0; i < glyphs.count(); i++) {
+                    run.pos[i] = xpos[i] + x * 230 + (line % 4) * 0.25f;
+                }
+            }
+        }
+        fBlob = builder.make();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        bool wasUsingAtlas = gSkUseRasterGlyphAtlas;
+        gSkUseRasterGlyphAtlas = fUseAtlas;
+        SkPaint paint;
+        for (int i = 0; i < loops; i++) {
+            canvas->drawTextBlob(fBlob, 0, 0, paint);
+        }
+        gSkUseRasterGlyphAtlas = wasUsingAtlas;
+    }
+
+    const bool fUseAtlas;
+    sk_sp<SkTextBlob> fBlob;
+
+    typedef Benchmark INHERITED;
+};
+DEF_BENCH( return new TextBlobRasterAtlasBench(false); )
+DEF_BENCH( return new TextBlobRasterAtlasBench(true); )
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkAdvancedTypefaceMetrics.h"
+#include "SkMutex.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTestEmptyTypeface.h"
+#include "SkTypefaceCache.h"
+
+#include <thread>
+#include <vector>
+
+// Finds typefaces in an SkTypefaceCache of a few hundred, on one thread or on 16 at once. Each
+// thread does loops finds, so lookups per second are threads * loops / time. The finds either
+// scan the cache under a mutex, as every font match used to, scan it under the cache's shared
+// locks, or look up the family and style's hash.
+class TypefaceCacheBench : public Benchmark {
+public:
+    enum Mode { kLockedScan, kScan, kHashed };
+
+    TypefaceCacheBench(Mode mode, int threads) : fMode(mode), fThreads(threads) {
+        static const char* kModeNames[] = { "lockedscan", "scan", "hashed" };
+        fName.printf("TypefaceCache_%s_%dthreads", kModeNames[mode], threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < kTypefaceCount; i++) {
+            SkString family;
+            family.printf("family%d", i / 4);
+            SkFontStyle style(400 + 300 * (i % 2), SkFontStyle::kNormal_Width,
+                              i % 4 < 2 ? SkFontStyle::kUpright_Slant
+                                        : SkFontStyle::kItalic_Slant);
+            fTypefaces.push_back(SkTestEmptyTypeface::Make());
+            fHashes.push_back(SkTypefaceCache::HashFamilyAndStyle(family.c_str(), style));
+            fCache.add(fTypefaces.back(), fMode == kHashed ? fHashes.back() : 0);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        auto find = [this, loops](int thread) {
+            for (int i = 0; i < loops; i++) {
+                int index = (thread * 97 + i * 13) % kTypefaceCount;
+                SkFontID id = fTypefaces[index]->uniqueID();
+                sk_sp<SkTypeface> found;
+                if (fMode == kLockedScan) {
+                    SkAutoMutexAcquire lock(fMutex);
+                    found = fCache.findByProcAndRef(MatchID, &id);
+                } else if (fMode == kScan) {
+                    found = fCache.findByProcAndRef(MatchID, &id);
+                } else {
+                    found = fCache.findByProcAndRef(fHashes[index], MatchID, &id);
+                }
+                SkASSERT(found);
+            }
+        };
+
+        if (fThreads == 1) {
+            find(0);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (int i = 0; i < fThreads; i++) {
+            threads.emplace_back(find, i);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    static constexpr int kTypefaceCount = 256;
+
+    static bool MatchID(SkTypeface* face, void* ctx) {
+        return face->uniqueID() == *static_cast<SkFontID*>(ctx);
+    }
+
+    const Mode fMode;
+    const int fThreads;
+    SkString fName;
+    SkTypefaceCache fCache;
+    SkMutex fMutex;
+    std::vector<sk_sp<SkTypeface>> fTypefaces;
+    std::vector<uint32_t> fHashes;
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new TypefaceCacheBench(TypefaceCacheBench::kLockedScan, 1); )
+DEF_BENCH( return new TypefaceCacheBench(TypefaceCacheBench::kScan, 1); )
+DEF_BENCH( return new TypefaceCacheBench(TypefaceCacheBench::kHashed, 1); )
+DEF_BENCH( return new TypefaceCacheBench(TypefaceCacheBench::kLockedScan, 16); )
+DEF_BENCH( return new TypefaceCacheBench(TypefaceCacheBench::kScan, 16); )
+DEF_BENCH( return new TypefaceCacheBench(TypefaceCacheBench::kHashed, 16); )
@@ -25,6 +25,7 @@
 #include "SkAutoMalloc.h"
 #include "SkBBoxHierarchy.h"
 #include "SkBitmapRegionDecoder.h"
+#include "SkBlitterCache.h"
 #include "SkCanvas.h"
 #include "SkCodec.h"
 #include "SkColorSpacePriv.h"
@@ -34,12 +35,14 @@
 #include "SkData.h"
 #include "SkDebugfTracer.h"
 #include "SkEventTracingPriv.h"
+#include "SkGlyphAtlas.h"
 #include "SkGraphics.h"
 #include "SkJSONWriter.h"
 #include "SkLeanWindows.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPictureRecorder.h"
+#include "SkRecordOpts.h"
 #include "SkScan.h"
 #include "SkString.h"
 #include "SkSurface.h"
@@ -124,10 +127,13 @@ DEFINE_string(zoom, "1.0,0", "Comma-separated zoomMax,zoomPeriodMs factors for a
 DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 DEFINE_bool(lite, false, "Use SkLiteRecorder in recording benchmarks?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
+DEFINE_bool(optimizeSKPs, false, "Also play back each SKP after SkRecordOptimize2()?");
 DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
 DEFINE_bool(gpuStatsDump, false, "Dump GPU states after each benchmark to json");
+DEFINE_bool(blitterStats, false, "Count the raster blitters one frame of each benchmark chooses "
+                                 "and reuses, print them, and add them to json.");
 DEFINE_bool(keepAlive, false, "Print a message every so often so that we don't time out");
 DEFINE_bool(csv, false, "Print status in CSV format");
 DEFINE_string(sourceType, "",
@@ -147,7 +153,16 @@ static SkString humanize(double ms) {
 
 bool Target::init(SkImageInfo info, Benchmark* bench) {
     if (Benchmark::kRaster_Backend == config.backend) {
-        this->surface = SkSurface::MakeRaster(info);
+        // t8888 rasterizes on FLAGS_backendThreads threads; sweep it to measure scaling.
+        if (config.name.equals("t8888")) {
+            // Every bench shares one pool of those threads.
+            static std::unique_ptr<SkExecutor> executor =
+                    SkExecutor::MakeFIFOThreadPool(FLAGS_backendThreads);
+            this->surface = SkSurface::MakeRasterThreaded(info, FLAGS_backendTiles,
+                                                          executor.get());
+        } else {
+            this->surface = SkSurface::MakeRaster(info);
+        }
         if (!this->surface) {
             return false;
         }
@@ -474,6 +489,7 @@ static void create_config(const SkCommandLineConfig* config, SkTArray<Config>* c
 
     CPU_CONFIG(a8,   kRaster_Backend, kAlpha_8_SkColorType, kPremul_SkAlphaType, nullptr)
     CPU_CONFIG(8888, kRaster_Backend,     kN32_SkColorType, kPremul_SkAlphaType, nullptr)
+    CPU_CONFIG(t8888, kRaster_Backend,    kN32_SkColorType, kPremul_SkAlphaType, nullptr)
     CPU_CONFIG(565,  kRaster_Backend, kRGB_565_SkColorType, kOpaque_SkAlphaType, nullptr)
 
     // 'narrow' has a gamut narrower than sRGB, and different transfer function.
@@ -593,10 +609,12 @@ public:
                       , fGMs(skiagm::GMRegistry::Head())
                       , fCurrentRecording(0)
                       , fCurrentDeserialPicture(0)
+                      , fCurrentMappedPicture(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
                       , fCurrentSVG(0)
                       , fCurrentUseMPD(0)
+                      , fOptimizedSKP(false)
                       , fCurrentCodec(0)
                       , fCurrentAndroidCodec(0)
                       , fCurrentBRDImage(0)
@@ -752,6 +770,21 @@ public:
             return new DeserializePictureBench(name.c_str(), std::move(data));
         }
 
+        // And again read in place, to compare their load times and RSS with the above.
+        while (fCurrentMappedPicture < fSKPs.count()) {
+            const SkString& path = fSKPs[fCurrentMappedPicture++];
+            sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+            if (!data) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "deserial";
+            fSKPBytes = static_cast<double>(data->size());
+            fSKPOps   = 0;
+            return new DeserializePictureBench(name.c_str(), std::move(data), true);
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
@@ -779,6 +812,24 @@ public:
                     return new SKPBench(name.c_str(), pic.get(), fClip, fScales[fCurrentScale],
                                         fUseMPDs[fCurrentUseMPD++], FLAGS_loopSKP);
                 }
+                if (FLAGS_optimizeSKPs && !fOptimizedSKP) {
+                    fOptimizedSKP = true;
+                    SkRecordOptStats stats;
+                    pic = OptimizePicture(pic.get(), FLAGS_bbh, &stats);
+                    SkString name = SkOSPath::Basename(path.c_str());
+                    if (FLAGS_verbose) {
+                        SkDebugf("%s: optimize2 no-opped %d matrices, %d clips, "
+                                 "%d covered draws, %d merged draws\n", name.c_str(),
+                                 stats.fMatrices, stats.fClips, stats.fCoveredDraws,
+                                 stats.fMergedDraws);
+                    }
+                    name.append("_opt");
+                    fSourceType = "skp";
+                    fBenchType = "playback";
+                    return new SKPBench(name.c_str(), pic.get(), fClip, fScales[fCurrentScale],
+                                        false, FLAGS_loopSKP);
+                }
+                fOptimizedSKP = false;
                 fCurrentUseMPD = 0;
                 fCurrentSKP++;
             }
@@ -1067,10 +1118,12 @@ private:
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording;
     int fCurrentDeserialPicture;
+    int fCurrentMappedPicture;
     int fCurrentScale;
     int fCurrentSKP;
     int fCurrentSVG;
     int fCurrentUseMPD;
+    bool fOptimizedSKP;
     int fCurrentCodec;
     int fCurrentAndroidCodec;
     int fCurrentBRDImage;
@@ -1187,10 +1240,16 @@ int main(int argc, char** argv) {
 
     gSkUseAnalyticAA = FLAGS_analyticAA;
     gSkUseDeltaAA = FLAGS_deltaAA;
+    gSkUseThreadedDAA = FLAGS_threadedDAA;
+    gSkUseSparseAA = FLAGS_sparseAA;
+    gSkUseRasterGlyphAtlas = FLAGS_rasterGlyphAtlas;
 
     if (FLAGS_forceDeltaAA) {
         gSkForceDeltaAA = true;
     }
+    if (FLAGS_forceSparseAA) {
+        gSkForceSparseAA = true;
+    }
     if (FLAGS_forceAnalyticAA) {
         gSkForceAnalyticAA = true;
     }
@@ -1269,6 +1328,14 @@ int main(int argc, char** argv) {
                 }
             }
 
+            SkBlitterCache::Stats blitterStats = {0, 0};
+            if (FLAGS_blitterStats) {
+                // One more frame, just to count its blitters.
+                SkBlitterCache::ResetStats();
+                time(1, bench.get(), target);
+                blitterStats = SkBlitterCache::GetStats();
+            }
+
             SkTArray<SkString> keys;
             SkTArray<double> values;
             bool gpuStatsDump = FLAGS_gpuStatsDump && Benchmark::kGPU_Backend == configs[i].backend;
@@ -1308,6 +1375,10 @@ int main(int argc, char** argv) {
             }
             log.endArray(); // samples
             benchStream.fillCurrentMetrics(log);
+            if (FLAGS_blitterStats) {
+                log.appendMetric("blitters_chosen", blitterStats.fChosen);
+                log.appendMetric("blitters_reused", blitterStats.fReused);
+            }
             if (gpuStatsDump) {
                 // dump to json, only SKPBench currently returns valid keys / values
                 SkASSERT(keys.count() == values.count());
@@ -1375,6 +1446,11 @@ int main(int argc, char** argv) {
                 target->dumpStats();
             }
 
+            if (FLAGS_blitterStats) {
+                SkDebugf("Blitters per frame: %d chosen, %d reused\t%s\n",
+                         blitterStats.fChosen, blitterStats.fReused, bench->getUniqueName());
+            }
+
             if (FLAGS_verbose) {
                 SkDebugf("Samples:  ");
                 for (int i = 0; i < samples.count(); i++) {
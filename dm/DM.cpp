@@ -25,6 +25,7 @@
 #include "SkEventTracingPriv.h"
 #include "SkFontMgr.h"
 #include "SkFontMgrPriv.h"
+#include "SkGlyphAtlas.h"
 #include "SkGraphics.h"
 #include "SkHalf.h"
 #include "SkLeanWindows.h"
@@ -900,6 +901,7 @@ static Sink* create_sink(const GrContextOptions& grCtxOptions, const SkCommandLi
         SINK("565",     RasterSink, kRGB_565_SkColorType);
         SINK("4444",    RasterSink, kARGB_4444_SkColorType);
         SINK("8888",    RasterSink, kN32_SkColorType);
+        SINK("t8888",   ThreadedSink, kN32_SkColorType);
         SINK("rgba",    RasterSink, kRGBA_8888_SkColorType);
         SINK("bgra",    RasterSink, kBGRA_8888_SkColorType);
         SINK("rgbx",    RasterSink, kRGB_888x_SkColorType);
@@ -954,6 +956,7 @@ static Sink* create_via(const SkString& tag, Sink* wrapped) {
     VIA("pic",       ViaPicture,           wrapped);
     VIA("tiles",     ViaTiles, 256, 256, nullptr,            wrapped);
     VIA("tiles_rt",  ViaTiles, 256, 256, new SkRTreeFactory, wrapped);
+    VIA("ptiles",    ViaTiledPictureDraw, 256, 256,          wrapped);
 
     VIA("ddl",       ViaDDL, 1, 3,         wrapped);
     VIA("ddl2",      ViaDDL, 2, 3,         wrapped);
@@ -1426,6 +1429,9 @@ int main(int argc, char** argv) {
 
     gSkUseAnalyticAA = FLAGS_analyticAA;
     gSkUseDeltaAA = FLAGS_deltaAA;
+    gSkUseThreadedDAA = FLAGS_threadedDAA;
+    gSkUseSparseAA = FLAGS_sparseAA;
+    gSkUseRasterGlyphAtlas = FLAGS_rasterGlyphAtlas;
 
     if (FLAGS_forceAnalyticAA) {
         gSkForceAnalyticAA = true;
@@ -1433,6 +1439,9 @@ int main(int argc, char** argv) {
     if (FLAGS_forceDeltaAA) {
         gSkForceDeltaAA = true;
     }
+    if (FLAGS_forceSparseAA) {
+        gSkForceSparseAA = true;
+    }
     if (FLAGS_forceRasterPipeline) {
         gSkForceRasterPipelineBlitter = true;
     }
@@ -54,6 +54,8 @@
 #include "SkSwizzler.h"
 #include "SkTLogic.h"
 #include "SkTaskGroup.h"
+#include "SkThreadedBMPDevice.h"
+#include "SkTiledPictureDraw.h"
 #if defined(SK_BUILD_FOR_WIN)
     #include "SkAutoCoInitialize.h"
     #include "SkHRESULT.h"
@@ -1688,6 +1690,30 @@ Error RasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) con
     return src.draw(&canvas);
 }
 
+ThreadedSink::ThreadedSink(SkColorType colorType, sk_sp<SkColorSpace> colorSpace)
+        : RasterSink(colorType, colorSpace) {}
+
+Error ThreadedSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) const {
+    const SkISize size = src.size();
+    SkAlphaType alphaType = kPremul_SkAlphaType;
+    (void)SkColorTypeValidateAlphaType(fColorType, alphaType, &alphaType);
+
+    dst->allocPixelsFlags(SkImageInfo::Make(size.width(), size.height(),
+                                            fColorType, alphaType, fColorSpace),
+                          SkBitmap::kZeroPixels_AllocFlag);
+
+    // Same as RasterSink, but drawn on FLAGS_backendThreads threads, FLAGS_backendTiles tiles.
+    // Every draw shares one pool of those threads.
+    static std::unique_ptr<SkExecutor> executor =
+            SkExecutor::MakeFIFOThreadPool(FLAGS_backendThreads);
+    SkCanvas canvas(sk_make_sp<SkThreadedBMPDevice>(
+            *dst, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType),
+            FLAGS_backendTiles, executor.get()));
+    Error err = src.draw(&canvas);
+    canvas.flush();
+    return err;
+}
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
 // Handy for front-patching a Src.  Do whatever up-front work you need, then call draw_to_canvas(),
@@ -1870,6 +1896,51 @@ Error ViaTiles::draw(const Src& src, SkBitmap* bitmap, SkWStream* stream, SkStri
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+ViaTiledPictureDraw::ViaTiledPictureDraw(int w, int h, Sink* sink) : Via(sink), fW(w), fH(h) {}
+
+Error ViaTiledPictureDraw::draw(const Src& src, SkBitmap* bitmap, SkWStream* stream,
+                                SkString* log) const {
+    auto size = src.size();
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    Error err = src.draw(recorder.beginRecording(SkIntToScalar(size.width()),
+                                                 SkIntToScalar(size.height()),
+                                                 &factory));
+    if (!err.isEmpty()) {
+        return err;
+    }
+    sk_sp<SkPicture> pic(recorder.finishRecordingAsPicture());
+
+    return draw_to_canvas(fSink.get(), bitmap, stream, log, src.size(), [&](SkCanvas* canvas) {
+        // The tiles are drawn on other threads, so they're always raster, straight into one bitmap.
+        SkImageInfo info = canvas->imageInfo().makeWH(size.width(), size.height());
+        if (kUnknown_SkColorType == info.colorType()) {
+            info = SkImageInfo::MakeN32Premul(size.width(), size.height());
+        }
+        SkBitmap tiles;
+        tiles.allocPixels(info);
+        tiles.eraseColor(SK_ColorTRANSPARENT);
+
+        SkTiledPictureDraw tpd(pic);
+        SkTArray<std::unique_ptr<SkCanvas>> canvases;
+        for (int y = 0; y < size.height(); y += fH) {
+            for (int x = 0; x < size.width(); x += fW) {
+                SkIRect bounds = SkIRect::MakeXYWH(x, y, fW, fH);
+                bounds.intersect(tiles.bounds());
+                SkBitmap tile;
+                tiles.extractSubset(&tile, bounds);
+                canvases.push_back(skstd::make_unique<SkCanvas>(tile));
+                tpd.add(canvases.back().get(), bounds);
+            }
+        }
+        tpd.draw();
+        canvas->drawBitmap(tiles, 0, 0);
+        return "";
+    });
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
 ViaDDL::ViaDDL(int numReplays, int numDivisions, Sink* sink)
         : Via(sink), fNumReplays(numReplays), fNumDivisions(numDivisions) {}
 
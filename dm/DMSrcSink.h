@@ -434,7 +434,7 @@ public:
     const char* fileExtension() const override { return "png"; }
     SinkFlags flags() const override { return SinkFlags{ SinkFlags::kRaster, SinkFlags::kDirect }; }
 
-private:
+protected:
     SkColorType         fColorType;
     sk_sp<SkColorSpace> fColorSpace;
 };
@@ -527,6 +527,14 @@ private:
     std::unique_ptr<SkBBHFactory> fFactory;
 };
 
+class ViaTiledPictureDraw : public Via {
+public:
+    ViaTiledPictureDraw(int w, int h, Sink*);
+    Error draw(const Src&, SkBitmap*, SkWStream*, SkString*) const override;
+private:
+    const int fW, fH;
+};
+
 class ViaDDL : public Via {
 public:
     ViaDDL(int numReplays, int numDivisions, Sink* sink);
@@ -28,4 +28,16 @@ private:
     typedef SkBBHFactory INHERITED;
 };
 
+/**
+ *  Makes a packed R-Tree, which sorts the draws of a picture along a Hilbert curve and tests
+ *  each node's children at once with SIMD. It takes longer to build than SkRTree and less memory,
+ *  and its searches are usually faster, most of all when draws weren't recorded in order.
+ */
+class SK_API SkPackedRTreeFactory : public SkBBHFactory {
+public:
+    SkBBoxHierarchy* operator()(const SkRect& bounds) const override;
+private:
+    typedef SkBBHFactory INHERITED;
+};
+
 #endif
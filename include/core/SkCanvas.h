@@ -1847,6 +1847,15 @@ public:
     void experimental_DrawEdgeAARectV1(const SkRect& r, QuadAAFlags edgeAA, SkColor color,
                                        SkBlendMode mode);
 
+    /**
+     * This is an experimental API for drawing many rects that differ only by their color, such as
+     * charts and dashboards. It draws as if drawRect() was called for each rect, with paint's color
+     * replaced by colors[i] (or left alone if colors is nullptr). Raster devices reuse one clip
+     * and blit setup across the whole batch, filling solid spans directly when they can.
+     */
+    void experimental_DrawRectsV1(const SkRect rects[], const SkColor colors[], int count,
+                                  const SkPaint& paint);
+
     /** Draws text, with origin at (x, y), using clip, SkMatrix, SkFont font,
         and SkPaint paint.
 
@@ -2383,6 +2392,8 @@ protected:
     virtual void onDrawRect(const SkRect& rect, const SkPaint& paint);
     virtual void onDrawEdgeAARect(const SkRect& rect, QuadAAFlags edgeAA, SkColor color,
                                   SkBlendMode mode);
+    virtual void onDrawRects(const SkRect rects[], const SkColor colors[], int count,
+                             const SkPaint& paint);
     virtual void onDrawRRect(const SkRRect& rrect, const SkPaint& paint);
     virtual void onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint);
     virtual void onDrawOval(const SkRect& rect, const SkPaint& paint);
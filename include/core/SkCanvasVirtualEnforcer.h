@@ -22,6 +22,17 @@ protected:
     void onDrawPaint(const SkPaint& paint) override = 0;
     void onDrawBehind(const SkPaint&) override {} // make zero after android updates
     void onDrawRect(const SkRect& rect, const SkPaint& paint) override = 0;
+    // Recording and forwarding canvases see a batch of rects as individual drawRect() calls.
+    void onDrawRects(const SkRect rects[], const SkColor colors[], int count,
+                     const SkPaint& paint) override {
+        SkPaint rectPaint(paint);
+        for (int i = 0; i < count; ++i) {
+            if (colors) {
+                rectPaint.setColor(colors[i]);
+            }
+            this->drawRect(rects[i], rectPaint);
+        }
+    }
     void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override = 0;
     void onDrawDRRect(const SkRRect& outer, const SkRRect& inner,
                       const SkPaint& paint) override = 0;
@@ -61,6 +61,21 @@ public:
     static sk_sp<SkPicture> MakeFromStream(SkStream* stream,
                                            const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates the part of SkPicture serialized into stream that draws inside cullRect, as
+        when drawing a viewport of a large SkPicture. If SkPicture was recorded with an
+        SkBBHFactory, only its drawing commands whose bounds intersect cullRect are read;
+        otherwise, all of them are. The cull SkRect of the returned SkPicture is cullRect
+        intersected with the cull SkRect of SkPicture. Returns nullptr if stream does not
+        permit constructing valid SkPicture.
+
+        @param stream    container for serial data
+        @param cullRect  bounds of the part of SkPicture to read
+        @param procs     custom serial data decoders; may be nullptr
+        @return          SkPicture constructed from stream data
+    */
+    static sk_sp<SkPicture> MakeFromStream(SkStream* stream, const SkRect& cullRect,
+                                           const SkDeserialProcs* procs = nullptr);
+
     /** Recreates SkPicture that was serialized into data. Returns constructed SkPicture
         if successful; otherwise, returns nullptr. Fails if data does not permit
         constructing valid SkPicture.
@@ -87,6 +102,19 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized into data, which is typically a mapped file.
+        Unlike MakeFromData(), the returned SkPicture keeps a reference to data and plays back
+        its drawing commands from it in place, and its images are decoded from data when first
+        drawn. Data serialized by an older version of Skia is copied as MakeFromData() would.
+        Returns nullptr if data does not permit constructing valid SkPicture.
+
+        @param data   container for serial data
+        @param procs  custom serial data decoders; may be nullptr
+        @return       SkPicture constructed from data
+    */
+    static sk_sp<SkPicture> MakeFromMappedData(sk_sp<SkData> data,
+                                               const SkDeserialProcs* procs = nullptr);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -208,12 +236,14 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkMappedPicture;
     friend class SkPicturePriv;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces) const;
     static sk_sp<SkPicture> MakeFromStream(SkStream*, const SkDeserialProcs*,
-                                           class SkTypefacePlayback*);
+                                           class SkTypefacePlayback*,
+                                           const SkRect* cullRect = nullptr);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
@@ -267,17 +297,20 @@ private:
     // V66: Add saveBehind
     // V67: Blobs serialize fonts instead of paints
     // V68: Paint doesn't serialize font-related stuff
+    // V69: Pad streamed picture data so it can be read in place
+    // V70: Stream the bounds of the ops of pictures with a BBH
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t     MIN_PICTURE_VERSION = 56;     // august 2017
-    static const uint32_t CURRENT_PICTURE_VERSION = 68;
+    static const uint32_t CURRENT_PICTURE_VERSION = 70;
 
     static_assert(MIN_PICTURE_VERSION <= 62, "Remove kFontAxes_bad from SkFontDescriptor.cpp");
 
     static bool IsValidPictInfo(const struct SkPictInfo& info);
     static sk_sp<SkPicture> Forwardport(const struct SkPictInfo&,
                                         const class SkPictureData*,
-                                        class SkReadBuffer* buffer);
+                                        class SkReadBuffer* buffer,
+                                        const SkRect* cullRect = nullptr);
 
     struct SkPictInfo createHeader() const;
     class SkPictureData* backport() const;
@@ -30,6 +30,7 @@
 
 class SkCanvas;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPaint;
 class SkSurfaceCharacterization;
 class GrBackendRenderTarget;
@@ -170,6 +171,27 @@ public:
     static sk_sp<SkSurface> MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps = nullptr);
 
+    /** Allocates raster SkSurface whose SkCanvas defers drawing and rasterizes it on an
+        SkExecutor. Draws are recorded, and on SkCanvas::flush() (or any access to the pixels) the
+        surface is split into tiles which are drawn concurrently. Pixels match those of a
+        surface returned by MakeRaster() with the same parameters, give or take rounding of
+        antialiased edges that cross between tiles.
+
+        Text is drawn immediately, flushing any recorded draws first.
+
+        @param imageInfo     width, height, SkColorType, SkAlphaType, SkColorSpace,
+                             of raster surface; width and height must be greater than zero
+        @param tiles         number of horizontal bands the surface is split into
+        @param executor      runs the tiles; nullptr uses SkExecutor::GetDefault(). Share one
+                             executor between surfaces rather than making one for each
+        @param surfaceProps  LCD striping orientation and setting for device independent fonts;
+                             may be nullptr
+        @return              SkSurface if all parameters are valid; otherwise, nullptr
+    */
+    static sk_sp<SkSurface> MakeRasterThreaded(const SkImageInfo& imageInfo, int tiles,
+                                               SkExecutor* executor = nullptr,
+                                               const SkSurfaceProps* surfaceProps = nullptr);
+
     /** Caller data passed to RenderTarget/TextureReleaseProc; may be nullptr. */
     typedef void* ReleaseContext;
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTiledPictureDraw_DEFINED
+#define SkTiledPictureDraw_DEFINED
+
+#include "../private/SkTArray.h"
+#include "../private/SkTDArray.h"
+#include "../private/SkTHash.h"
+#include "SkRect.h"
+#include "SkRefCnt.h"
+
+class SkBBoxHierarchy;
+class SkCanvas;
+class SkExecutor;
+class SkImage;
+class SkPicture;
+
+/** \class SkTiledPictureDraw
+
+    The TiledPictureDraw object plays one picture back into several tiles at once.
+
+    Each tile pairs a canvas with the part of the picture it shows. The ops that draw into each
+    tile are found once, with the picture's bounding box hierarchy, when the tile is added. draw()
+    then plays every tile back concurrently, and can be called again to redraw them all.
+*/
+class SK_API SkTiledPictureDraw {
+public:
+    /**
+     *  Create an object to draw picture into tiles. If the picture was recorded without a
+     *  bounding box hierarchy, one is made for it here.
+     */
+    explicit SkTiledPictureDraw(sk_sp<SkPicture> picture);
+    ~SkTiledPictureDraw();
+
+    /**
+     *  Add a tile.
+     *  @param canvas   the canvas to draw the tile into. It must not be drawn to by anything else
+     *                  during draw(), and must be safe to draw to from another thread. Its
+     *                  matrix must not change after the tile is added.
+     *  @param bounds   the part of the picture to draw, in the picture's coordinates. It is
+     *                  translated so its top left corner lands on the origin of canvas.
+     */
+    void add(SkCanvas* canvas, const SkIRect& bounds);
+
+    /**
+     *  Draw all the tiles on executor, or on SkExecutor::GetDefault() if it's null, and wait for
+     *  them to finish. Lazy images drawn into more than one tile are decoded once, first, and
+     *  shared by all the tiles that draw them.
+     */
+    void draw(SkExecutor* executor = nullptr);
+
+    int count() const { return fTiles.count(); }
+
+private:
+    struct Tile {
+        SkCanvas*      fCanvas;
+        SkIRect        fBounds;
+        SkTDArray<int> fOps;
+    };
+
+    struct ImageTiles {
+        int fLastTile;
+        int fTileCount;
+    };
+
+    void drawTile(const Tile&) const;
+
+    sk_sp<SkPicture>                 fPicture;
+    std::unique_ptr<SkBBoxHierarchy> fBBH;     // only if the picture has none of its own
+    SkTArray<Tile>                   fTiles;
+    // The images drawn by the tiles' ops; the picture owns them.
+    SkTHashMap<const SkImage*, ImageTiles> fImages;
+};
+
+#endif
@@ -10,12 +10,13 @@
 
 #include <memory>
 
+#include "SkFont.h"
 #include "SkPoint.h"
 #include "SkSpan.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
 
-class SkFont;
+class SkExecutor;
 
 /**
    Shapes text using HarfBuzz and places the shaped text into a
@@ -70,6 +71,30 @@ public:
                           SkPoint point,
                           SkScalar width) const = 0;
 
+    // The arguments of one shape() call. ShapeParagraphs() sets fEnd to what it returns.
+    struct Paragraph {
+        RunHandler* fHandler;
+        SkFont      fFont;
+        const char* fUtf8Text;
+        size_t      fTextBytes;
+        bool        fLeftToRight;
+        SkPoint     fPoint;
+        SkScalar    fWidth;
+        SkPoint     fEnd;
+    };
+
+    /**
+       Shapes independent paragraphs on up to maxTasks tasks on the executor, and returns when
+       they are all shaped. A shaper isn't safe to use from more than one thread, so each task
+       shapes with its own shaper from makeShaper. Each paragraph's handler is only called from
+       the task shaping it, so paragraphs must not share handlers. With no executor, the
+       paragraphs are shaped in order on this thread.
+     */
+    static void ShapeParagraphs(SkSpan<Paragraph> paragraphs,
+                                SkExecutor* executor,
+                                int maxTasks,
+                                std::unique_ptr<SkShaper> (*makeShaper)() = &SkShaper::Make);
+
 private:
     SkShaper(const SkShaper&) = delete;
     SkShaper& operator=(const SkShaper&) = delete;
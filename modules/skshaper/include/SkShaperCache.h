@@ -0,0 +1,58 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkShaperCache_DEFINED
+#define SkShaperCache_DEFINED
+
+#include "SkShaper.h"
+
+/**
+   An SkShaper that keeps the runs another shaper makes for some text, and
+   hands them to the RunHandler again, without shaping, when it is asked to
+   shape the same text with the same font, direction and width.
+
+   Entries are kept until they take more than a budget of bytes, when the least
+   recently used are dropped. The cache may be used from several threads if the
+   shaper it wraps may be.
+ */
+class SkShaperCache final : public SkShaper {
+public:
+    static constexpr size_t kDefaultBudget = 2 * 1024 * 1024;
+
+    static std::unique_ptr<SkShaperCache> Make(std::unique_ptr<SkShaper> shaper,
+                                               size_t budget = kDefaultBudget);
+
+    ~SkShaperCache() override;
+
+    SkPoint shape(RunHandler* handler,
+                  const SkFont& srcFont,
+                  const char* utf8text,
+                  size_t textBytes,
+                  bool leftToRight,
+                  SkPoint point,
+                  SkScalar width) const override;
+
+    struct Stats {
+        int    fHits;
+        int    fMisses;
+        int    fEntries;
+        size_t fBytesUsed;
+    };
+    Stats stats() const;
+
+    void purgeAll();
+
+private:
+    class Cache;
+
+    SkShaperCache(std::unique_ptr<SkShaper> shaper, size_t budget);
+
+    std::unique_ptr<SkShaper> fShaper;
+    std::unique_ptr<Cache> fCache;
+};
+
+#endif  // SkShaperCache_DEFINED
@@ -7,8 +7,11 @@
 
 #include "SkShaper.h"
 #include "SkSpan.h"
+#include "SkTaskGroup.h"
 #include "SkTextBlobPriv.h"
 
+#include <atomic>
+
 std::unique_ptr<SkShaper> SkShaper::Make() {
 #ifdef SK_SHAPER_HARFBUZZ_AVAILABLE
     std::unique_ptr<SkShaper> shaper = SkShaper::MakeHarfBuzz();
@@ -22,6 +25,35 @@ std::unique_ptr<SkShaper> SkShaper::Make() {
 SkShaper::SkShaper() {}
 SkShaper::~SkShaper() {}
 
+void SkShaper::ShapeParagraphs(SkSpan<Paragraph> paragraphs,
+                               SkExecutor* executor,
+                               int maxTasks,
+                               std::unique_ptr<SkShaper> (*makeShaper)()) {
+    // Each task takes the next paragraph until there are none left, so long paragraphs don't
+    // leave the other tasks waiting.
+    std::atomic<size_t> next{0};
+    auto shapeParagraphs = [&] {
+        std::unique_ptr<SkShaper> shaper = makeShaper();
+        for (size_t i = next++; i < paragraphs.size(); i = next++) {
+            Paragraph& p = paragraphs[i];
+            p.fEnd = shaper ? shaper->shape(p.fHandler, p.fFont, p.fUtf8Text, p.fTextBytes,
+                                            p.fLeftToRight, p.fPoint, p.fWidth)
+                            : p.fPoint;
+        }
+    };
+
+    int tasks = SkTMin(maxTasks, SkToInt(paragraphs.size()));
+    if (!executor || tasks <= 1) {
+        shapeParagraphs();
+        return;
+    }
+    SkTaskGroup group(*executor);
+    for (int i = 0; i < tasks; i++) {
+        group.add(shapeParagraphs);
+    }
+    group.wait();
+}
+
 SkShaper::RunHandler::Buffer SkTextBlobBuilderRunHandler::newRunBuffer(const RunInfo&,
                                                                        const SkFont& font,
                                                                        int glyphCount,
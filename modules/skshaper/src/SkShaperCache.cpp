@@ -0,0 +1,272 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkShaperCache.h"
+
+#include "SkFont.h"
+#include "SkMutex.h"
+#include "SkOpts.h"
+#include "SkRefCnt.h"
+#include "SkTHash.h"
+#include "SkTInternalLList.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Key {
+    Key(const SkFont& font, const char* utf8text, size_t textBytes, bool leftToRight,
+        SkScalar width)
+        : fText(utf8text, textBytes), fFont(font), fWidth(width), fLeftToRight(leftToRight) {
+        const int32_t fields[] = {
+            (int32_t)SkTypeface::UniqueID(font.getTypeface()),
+            SkFloat2Bits(font.getSize()),
+            SkFloat2Bits(font.getScaleX()),
+            SkFloat2Bits(font.getSkewX()),
+            SkFloat2Bits(width),
+            (int32_t)font.getEdging() | (int32_t)font.getHinting() << 8 | leftToRight << 16,
+        };
+        fHash = SkOpts::hash(fields, sizeof(fields), SkOpts::hash(utf8text, textBytes));
+    }
+
+    bool operator==(const Key& that) const {
+        return fHash == that.fHash && fLeftToRight == that.fLeftToRight &&
+               fWidth == that.fWidth && fFont == that.fFont && fText == that.fText;
+    }
+
+    std::string fText;
+    SkFont      fFont;
+    SkScalar    fWidth;
+    bool        fLeftToRight;
+    uint32_t    fHash;
+};
+
+// The calls a shaper made to a RunHandler for some text. Positions are as they were shaped at
+// fOrigin, and are moved to where the text is shaped when they are handed out again.
+class ShapedText : public SkNVRefCnt<ShapedText> {
+public:
+    struct Run {
+        SkShaper::RunHandler::RunInfo fInfo;
+        SkFont fFont;
+        size_t fUtf8Offset;
+        size_t fUtf8Size;
+        size_t fGlyphStart;
+        int    fGlyphCount;
+        int    fLinesAfter;  // The number of commitLine() calls after this run.
+    };
+
+    SkPoint replay(SkShaper::RunHandler* handler, const char* utf8text, SkPoint point) const {
+        SkVector offset = point - fOrigin;
+        for (int i = 0; i < fLinesBefore; i++) {
+            handler->commitLine();
+        }
+        for (const Run& run : fRuns) {
+            const auto buffer = handler->newRunBuffer(
+                    run.fInfo, run.fFont, run.fGlyphCount,
+                    SkSpan<const char>(utf8text + run.fUtf8Offset, run.fUtf8Size));
+            memcpy(buffer.glyphs, &fGlyphs[run.fGlyphStart], run.fGlyphCount * sizeof(SkGlyphID));
+            for (int i = 0; i < run.fGlyphCount; i++) {
+                buffer.positions[i] = fPositions[run.fGlyphStart + i] + offset;
+            }
+            if (buffer.clusters) {
+                memcpy(buffer.clusters, &fClusters[run.fGlyphStart],
+                       run.fGlyphCount * sizeof(uint32_t));
+            }
+            handler->commitRun();
+            for (int i = 0; i < run.fLinesAfter; i++) {
+                handler->commitLine();
+            }
+        }
+        return fEnd + offset;
+    }
+
+    size_t bytesUsed() const {
+        return sizeof(*this) + fRuns.capacity() * sizeof(Run) +
+               fGlyphs.capacity() * (sizeof(SkGlyphID) + sizeof(SkPoint) + sizeof(uint32_t));
+    }
+
+    std::vector<Run>       fRuns;
+    std::vector<SkGlyphID> fGlyphs;
+    std::vector<SkPoint>   fPositions;
+    std::vector<uint32_t>  fClusters;
+    int                    fLinesBefore = 0;
+    SkPoint                fOrigin;
+    SkPoint                fEnd;
+};
+
+// Records what a shaper hands a RunHandler into a ShapedText.
+class Recorder final : public SkShaper::RunHandler {
+public:
+    Recorder(const char* utf8text, size_t textBytes, ShapedText* shaped)
+        : fText(utf8text), fTextBytes(textBytes), fShaped(shaped) {}
+
+    // Runs are replayed with spans into the text they are replayed for, so the spans must be in
+    // the text.
+    bool canReplay() const { return fCanReplay; }
+
+    Buffer newRunBuffer(const RunInfo& info, const SkFont& font, int glyphCount,
+                        SkSpan<const char> utf8) override {
+        size_t offset = utf8.data() - fText;
+        if (utf8.data() < fText || offset + utf8.size() > fTextBytes) {
+            fCanReplay = false;
+            offset = 0;
+        }
+        size_t start = fShaped->fGlyphs.size();
+        fShaped->fRuns.push_back({info, font, offset, utf8.size(), start, glyphCount, 0});
+        fShaped->fGlyphs.resize(start + glyphCount);
+        fShaped->fPositions.resize(start + glyphCount);
+        fShaped->fClusters.resize(start + glyphCount);
+        return { fShaped->fGlyphs.data() + start,
+                 fShaped->fPositions.data() + start,
+                 fShaped->fClusters.data() + start };
+    }
+
+    void commitRun() override {}
+
+    void commitLine() override {
+        if (fShaped->fRuns.empty()) {
+            fShaped->fLinesBefore++;
+        } else {
+            fShaped->fRuns.back().fLinesAfter++;
+        }
+    }
+
+private:
+    const char* const fText;
+    const size_t fTextBytes;
+    ShapedText* const fShaped;
+    bool fCanReplay = true;
+};
+
+}  // namespace
+
+class SkShaperCache::Cache {
+public:
+    explicit Cache(size_t budget) : fBudget(budget) {}
+
+    ~Cache() { this->purgeAll(); }
+
+    sk_sp<ShapedText> find(const Key& key) {
+        SkAutoMutexAcquire lock(fMutex);
+        Entry** entry = fTable.find(key);
+        if (!entry) {
+            fMisses++;
+            return nullptr;
+        }
+        fHits++;
+        if (*entry != fLRU.head()) {
+            fLRU.remove(*entry);
+            fLRU.addToHead(*entry);
+        }
+        return (*entry)->fShaped;
+    }
+
+    void add(Key key, sk_sp<ShapedText> shaped) {
+        SkAutoMutexAcquire lock(fMutex);
+        if (fTable.find(key)) {
+            return;  // Another thread shaped the same text.
+        }
+        size_t bytes = sizeof(Entry) + key.fText.size() + shaped->bytesUsed();
+        Entry* entry = new Entry{std::move(key), std::move(shaped), bytes};
+        fTable.set(entry);
+        fLRU.addToHead(entry);
+        fBytesUsed += bytes;
+        while (fBytesUsed > fBudget) {
+            this->remove(fLRU.tail());
+        }
+    }
+
+    Stats stats() const {
+        SkAutoMutexAcquire lock(fMutex);
+        return { fHits, fMisses, fTable.count(), fBytesUsed };
+    }
+
+    void purgeAll() {
+        SkAutoMutexAcquire lock(fMutex);
+        while (fLRU.tail()) {
+            this->remove(fLRU.tail());
+        }
+    }
+
+private:
+    struct Entry {
+        Key               fKey;
+        sk_sp<ShapedText> fShaped;
+        size_t            fBytes;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+
+    struct Traits {
+        static const Key& GetKey(const Entry* entry) { return entry->fKey; }
+        static uint32_t Hash(const Key& key) { return key.fHash; }
+    };
+
+    void remove(Entry* entry) {
+        fTable.remove(entry->fKey);
+        fLRU.remove(entry);
+        fBytesUsed -= entry->fBytes;
+        delete entry;
+    }
+
+    mutable SkMutex                 fMutex;
+    const size_t                    fBudget;
+    SkTHashTable<Entry*, Key, Traits> fTable;
+    SkTInternalLList<Entry>         fLRU;
+    size_t                          fBytesUsed = 0;
+    int                             fHits = 0;
+    int                             fMisses = 0;
+};
+
+std::unique_ptr<SkShaperCache> SkShaperCache::Make(std::unique_ptr<SkShaper> shaper,
+                                                   size_t budget) {
+    if (!shaper) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkShaperCache>(new SkShaperCache(std::move(shaper), budget));
+}
+
+SkShaperCache::SkShaperCache(std::unique_ptr<SkShaper> shaper, size_t budget)
+    : fShaper(std::move(shaper))
+    , fCache(new Cache(budget)) {}
+
+SkShaperCache::~SkShaperCache() {}
+
+SkPoint SkShaperCache::shape(RunHandler* handler,
+                             const SkFont& srcFont,
+                             const char* utf8text,
+                             size_t textBytes,
+                             bool leftToRight,
+                             SkPoint point,
+                             SkScalar width) const {
+    Key key(srcFont, utf8text, textBytes, leftToRight, width);
+    if (sk_sp<ShapedText> shaped = fCache->find(key)) {
+        return shaped->replay(handler, utf8text, point);
+    }
+
+    sk_sp<ShapedText> shaped = sk_make_sp<ShapedText>();
+    Recorder recorder(utf8text, textBytes, shaped.get());
+    shaped->fOrigin = point;
+    shaped->fEnd = fShaper->shape(&recorder, srcFont, utf8text, textBytes, leftToRight, point,
+                                  width);
+    if (!recorder.canReplay()) {
+        return fShaper->shape(handler, srcFont, utf8text, textBytes, leftToRight, point, width);
+    }
+
+    SkPoint end = shaped->replay(handler, utf8text, point);
+    fCache->add(std::move(key), std::move(shaped));
+    return end;
+}
+
+SkShaperCache::Stats SkShaperCache::stats() const {
+    return fCache->stats();
+}
+
+void SkShaperCache::purgeAll() {
+    fCache->purgeAll();
+}
@@ -9,7 +9,9 @@
 #define SkAutoBlitterChoose_DEFINED
 
 #include "SkArenaAlloc.h"
+#include "SkBlitRecorder.h"
 #include "SkBlitter.h"
+#include "SkBlitterCache.h"
 #include "SkDraw.h"
 #include "SkMacros.h"
 
@@ -24,6 +26,11 @@ public:
                         bool drawCoverage = false) {
         this->choose(draw, matrix, paint, drawCoverage);
     }
+    ~SkAutoBlitterChoose() {
+        if (fCache) {
+            fCache->release();
+        }
+    }
 
     SkBlitter*  operator->() { return fBlitter; }
     SkBlitter*  get() const { return fBlitter; }
@@ -34,7 +41,17 @@ public:
         if (!matrix) {
             matrix = draw.fMatrix;
         }
-        fBlitter = SkBlitter::Choose(draw.fDst, *matrix, paint, &fAlloc, drawCoverage);
+        if (draw.fBlitRecorder) {
+            fBlitter = draw.fBlitRecorder->record(*matrix, paint, drawCoverage, &fAlloc);
+            return fBlitter;
+        }
+        if (draw.fBlitterCache &&
+            (fBlitter = draw.fBlitterCache->acquire(draw.fDst, *matrix, paint, drawCoverage))) {
+            fCache = draw.fBlitterCache;
+        } else {
+            fBlitter = SkBlitter::Choose(draw.fDst, *matrix, paint, &fAlloc, drawCoverage);
+            SkBlitterCache::CountChosen();
+        }
 
         if (draw.fCoverage) {
             // hmm, why can't choose ignore the paint if drawCoverage is true?
@@ -42,12 +59,15 @@ public:
                                                            &fAlloc, true);
             fBlitter = fAlloc.make<SkPairBlitter>(fBlitter, coverageBlitter);
         }
+        fBlitter = draw.clipBlitter(fBlitter, &fAlloc);
         return fBlitter;
     }
 
 private:
     // Owned by fAlloc, which will handle the delete.
     SkBlitter* fBlitter = nullptr;
+    // If set, fBlitter came from (and must be released back to) this cache.
+    SkBlitterCache* fCache = nullptr;
 
     SkSTArenaAlloc<kSkBlitterContextSize> fAlloc;
 };
@@ -39,6 +39,28 @@ void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
                  callback);
 }
 
+void SkBigPicture::playbackAllOps(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+    SkRecordDraw(*fRecord,
+                 canvas,
+                 this->drawablePicts(),
+                 nullptr,
+                 this->drawableCount(),
+                 nullptr/*bbh*/,
+                 callback);
+}
+
+void SkBigPicture::playbackOps(SkCanvas* canvas, const int ops[], int count) const {
+    SkASSERT(canvas);
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+
+    SkRecords::Draw draw(canvas, this->drawablePicts(), nullptr, this->drawableCount());
+    for (int i = 0; i < count; i++) {
+        SkASSERT(i == 0 || ops[i - 1] < ops[i]);
+        fRecord->visit(ops[i], draw);
+    }
+}
+
 void SkBigPicture::partialPlayback(SkCanvas* canvas,
                                    int start,
                                    int stop,
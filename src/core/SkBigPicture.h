@@ -53,6 +53,12 @@ public:
                          int start,
                          int stop,
                          const SkMatrix& initialCTM) const;
+// Used by SkPicture::backport()
+    // Plays back every op, ignoring the BBH, and calls callback->abort() before each of them.
+    void playbackAllOps(SkCanvas*, AbortCallback*) const;
+// Used by SkTiledPictureDraw
+    // Plays back just ops[0..count), which must be in increasing order, e.g. from a BBH search.
+    void playbackOps(SkCanvas*, const int ops[], int count) const;
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
@@ -66,6 +66,7 @@ public:
 
     SkDrawTiler(SkBitmapDevice* dev, const SkRect* bounds) : fDevice(dev) {
         fDone = false;
+        fDraw.fBlitterCache = &dev->fBlitterCache;
 
         // we need fDst to be set, and if we're actually drawing, to dirty the genID
         if (!dev->accessPixels(&fRootPixmap)) {
@@ -194,6 +195,7 @@ public:
         fMatrix = &dev->ctm();
         fRC = &dev->fRCStack.rc();
         fCoverage = dev->accessCoverage();
+        fBlitterCache = &dev->fBlitterCache;
     }
 };
 
@@ -297,6 +299,7 @@ void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
     SkASSERT(bm.width() == fBitmap.width());
     SkASSERT(bm.height() == fBitmap.height());
     fBitmap = bm;   // intent is to use bm's pixelRef (and rowbytes/config)
+    fBlitterCache.reset();
     this->privateResize(fBitmap.info().width(), fBitmap.info().height());
 }
 
@@ -355,6 +358,16 @@ void SkBitmapDevice::drawRect(const SkRect& r, const SkPaint& paint) {
     LOOP_TILER( drawRect(r, paint), Bounder(r, paint))
 }
 
+void SkBitmapDevice::drawRects(const SkRect rects[], const SkColor colors[], int count,
+                               const SkPaint& paint) {
+    SkRect bounds;
+    if (!bounds.setBoundsCheck(reinterpret_cast<const SkPoint*>(rects), 2 * count)) {
+        LOOP_TILER( drawRects(rects, colors, count, paint), nullptr)
+        return;
+    }
+    LOOP_TILER( drawRects(rects, colors, count, paint), Bounder(bounds, paint))
+}
+
 void SkBitmapDevice::drawOval(const SkRect& oval, const SkPaint& paint) {
     SkPath path;
     path.addOval(oval);
@@ -9,6 +9,7 @@
 #define SkBitmapDevice_DEFINED
 
 #include "SkBitmap.h"
+#include "SkBlitterCache.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
 #include "SkDevice.h"
@@ -79,6 +80,8 @@ protected:
     void drawPoints(SkCanvas::PointMode mode, size_t count,
                             const SkPoint[], const SkPaint& paint) override;
     void drawRect(const SkRect& r, const SkPaint& paint) override;
+    void drawRects(const SkRect rects[], const SkColor colors[], int count,
+                   const SkPaint& paint) override;
     void drawOval(const SkRect& oval, const SkPaint& paint) override;
     void drawRRect(const SkRRect& rr, const SkPaint& paint) override;
 
@@ -143,6 +146,7 @@ private:
     friend class SkDrawIter;
     friend class SkDrawTiler;
     friend class SkSurface_Raster;
+    friend class SkThreadedBMPDevice;
 
     class BDDraw;
 
@@ -162,6 +166,7 @@ private:
     SkRasterClipStack  fRCStack;
     std::unique_ptr<SkBitmap> fCoverage;    // if non-null, will have the same dimensions as fBitmap
     SkGlyphRunListPainter fGlyphPainter;
+    SkBlitterCache fBlitterCache;
 
 
     typedef SkBaseDevice INHERITED;
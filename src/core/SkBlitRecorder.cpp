@@ -0,0 +1,199 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitRecorder.h"
+
+#include "SkAutoBlitterChoose.h"
+#include "SkBlitter.h"
+#include "SkDraw.h"
+#include "SkMask.h"
+#include "SkTemplates.h"
+
+#include <cstring>
+
+static int compute_anti_width(const int16_t runs[]) {
+    int width = 0;
+    for (int count = runs[0]; count > 0; count = runs[width]) {
+        width += count;
+    }
+    return width;
+}
+
+// The bytes a row of the mask covers. Its fRowBytes may be larger (when it points into a bigger
+// mask), or 0 (to repeat one row).
+static size_t mask_row_bytes(const SkMask& mask) {
+    const size_t width = mask.fBounds.width();
+    switch (mask.fFormat) {
+        case SkMask::kBW_Format:     return (width + 7) >> 3;
+        case SkMask::kLCD16_Format:  return width * sizeof(uint16_t);
+        case SkMask::kARGB32_Format: return width * sizeof(uint32_t);
+        default:                     return width;
+    }
+}
+
+class SkBlitRecorder::Blitter final : public SkBlitter {
+public:
+    explicit Blitter(SkBlitRecorder* recorder)
+        : fRecorder(recorder) {
+        SkDEBUGCODE(fPass = recorder->fPasses.size() - 1;)
+    }
+
+    void blitH(int x, int y, int width) override {
+        this->push(Type::kH, x, y, width, 1);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) override {
+        // runs[] and aa[] are indexed by pixel, and runs[] ends with a zero at runs[width].
+        const int width = compute_anti_width(runs);
+        Blit& blit = this->push(Type::kAntiH, x, y, width, 1);
+        blit.fRuns = this->copy(runs, width + 1);
+        blit.fAA   = this->copy(aa, width);
+    }
+
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        this->push(Type::kV, x, y, 1, height).fA0 = alpha;
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        this->push(Type::kRect, x, y, width, height);
+    }
+
+    void blitAntiRect(int x, int y, int width, int height,
+                      SkAlpha leftAlpha, SkAlpha rightAlpha) override {
+        Blit& blit = this->push(Type::kAntiRect, x, y, width, height);
+        blit.fA0 = leftAlpha;
+        blit.fA1 = rightAlpha;
+    }
+
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        SkMask* stored = fRecorder->fAlloc.make<SkMask>(mask);
+        if (mask.fImage && mask.fFormat == SkMask::k3D_Format) {
+            stored->fImage = this->copyBytes(mask.fImage, mask.computeTotalImageSize());
+        } else if (mask.fImage) {
+            const size_t rowBytes = mask_row_bytes(mask);
+            const int    height   = mask.fBounds.height();
+            uint8_t* image = this->copyBytes(nullptr, rowBytes * height);
+            for (int y = 0; y < height; y++) {
+                memcpy(image + y * rowBytes, mask.fImage + y * mask.fRowBytes, rowBytes);
+            }
+            stored->fImage    = image;
+            stored->fRowBytes = SkToU32(rowBytes);
+        }
+        this->push(Type::kMask, clip.fLeft, clip.fTop, clip.width(), clip.height()).fMask = stored;
+    }
+
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        Blit& blit = this->push(Type::kAntiH2, x, y, 2, 1);
+        blit.fA0 = SkToU8(a0);
+        blit.fA1 = SkToU8(a1);
+    }
+
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        Blit& blit = this->push(Type::kAntiV2, x, y, 1, 2);
+        blit.fA0 = SkToU8(a0);
+        blit.fA1 = SkToU8(a1);
+    }
+
+private:
+    Blit& push(Type type, int x, int y, int width, int height) {
+        // Passes don't interleave: each blitter is done before the next one is recorded.
+        SkASSERT(fPass == fRecorder->fPasses.size() - 1);
+        fRecorder->fBlits.push_back({type, 0, 0, x, y, width, height, nullptr, nullptr, nullptr});
+        return fRecorder->fBlits.back();
+    }
+
+    template <typename T>
+    T* copy(const T src[], size_t count) {
+        T* dst = fRecorder->fAlloc.makeArrayDefault<T>(count);
+        memcpy(dst, src, count * sizeof(T));
+        return dst;
+    }
+
+    // Masks are read as 16 or 32-bit pixels too, so keep them 4-byte aligned.
+    uint8_t* copyBytes(const uint8_t src[], size_t size) {
+        uint8_t* dst = reinterpret_cast<uint8_t*>(
+                fRecorder->fAlloc.makeArrayDefault<uint32_t>((size + 3) >> 2));
+        if (src) {
+            memcpy(dst, src, size);
+        }
+        return dst;
+    }
+
+    SkBlitRecorder* fRecorder;
+    SkDEBUGCODE(size_t fPass;)
+};
+
+SkBlitter* SkBlitRecorder::record(const SkMatrix& matrix, const SkPaint& paint, bool drawCoverage,
+                                  SkArenaAlloc* alloc) {
+    fPasses.push_back({matrix, paint, drawCoverage, fBlits.size()});
+    return alloc->make<Blitter>(this);
+}
+
+void SkBlitRecorder::replay(const SkDraw& draw) const {
+    SkASSERT(!draw.fBlitRecorder);
+
+    for (size_t i = 0; i < fPasses.size(); i++) {
+        const Pass& pass = fPasses[i];
+        const size_t end = i + 1 < fPasses.size() ? fPasses[i + 1].fFirstBlit : fBlits.size();
+        if (pass.fFirstBlit == end) {
+            continue;
+        }
+
+        SkAutoBlitterChoose blitter(draw, &pass.fMatrix, pass.fPaint, pass.fDrawCoverage);
+        for (size_t j = pass.fFirstBlit; j < end; j++) {
+            const Blit& blit = fBlits[j];
+            if (draw.fBlitClip && (blit.bottom() <= draw.fBlitClip->fTop ||
+                                   blit.top() >= draw.fBlitClip->fBottom)) {
+                continue;
+            }
+            this->replay(blit, blitter.get());
+        }
+    }
+}
+
+void SkBlitRecorder::replay(const Blit& blit, SkBlitter* blitter) const {
+    switch (blit.fType) {
+        case Type::kH:
+            blitter->blitH(blit.fX, blit.fY, blit.fWidth);
+            break;
+        case Type::kAntiH: {
+            // Clipping blitters split runs in place, and other threads replay the same ones.
+            SkAutoSTMalloc<64, int16_t> runs(blit.fWidth + 1);
+            SkAutoSTMalloc<64, SkAlpha> aa(blit.fWidth);
+            memcpy(runs.get(), blit.fRuns, (blit.fWidth + 1) * sizeof(int16_t));
+            memcpy(aa.get(), blit.fAA, blit.fWidth * sizeof(SkAlpha));
+            blitter->blitAntiH(blit.fX, blit.fY, aa.get(), runs.get());
+            break;
+        }
+        case Type::kV:
+            blitter->blitV(blit.fX, blit.fY, blit.fHeight, blit.fA0);
+            break;
+        case Type::kRect:
+            blitter->blitRect(blit.fX, blit.fY, blit.fWidth, blit.fHeight);
+            break;
+        case Type::kAntiRect:
+            blitter->blitAntiRect(blit.fX, blit.fY, blit.fWidth, blit.fHeight,
+                                  blit.fA0, blit.fA1);
+            break;
+        case Type::kMask:
+            blitter->blitMask(*blit.fMask,
+                              SkIRect::MakeXYWH(blit.fX, blit.fY, blit.fWidth, blit.fHeight));
+            break;
+        case Type::kAntiH2:
+            blitter->blitAntiH2(blit.fX, blit.fY, blit.fA0, blit.fA1);
+            break;
+        case Type::kAntiV2:
+            blitter->blitAntiV2(blit.fX, blit.fY, blit.fA0, blit.fA1);
+            break;
+    }
+}
+
+void SkBlitRecorder::reset() {
+    std::vector<Pass>().swap(fPasses);
+    std::vector<Blit>().swap(fBlits);
+    fAlloc.reset();
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlitRecorder_DEFINED
+#define SkBlitRecorder_DEFINED
+
+#include "SkArenaAlloc.h"
+#include "SkMatrix.h"
+#include "SkNoncopyable.h"
+#include "SkPaint.h"
+#include "SkRect.h"
+
+#include <vector>
+
+class SkBlitter;
+class SkDraw;
+struct SkMask;
+
+/**
+ *  Records the blits a draw makes, so that it can be scan converted once and then blitted into
+ *  several tiles of a device, each through its own blitter.
+ *
+ *  A draw records by setting SkDraw::fBlitRecorder: SkAutoBlitterChoose then hands it a blitter
+ *  from record() instead of choosing a real one. Only draws that get all of their blitters from
+ *  SkAutoBlitterChoose (drawPath() and drawRRect()) can be recorded.
+ *
+ *  replay() may be called from several threads at once.
+ */
+class SkBlitRecorder : SkNoncopyable {
+public:
+    SkBlitRecorder() : fAlloc(4096) {}
+
+    /**
+     *  Returns a blitter (allocated in alloc) that records what's blitted through it, in place of
+     *  the one SkBlitter::Choose() would make for these arguments.
+     */
+    SkBlitter* record(const SkMatrix& matrix, const SkPaint& paint, bool drawCoverage,
+                      SkArenaAlloc* alloc);
+
+    /**
+     *  Blits everything recorded into draw, through the blitters SkAutoBlitterChoose picks for
+     *  it. If draw.fBlitClip is set, blits entirely above or below it are skipped.
+     */
+    void replay(const SkDraw& draw) const;
+
+    /** Drops everything recorded. */
+    void reset();
+
+private:
+    class Blitter;
+
+    enum class Type : uint8_t {
+        kH, kAntiH, kV, kRect, kAntiRect, kMask, kAntiH2, kAntiV2,
+    };
+
+    struct Blit {
+        Type           fType;
+        SkAlpha        fA0, fA1;
+        int            fX, fY, fWidth, fHeight;    // for kMask, the clip
+        const SkAlpha* fAA;
+        const int16_t* fRuns;
+        const SkMask*  fMask;
+
+        int top()    const { return fY; }
+        int bottom() const { return fY + fHeight; }
+    };
+
+    // One for each blitter handed out by record(), which blits fBlits[fFirstBlit, next fFirstBlit).
+    struct Pass {
+        SkMatrix fMatrix;
+        SkPaint  fPaint;
+        bool     fDrawCoverage;
+        size_t   fFirstBlit;
+    };
+
+    void replay(const Blit&, SkBlitter*) const;
+
+    std::vector<Pass> fPasses;
+    std::vector<Blit> fBlits;
+    SkArenaAlloc      fAlloc;   // runs, alphas and masks referenced by fBlits
+};
+
+#endif
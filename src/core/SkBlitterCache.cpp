@@ -0,0 +1,92 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitterCache.h"
+
+#include "SkBlitter.h"
+#include "SkPaint.h"
+
+#include <atomic>
+
+static std::atomic<int> gChosenCount{0};
+static std::atomic<int> gReusedCount{0};
+
+SkBlitterCache::Stats SkBlitterCache::GetStats() {
+    return { gChosenCount.load(std::memory_order_relaxed),
+             gReusedCount.load(std::memory_order_relaxed) };
+}
+
+void SkBlitterCache::ResetStats() {
+    gChosenCount.store(0, std::memory_order_relaxed);
+    gReusedCount.store(0, std::memory_order_relaxed);
+}
+
+void SkBlitterCache::CountChosen() {
+    gChosenCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool SkBlitterCache::matches(const SkPixmap& dst, const SkMatrix& matrix, const SkPaint& paint,
+                             bool drawCoverage) const {
+    // Without a shader, the matrix only matters to SkBlitter::Choose() when it has perspective.
+    const bool matrixMatches = fShader ? fMatrix == matrix
+                                       : fMatrix.hasPerspective() == matrix.hasPerspective();
+    return fBlitter                                      &&
+           fDst.addr()          == dst.addr()            &&
+           fDst.rowBytes()      == dst.rowBytes()        &&
+           fDst.info()          == dst.info()            &&
+           matrixMatches                                 &&
+           fColor               == paint.getColor4f()    &&
+           fShader.get()        == paint.getShader()     &&
+           fColorFilter.get()   == paint.getColorFilter()&&
+           fMaskFilter.get()    == paint.getMaskFilter() &&
+           fBlendMode           == paint.getBlendMode()  &&
+           fFilterQuality       == paint.getFilterQuality() &&
+           fDither              == paint.isDither()      &&
+           fDrawCoverage        == drawCoverage;
+}
+
+SkBlitter* SkBlitterCache::acquire(const SkPixmap& dst, const SkMatrix& matrix,
+                                   const SkPaint& paint, bool drawCoverage) {
+    if (fInUse) {
+        return nullptr;
+    }
+    fInUse = true;
+
+    if (this->matches(dst, matrix, paint, drawCoverage)) {
+        gReusedCount.fetch_add(1, std::memory_order_relaxed);
+        return fBlitter;
+    }
+
+    this->drop();
+    fBlitter       = SkBlitter::Choose(dst, matrix, paint, &fAlloc, drawCoverage);
+    fDst           = dst;
+    fMatrix        = matrix;
+    fColor         = paint.getColor4f();
+    fShader        = paint.refShader();
+    fColorFilter   = paint.refColorFilter();
+    fMaskFilter    = paint.refMaskFilter();
+    fBlendMode     = paint.getBlendMode();
+    fFilterQuality = paint.getFilterQuality();
+    fDither        = paint.isDither();
+    fDrawCoverage  = drawCoverage;
+    CountChosen();
+    return fBlitter;
+}
+
+void SkBlitterCache::reset() {
+    SkASSERT(!fInUse);
+    this->drop();
+}
+
+void SkBlitterCache::drop() {
+    // The blitter lives in fAlloc, and may hold on to the effects, so drop it first.
+    fBlitter = nullptr;
+    fAlloc.reset();
+    fShader      = nullptr;
+    fColorFilter = nullptr;
+    fMaskFilter  = nullptr;
+}
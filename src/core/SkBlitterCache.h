@@ -0,0 +1,87 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlitterCache_DEFINED
+#define SkBlitterCache_DEFINED
+
+#include "SkArenaAlloc.h"
+#include "SkBlendMode.h"
+#include "SkColor.h"
+#include "SkColorFilter.h"
+#include "SkImagePriv.h"
+#include "SkMaskFilter.h"
+#include "SkMatrix.h"
+#include "SkNoncopyable.h"
+#include "SkPixmap.h"
+#include "SkShader.h"
+
+class SkBlitter;
+class SkPaint;
+
+/**
+ *  Remembers the last blitter SkBlitter::Choose() made for a device, so that a run of draws with
+ *  the same paint state (color, shader, color filter, blend mode...) can reuse it instead of
+ *  creating shader contexts and building pipelines again for each draw.
+ *
+ *  A device owns one of these and hands it to its draws through SkDraw::fBlitterCache, where
+ *  SkAutoBlitterChoose uses it. It's not thread safe, and only one draw can use it at a time.
+ */
+class SkBlitterCache : SkNoncopyable {
+public:
+    /**
+     *  Returns the blitter SkBlitter::Choose() would make for these arguments: the cached one if
+     *  they match the last call's, or a new one replacing it. Returns nullptr if the cache is
+     *  already in use (by an enclosing draw); the caller should then choose its own blitter.
+     *  Every non-null result must be released.
+     */
+    SkBlitter* acquire(const SkPixmap& dst, const SkMatrix& matrix, const SkPaint& paint,
+                       bool drawCoverage);
+    void release() {
+        SkASSERT(fInUse);
+        fInUse = false;
+    }
+
+    /** Drops the cached blitter, e.g. when the device's pixels change. */
+    void reset();
+
+    /**
+     *  Counts blitters chosen from scratch and blitters reused from a cache by
+     *  SkAutoBlitterChoose, across all threads, since the last ResetStats().
+     */
+    struct Stats {
+        int fChosen;
+        int fReused;
+    };
+    static Stats GetStats();
+    static void ResetStats();
+    static void CountChosen();
+
+private:
+    bool matches(const SkPixmap& dst, const SkMatrix& matrix, const SkPaint& paint,
+                 bool drawCoverage) const;
+    void drop();
+
+    // What the cached blitter was chosen for. We keep refs on the paint's effects, so that
+    // a new effect can't show up at the same address as the old one.
+    SkPixmap              fDst;
+    SkMatrix              fMatrix;
+    SkColor4f             fColor;
+    sk_sp<SkShader>       fShader;
+    sk_sp<SkColorFilter>  fColorFilter;
+    sk_sp<SkMaskFilter>   fMaskFilter;
+    SkBlendMode           fBlendMode;
+    SkFilterQuality       fFilterQuality;
+    bool                  fDither;
+    bool                  fDrawCoverage;
+
+    SkBlitter*            fBlitter = nullptr;
+    bool                  fInUse   = false;
+
+    SkSTArenaAlloc<kSkBlitterContextSize> fAlloc;
+};
+
+#endif
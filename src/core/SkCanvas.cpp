@@ -1886,6 +1886,16 @@ void SkCanvas::experimental_DrawEdgeAARectV1(const SkRect& r, QuadAAFlags edgeAA
     this->onDrawEdgeAARect(r.makeSorted(), edgeAA, color, mode);
 }
 
+void SkCanvas::experimental_DrawRectsV1(const SkRect rects[], const SkColor colors[], int count,
+                                        const SkPaint& paint) {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    RETURN_ON_NULL(rects);
+    if (count <= 0) {
+        return;
+    }
+    this->onDrawRects(rects, colors, count, paint);
+}
+
 void SkCanvas::drawBitmap(const SkBitmap& bitmap, SkScalar dx, SkScalar dy, const SkPaint* paint) {
     TRACE_EVENT0("skia", TRACE_FUNC);
     if (bitmap.drawsNothing()) {
@@ -2110,6 +2120,30 @@ void SkCanvas::onDrawEdgeAARect(const SkRect& r, QuadAAFlags edgeAA, SkColor col
     LOOPER_END
 }
 
+void SkCanvas::onDrawRects(const SkRect rects[], const SkColor colors[], int count,
+                           const SkPaint& paint) {
+    // The rects may not be sorted, so bound their corners. Non-finite rects are skipped later on.
+    SkRect bounds;
+    const SkRect* boundsPtr = nullptr;
+    if (bounds.setBoundsCheck(reinterpret_cast<const SkPoint*>(rects), 2 * count)) {
+        if (paint.canComputeFastBounds()) {
+            SkRect storage;
+            if (this->quickReject(paint.computeFastBounds(bounds, &storage))) {
+                return;
+            }
+        }
+        boundsPtr = &bounds;
+    }
+
+    LOOPER_BEGIN(paint, boundsPtr)
+
+    while (iter.next()) {
+        iter.fDevice->drawRects(rects, colors, count, looper.paint());
+    }
+
+    LOOPER_END
+}
+
 void SkCanvas::onDrawRegion(const SkRegion& region, const SkPaint& paint) {
     SkRect regionRect = SkRect::Make(region.getBounds());
     if (paint.canComputeFastBounds()) {
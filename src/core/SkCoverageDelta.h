@@ -50,6 +50,11 @@ public:
 
     SkCoverageDeltaList(SkArenaAlloc* alloc, const SkIRect& bounds, bool forceRLE);
 
+    // A band of parent's rows [top, bottom): deltas added to the band go straight to parent's
+    // rows, and rows that outgrow their storage are reallocated from alloc instead of parent's
+    // alloc. Bands with disjoint rows (and different allocs) can be filled concurrently.
+    SkCoverageDeltaList(SkArenaAlloc* alloc, SkCoverageDeltaList* parent, int top, int bottom);
+
     int  top() const { return fBounds.fTop; }
     int  bottom() const { return fBounds.fBottom; }
     int  left() const { return fBounds.fLeft; }
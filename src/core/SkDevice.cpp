@@ -138,6 +138,17 @@ void SkBaseDevice::drawEdgeAARect(const SkRect& r, SkCanvas::QuadAAFlags aa, SkC
     this->drawRect(r, paint);
 }
 
+void SkBaseDevice::drawRects(const SkRect rects[], const SkColor colors[], int count,
+                             const SkPaint& paint) {
+    SkPaint rectPaint(paint);
+    for (int i = 0; i < count; ++i) {
+        if (colors) {
+            rectPaint.setColor(colors[i]);
+        }
+        this->drawRect(rects[i].makeSorted(), rectPaint);
+    }
+}
+
 void SkBaseDevice::drawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkBlendMode bmode, const SkPaint& paint) {
     SkISize lod = SkPatchUtils::GetLevelOfDetail(cubics, &this->ctm());
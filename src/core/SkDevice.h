@@ -180,6 +180,10 @@ protected:
     virtual void drawEdgeAARect(const SkRect& r, SkCanvas::QuadAAFlags aa, SkColor color,
                                 SkBlendMode mode);
 
+    // Default impl calls drawRect() for each (sorted) rect, with colors[i] as its paint's color.
+    virtual void drawRects(const SkRect rects[], const SkColor colors[], int count,
+                           const SkPaint&);
+
     /**
      *  If pathIsMutable, then the implementation is allowed to cast path to a
      *  non-const pointer and modify it in place (as an optimization). Canvas
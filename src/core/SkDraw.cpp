@@ -10,6 +10,7 @@
 #include "SkArenaAlloc.h"
 #include "SkAutoBlitterChoose.h"
 #include "SkBlendModePriv.h"
+#include "SkBlitRow.h"
 #include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkColorData.h"
@@ -67,6 +68,85 @@ bool SkDraw::computeConservativeLocalClipBounds(SkRect* localBounds) const {
     return true;
 }
 
+namespace {
+// Restricts blits to fBlitClip, producing exactly the pixels the unclipped blitter would have.
+class BlitClipBlitter final : public SkRectClipBlitter {
+public:
+    BlitClipBlitter(SkBlitter* blitter, const SkIRect& clip, const SkPixmap& dst)
+        : fRealBlitter(blitter), fClip(clip), fDst(dst) {
+        this->init(blitter, clip);
+    }
+
+    // SkDraw's opaque fast paths write straight into the pixmap from justAnOpaqueColor(), which
+    // would ignore the clip, so we never offer one.
+    const SkPixmap* justAnOpaqueColor(uint32_t*) override { return nullptr; }
+
+    // Pairs blend differently than runs in some blitters, so keep them pairs.
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        if (fClip.contains(SkIRect::MakeXYWH(x, y, 2, 1))) {
+            fRealBlitter->blitAntiH2(x, y, a0, a1);
+            return;
+        }
+        this->blitPairPixel(x,     y, a0);
+        this->blitPairPixel(x + 1, y, a1);
+    }
+
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        if (fClip.contains(SkIRect::MakeXYWH(x, y, 1, 2))) {
+            fRealBlitter->blitAntiV2(x, y, a0, a1);
+            return;
+        }
+        this->blitPairPixel(x, y,     a0);
+        this->blitPairPixel(x, y + 1, a1);
+    }
+
+private:
+    // Blits one pixel of a pair that straddles the clip, as half of a pair with a neighbor that's
+    // inside the clip, whose pixel we put back afterwards.
+    void blitPairPixel(int x, int y, U8CPU alpha) {
+        if (!fClip.contains(x, y)) {
+            return;
+        }
+        const size_t bpp = fDst.info().bytesPerPixel();
+        if (bpp > 0 && bpp <= 16) {
+            const SkIPoint neighbors[] = { {x + 1, y}, {x - 1, y}, {x, y + 1}, {x, y - 1} };
+            for (const SkIPoint& n : neighbors) {
+                if (!fClip.contains(n.fX, n.fY)) {
+                    continue;
+                }
+                char saved[16];
+                memcpy(saved, fDst.addr(n.fX, n.fY), bpp);
+                if (n.fY == y) {
+                    n.fX > x ? fRealBlitter->blitAntiH2(x, y, alpha, 0)
+                             : fRealBlitter->blitAntiH2(n.fX, y, 0, alpha);
+                } else {
+                    n.fY > y ? fRealBlitter->blitAntiV2(x, y, alpha, 0)
+                             : fRealBlitter->blitAntiV2(x, n.fY, 0, alpha);
+                }
+                memcpy(fDst.writable_addr(n.fX, n.fY), saved, bpp);
+                return;
+            }
+        }
+        // A one pixel clip: the best we can do is a run.
+        int16_t runs[2] = { 1, 0 };
+        SkAlpha aa[1]   = { SkToU8(alpha) };
+        fRealBlitter->blitAntiH(x, y, aa, runs);
+    }
+
+    SkBlitter*      fRealBlitter;
+    const SkIRect   fClip;
+    const SkPixmap  fDst;
+};
+}
+
+SkBlitter* SkDraw::clipBlitter(SkBlitter* blitter, SkArenaAlloc* alloc) const {
+    SkASSERT(!fBlitRecorder);  // the blitter didn't come from SkAutoBlitterChoose
+    if (!fBlitClip) {
+        return blitter;
+    }
+    return alloc->make<BlitClipBlitter>(blitter, *fBlitClip, fDst);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkDraw::drawPaint(const SkPaint& paint) const {
@@ -698,6 +778,122 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
     }
 }
 
+// Solid SrcOver rects into legacy N32 pixels are blitted by SkARGB32_Blitter::blitRect(), one
+// SkBlitRow::Color32() per row. We can do the same without choosing a blitter for each color.
+static bool can_fill_spans_directly(const SkDraw& draw, const SkPaint& paint) {
+    return draw.fDst.colorType() == kN32_SkColorType &&
+           !draw.fCoverage                          &&
+           draw.fRC->isBW()                         &&
+           paint.isSrcOver()                        &&
+           !paint.getShader()                       &&
+           !SkBlitter::UseRasterPipelineBlitter(draw.fDst, paint, *draw.fMatrix);
+}
+
+// Premultiplies color exactly like SkARGB32_Blitter does.
+static SkPMColor blitter_pm_color(SkColor color) {
+    unsigned a     = SkColorGetA(color),
+             scale = SkAlpha255To256(a);
+    return SkPackARGB32(a, SkAlphaMul(SkColorGetR(color), scale),
+                           SkAlphaMul(SkColorGetG(color), scale),
+                           SkAlphaMul(SkColorGetB(color), scale));
+}
+
+static void fill_span_rect(const SkPixmap& dst, const SkIRect& r, SkPMColor color) {
+    uint32_t* row = dst.writable_addr32(r.fLeft, r.fTop);
+    for (int y = r.fTop; y < r.fBottom; ++y) {
+        SkBlitRow::Color32(row, row, r.width(), color);
+        row = (uint32_t*)((char*)row + dst.rowBytes());
+    }
+}
+
+static void fill_clipped_span_rect(const SkPixmap& dst, const SkIRect& r, const SkRegion& clip,
+                                   SkPMColor color) {
+    if (r.isEmpty()) {
+        return;
+    }
+    if (clip.isRect()) {
+        SkIRect rr;
+        if (rr.intersect(r, clip.getBounds())) {
+            fill_span_rect(dst, rr, color);
+        }
+        return;
+    }
+    for (SkRegion::Cliperator cliper(clip, r); !cliper.done(); cliper.next()) {
+        fill_span_rect(dst, cliper.rect(), color);
+    }
+}
+
+void SkDraw::drawRects(const SkRect rects[], const SkColor colors[], int count,
+                       const SkPaint& paint) const {
+    SkDEBUGCODE(this->validate();)
+
+    if (fRC->isEmpty()) {
+        return;
+    }
+
+    SkPoint strokeSize;
+    if (ComputeRectType(paint, *fMatrix, &strokeSize) != kFill_RectType) {
+        // Strokes, hairlines and rects drawn as paths take the usual route, one at a time.
+        SkPaint rectPaint(paint);
+        for (int i = 0; i < count; ++i) {
+            if (colors) {
+                rectPaint.setColor(colors[i]);
+            }
+            this->drawRect(rects[i], rectPaint);
+        }
+        return;
+    }
+
+    const bool directly = can_fill_spans_directly(*this, paint);
+    SkPaint runPaint(paint);
+    for (int i = 0; i < count; ) {
+        // Consecutive rects of the same color share one blitter, if they need one at all.
+        const SkColor color = colors ? colors[i] : paint.getColor();
+        int end = colors ? i + 1 : count;
+        while (end < count && colors[end] == color) {
+            end++;
+        }
+        runPaint.setColor(color);
+        const SkPMColor pmColor = blitter_pm_color(color);
+        SkTLazy<SkAutoBlitterChoose> blitter;
+
+        for (; i < end; ++i) {
+            SkRect devRect;
+            fMatrix->mapPoints(rect_points(devRect), rect_points(rects[i]), 2);
+            devRect.sort();
+            if (SkPathPriv::TooBigForMath(devRect)) {
+                continue;
+            }
+            if (!SkRectPriv::FitsInFixed(devRect)) {
+                draw_rect_as_path(*this, rects[i], runPaint, fMatrix);
+                continue;
+            }
+
+            // Pixel aligned rects have no partial coverage, whether antialiased or not. (Though
+            // antialiasing blits one pixel wide rows and columns with blitV(), which blends
+            // translucent colors slightly differently.)
+            SkIRect ir;
+            devRect.round(&ir);
+            if (directly && (!paint.isAntiAlias() || (SkColorGetA(color) == 0xFF &&
+                                                      SkRect::Make(ir) == devRect))) {
+                if (SkColorGetA(color)) {
+                    fill_clipped_span_rect(fDst, ir, fRC->bwRgn(), pmColor);
+                }
+                continue;
+            }
+
+            if (!blitter.isValid()) {
+                blitter.init(*this, nullptr, runPaint);
+            }
+            if (paint.isAntiAlias()) {
+                SkScan::AntiFillRect(devRect, *fRC, blitter.get()->get());
+            } else {
+                SkScan::FillRect(devRect, *fRC, blitter.get()->get());
+            }
+        }
+    }
+}
+
 void SkDraw::drawDevMask(const SkMask& srcM, const SkPaint& paint) const {
     if (srcM.fBounds.isEmpty()) {
         return;
@@ -1102,7 +1298,7 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator);
             if (blitter) {
                 SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
-                                  *fRC, blitter);
+                                  *fRC, this->clipBlitter(blitter, &allocator));
                 return;
             }
             // if !blitter, then we fall-through to the slower case
@@ -1156,7 +1352,7 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         SkSTArenaAlloc<kSkBlitterContextSize> allocator;
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator);
         if (blitter) {
-            SkScan::FillIRect(bounds, *fRC, blitter);
+            SkScan::FillIRect(bounds, *fRC, this->clipBlitter(blitter, &allocator));
             return;
         }
     }
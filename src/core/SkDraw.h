@@ -18,10 +18,13 @@
 #include "SkStrokeRec.h"
 #include "SkVertices.h"
 
+class SkArenaAlloc;
 class SkBitmap;
 class SkClipStack;
 class SkBaseDevice;
+class SkBlitRecorder;
 class SkBlitter;
+class SkBlitterCache;
 class SkMatrix;
 class SkPath;
 class SkRegion;
@@ -41,6 +44,9 @@ public:
     void    drawRect(const SkRect& rect, const SkPaint& paint) const {
         this->drawRect(rect, paint, nullptr, nullptr);
     }
+    /* Draws each rect as drawRect() would, using colors[i] (if colors is not null) as its color. */
+    void    drawRects(const SkRect rects[], const SkColor colors[], int count,
+                      const SkPaint&) const;
     void    drawRRect(const SkRRect&, const SkPaint&) const;
     /**
      *  To save on mallocs, we allow a flag that tells us that srcPath is
@@ -126,6 +132,13 @@ public:
                                       SkScalar sizeLimit = 1024);
 
     static SkScalar ComputeResScaleForStroking(const SkMatrix& );
+
+    /**
+     *  If fBlitClip is set, return blitter wrapped (in alloc) so that it never writes outside of
+     *  it, otherwise return blitter unchanged.
+     */
+    SkBlitter* clipBlitter(SkBlitter* blitter, SkArenaAlloc* alloc) const;
+
 private:
     void drawBitmapAsMask(const SkBitmap&, const SkPaint&) const;
 
@@ -161,6 +174,16 @@ public:
     // optional, will be same dimensions as fDst if present
     const SkPixmap* fCoverage{nullptr};
 
+    // optional, if present every blit is restricted to this device rect, without fRC (and so
+    // the scan conversion of the geometry) being affected by it
+    const SkIRect* fBlitClip{nullptr};
+
+    // optional, if present SkAutoBlitterChoose reuses the last blitter it chose for these pixels
+    SkBlitterCache* fBlitterCache{nullptr};
+
+    // optional, if present SkAutoBlitterChoose records the blits into it instead of drawing them
+    SkBlitRecorder* fBlitRecorder{nullptr};
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
@@ -11,8 +11,10 @@
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
 #include "SkTArray.h"
+#include <atomic>
 #include <deque>
 #include <thread>
+#include <vector>
 
 #if defined(SK_BUILD_FOR_WIN)
     #include "SkLeanWindows.h"
@@ -131,6 +133,222 @@ private:
     SkSemaphore           fWorkAvailable;
 };
 
+// A Chase-Lev work-stealing deque: its owner pushes and pops work at the bottom (LIFO), while any
+// other thread may steal from the top (FIFO).  See "Correct and Efficient Work-Stealing for Weak
+// Memory Models", Lê et al., PPoPP 2013.
+class SkWorkStealingDeque {
+public:
+    using Work = std::function<void(void)>;
+
+    SkWorkStealingDeque() : fTop(0), fBottom(0) {
+        fArrays.push_back(skstd::make_unique<Array>(32));
+        fArray.store(fArrays.back().get(), std::memory_order_relaxed);
+    }
+
+    ~SkWorkStealingDeque() {
+        while (Work* work = this->pop()) {
+            delete work;
+        }
+    }
+
+    // Owner only.
+    void push(Work* work) {
+        int64_t b = fBottom.load(std::memory_order_relaxed),
+                t = fTop   .load(std::memory_order_acquire);
+        Array* a = fArray.load(std::memory_order_relaxed);
+        if (b - t > a->fMask) {
+            a = this->grow(a, t, b);
+        }
+        a->put(b, work);
+        std::atomic_thread_fence(std::memory_order_release);
+        fBottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only.  Returns nullptr if the deque is empty.
+    Work* pop() {
+        int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+        Array* a = fArray.load(std::memory_order_relaxed);
+        fBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = fTop.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            fBottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Work* work = a->get(b);
+        if (t == b) {
+            // Last item: race any thieves for it.
+            if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed)) {
+                work = nullptr;
+            }
+            fBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    // Any thread.  Returns nullptr if the deque is empty or we lost a race for its top item;
+    // *contended tells the two apart.
+    Work* steal(bool* contended) {
+        int64_t t = fTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = fBottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+        Work* work = fArray.load(std::memory_order_acquire)->get(t);
+        if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+            *contended = true;
+            return nullptr;
+        }
+        return work;
+    }
+
+private:
+    struct Array {
+        explicit Array(int64_t size) : fMask(size - 1), fItems(new std::atomic<Work*>[size]) {}
+
+        Work* get(int64_t i) const { return fItems[i & fMask].load(std::memory_order_relaxed); }
+        void put(int64_t i, Work* w) { fItems[i & fMask].store(w, std::memory_order_relaxed); }
+
+        const int64_t                         fMask;
+        std::unique_ptr<std::atomic<Work*>[]> fItems;
+    };
+
+    Array* grow(Array* a, int64_t t, int64_t b) {
+        auto bigger = skstd::make_unique<Array>(2 * (a->fMask + 1));
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, a->get(i));
+        }
+        // Thieves may still be reading the old array, so we keep it around until we're destroyed.
+        fArrays.push_back(std::move(bigger));
+        fArray.store(fArrays.back().get(), std::memory_order_release);
+        return fArrays.back().get();
+    }
+
+    std::atomic<int64_t>                fTop,
+                                        fBottom;
+    std::atomic<Array*>                 fArray;
+    std::vector<std::unique_ptr<Array>> fArrays;   // Owner only.
+};
+
+// An SkWorkStealingThreadPool gives each of its threads its own SkWorkStealingDeque.  Work added
+// from one of those threads goes on that thread's deque with no locking, and idle threads steal
+// the oldest work from their busy siblings.  Work added from other threads goes through a shared,
+// locked queue.  As in SkThreadPool, fWorkAvailable counts work that's been added but not claimed.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingThreadPool(int threads)
+        : fDeques(new SkWorkStealingDeque[threads]), fStop(false) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Once each thread finds no more work, it shuts down.
+        fStop.store(true, std::memory_order_relaxed);
+        fWorkAvailable.signal(fThreads.count());
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+        for (Work* work : fShared) {
+            delete work;
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        auto heapWork = new std::function<void(void)>(std::move(work));
+        if (gCurrentPool == this) {
+            fDeques[gCurrentIndex].push(heapWork);
+        } else {
+            SkAutoExclusive lock(fSharedLock);
+            fShared.push_back(heapWork);
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // If there is work waiting, do it.  When called from one of our threads (e.g. from a
+        // nested SkTaskGroup::wait()), this prefers that thread's own most recently added work.
+        if (fWorkAvailable.try_wait()) {
+            this->runOne();
+        }
+    }
+
+private:
+    using Work = SkWorkStealingDeque::Work;
+
+    // Finds and runs some work, spinning as needed.  Must be called only after claiming a count
+    // from fWorkAvailable, so some work is guaranteed to be waiting for us.  Returns false only
+    // when shutting down with no work left.
+    bool runOne() {
+        for (;;) {
+            bool contended = false;
+            if (Work* work = this->find(&contended)) {
+                (*work)();
+                delete work;
+                return true;
+            }
+            if (!contended && fStop.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    Work* find(bool* contended) {
+        const bool ours = gCurrentPool == this;
+        if (ours) {
+            if (Work* work = fDeques[gCurrentIndex].pop()) {
+                return work;
+            }
+        }
+        {
+            SkAutoExclusive lock(fSharedLock);
+            if (!fShared.empty()) {
+                Work* work = fShared.front();
+                fShared.pop_front();
+                return work;
+            }
+        }
+        // Steal, starting with our right-hand neighbor so that thieves spread out.
+        const int n = fThreads.count(),
+                  start = ours ? gCurrentIndex + 1 : 0;
+        for (int i = 0; i < n; i++) {
+            if (Work* work = fDeques[(start + i) % n].steal(contended)) {
+                return work;
+            }
+        }
+        return nullptr;
+    }
+
+    static void Loop(SkWorkStealingThreadPool* pool, int index) {
+        gCurrentPool  = pool;
+        gCurrentIndex = index;
+        do {
+            pool->fWorkAvailable.wait();
+        } while (pool->runOne());
+    }
+
+    // Which pool and deque the current thread works for, if any.
+    static thread_local SkWorkStealingThreadPool* gCurrentPool;
+    static thread_local int                       gCurrentIndex;
+
+    SkTArray<std::thread>                  fThreads;
+    std::unique_ptr<SkWorkStealingDeque[]> fDeques;
+    SkMutex                                fSharedLock;
+    std::deque<Work*>                      fShared;
+    SkSemaphore                            fWorkAvailable;
+    std::atomic<bool>                      fStop;
+};
+
+thread_local SkWorkStealingThreadPool* SkWorkStealingThreadPool::gCurrentPool  = nullptr;
+thread_local int                       SkWorkStealingThreadPool::gCurrentIndex = 0;
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads) {
     using WorkList = std::deque<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
@@ -139,3 +357,6 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads) {
     using WorkList = SkTArray<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads) {
+    return skstd::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores());
+}
@@ -202,6 +202,17 @@ int SkFont::textToGlyphs(const void* text, size_t byteLength, SkTextEncoding enc
             return count;
     }
 
+    // Decoding UTF-8 up front takes runs of ASCII a block at a time, instead of a character at a
+    // time in the typeface.
+    SkAutoSTMalloc<256, SkUnichar> unichars;
+    if (kUTF8_SkTextEncoding == encoding && count > 0) {
+        unichars.reset(count);
+        if (SkUTF::UTF8ToUTF32((const char*)text, byteLength, unichars.get(), count) == count) {
+            text = unichars.get();
+            typefaceEncoding = SkTypeface::kUTF32_Encoding;
+        }
+    }
+
     (void) this->getTypefaceOrDefault()->charsToGlyphs(text, typefaceEncoding, glyphs,count);
     return count;
 }
@@ -236,6 +247,31 @@ static void join_bounds_x(const SkGlyph& g, SkRect* bounds, SkScalar dx) {
                  SkIntToScalar(g.fTop + g.fHeight));
 }
 
+// Calls proc(i, glyph) for each of the glyphs if they, and their strike, are already cached. The
+// strike is shared with other threads rather than checked out, so they can do the same at once.
+// Returns false if anything is missing, leaving it to the caller to check out the strike.
+template <typename Proc>
+static bool visit_cached_glyphs(const SkFont& font, const SkPaint& paint,
+                                const uint16_t glyphs[], int count, Proc proc) {
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(font, paint,
+                              SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType),
+                              kFakeGammaAndBoostContrast, SkMatrix::I(), &ad, &effects);
+    SkSharedStrikePtr strike = SkStrikeCache::FindStrikeShared(*desc);
+    if (!strike) {
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        const SkGlyph* glyph = strike->getCachedGlyph(SkPackedGlyphID(glyphs[i]));
+        if (!glyph) {
+            return false;
+        }
+        proc(i, *glyph);
+    }
+    return true;
+}
+
 SkScalar SkFont::measureText(const void* text, size_t length, SkTextEncoding encoding,
                              SkRect* bounds, const SkPaint* paint) const {
     SkCanonicalizeFont canon(*this, paint);
@@ -252,21 +288,29 @@ SkScalar SkFont::measureText(const void* text, size_t length, SkTextEncoding enc
     }
     const uint16_t* glyphs = atg.glyphs();
 
-    auto cache = SkStrikeCache::FindOrCreateStrikeWithNoDeviceExclusive(font, canon.getPaint());
-
     SkScalar width = 0;
-    if (bounds) {
-        const SkGlyph* g = &cache->getGlyphIDMetrics(glyphs[0]);
-        set_bounds(*g, bounds);
-        width = g->fAdvanceX;
-        for (int i = 1; i < count; ++i) {
-            g = &cache->getGlyphIDMetrics(glyphs[i]);
-            join_bounds_x(*g, bounds, width);
-            width += g->fAdvanceX;
-        }
+    SkScalar cachedWidth = 0;
+    if (!bounds && visit_cached_glyphs(font, canon.getPaint(), glyphs, count,
+                                       [&cachedWidth](int, const SkGlyph& g) {
+                                           cachedWidth += g.fAdvanceX;
+                                       })) {
+        width = cachedWidth;
     } else {
-        for (int i = 0; i < count; ++i) {
-            width += cache->getGlyphIDAdvance(glyphs[i]).fAdvanceX;
+        auto cache = SkStrikeCache::FindOrCreateStrikeWithNoDeviceExclusive(font,
+                                                                          canon.getPaint());
+        if (bounds) {
+            const SkGlyph* g = &cache->getGlyphIDMetrics(glyphs[0]);
+            set_bounds(*g, bounds);
+            width = g->fAdvanceX;
+            for (int i = 1; i < count; ++i) {
+                g = &cache->getGlyphIDMetrics(glyphs[i]);
+                join_bounds_x(*g, bounds, width);
+                width += g->fAdvanceX;
+            }
+        } else {
+            for (int i = 0; i < count; ++i) {
+                width += cache->getGlyphIDAdvance(glyphs[i]).fAdvanceX;
+            }
         }
     }
 
@@ -312,6 +356,16 @@ void VisitGlyphs(const SkFont& origFont, const SkPaint* paint, const uint16_t gl
 
 void SkFont::getWidthsBounds(const uint16_t glyphs[], int count, SkScalar widths[], SkRect bounds[],
                              const SkPaint* paint) const {
+    if (widths && !bounds && count > 0) {
+        SkCanonicalizeFont canon(*this, paint);
+        SkScalar scale = canon.getScale() ? canon.getScale() : 1;
+        if (visit_cached_glyphs(canon.getFont(), canon.getPaint(), glyphs, count,
+                                [widths, scale](int i, const SkGlyph& g) {
+                                    widths[i] = g.fAdvanceX * scale;
+                                })) {
+            return;
+        }
+    }
     VisitGlyphs(*this, paint, glyphs, count, [widths, bounds]
                 (SkStrike* cache, const uint16_t glyphs[], int count, SkScalar scale) {
         for (int i = 0; i < count; ++i) {
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGlyphAtlas.h"
+
+#include "SkIPoint16.h"
+#include "SkMakeUnique.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+
+std::atomic<bool> gSkUseRasterGlyphAtlas{false};
+
+// The atlas only holds A8 and LCD16 images.
+static size_t bytes_per_pixel(SkMask::Format format) {
+    SkASSERT(format == SkMask::kA8_Format || format == SkMask::kLCD16_Format);
+    return format == SkMask::kLCD16_Format ? 2 : 1;
+}
+
+// The skyline packer of GrRectanizerSkyline, which is only built with the GPU backend.
+class SkGlyphAtlas::Skyline {
+public:
+    Skyline() {
+        fSegments.push_back(Segment{0, 0, kPageWidth});
+    }
+
+    bool addRect(int width, int height, SkIPoint16* loc) {
+        // Find the lowest place the rectangle fits, preferring narrower segments.
+        int bestWidth = kPageWidth + 1;
+        int bestX = 0;
+        int bestY = kPageHeight + 1;
+        int bestIndex = -1;
+        for (int i = 0; i < fSegments.count(); ++i) {
+            int y;
+            if (this->rectangleFits(i, width, height, &y)) {
+                if (y < bestY || (y == bestY && fSegments[i].fWidth < bestWidth)) {
+                    bestIndex = i;
+                    bestWidth = fSegments[i].fWidth;
+                    bestX = fSegments[i].fX;
+                    bestY = y;
+                }
+            }
+        }
+        if (bestIndex < 0) {
+            return false;
+        }
+        this->addLevel(bestIndex, bestX, bestY, width, height);
+        loc->set(bestX, bestY);
+        return true;
+    }
+
+private:
+    struct Segment {
+        int fX;
+        int fY;
+        int fWidth;
+    };
+
+    bool rectangleFits(int index, int width, int height, int* ypos) const {
+        if (fSegments[index].fX + width > kPageWidth) {
+            return false;
+        }
+        int widthLeft = width;
+        int y = fSegments[index].fY;
+        for (int i = index; widthLeft > 0; ++i) {
+            y = SkTMax(y, fSegments[i].fY);
+            if (y + height > kPageHeight) {
+                return false;
+            }
+            widthLeft -= fSegments[i].fWidth;
+        }
+        *ypos = y;
+        return true;
+    }
+
+    void addLevel(int index, int x, int y, int width, int height) {
+        Segment segment{x, y + height, width};
+        fSegments.insert(index, 1, &segment);
+
+        // Take the new segment's width out of the segments it covers.
+        for (int i = index + 1; i < fSegments.count(); ++i) {
+            int shrink = fSegments[i - 1].fX + fSegments[i - 1].fWidth - fSegments[i].fX;
+            if (shrink <= 0) {
+                break;
+            }
+            fSegments[i].fX += shrink;
+            fSegments[i].fWidth -= shrink;
+            if (fSegments[i].fWidth > 0) {
+                break;
+            }
+            fSegments.remove(i);
+            --i;
+        }
+
+        // Merge neighbors at the same height.
+        for (int i = 0; i < fSegments.count() - 1; ++i) {
+            if (fSegments[i].fY == fSegments[i + 1].fY) {
+                fSegments[i].fWidth += fSegments[i + 1].fWidth;
+                fSegments.remove(i + 1);
+                --i;
+            }
+        }
+    }
+
+    SkTDArray<Segment> fSegments;
+};
+
+struct SkGlyphAtlas::Page {
+    explicit Page(SkMask::Format format)
+        : fFormat{format}
+        , fRowBytes{kPageWidth * bytes_per_pixel(format)}
+        , fPixels{fRowBytes * kPageHeight} {}
+
+    const SkMask::Format fFormat;
+    const size_t         fRowBytes;
+    SkAutoTMalloc<char>  fPixels;
+    Skyline              fSkyline;
+};
+
+SkGlyphAtlas::SkGlyphAtlas() = default;
+SkGlyphAtlas::~SkGlyphAtlas() = default;
+
+bool SkGlyphAtlas::CanHold(const SkGlyph& glyph) {
+    return (glyph.fMaskFormat == SkMask::kA8_Format || glyph.fMaskFormat == SkMask::kLCD16_Format)
+           && !glyph.isEmpty()
+           && glyph.fWidth <= kMaxGlyphSize && glyph.fHeight <= kMaxGlyphSize;
+}
+
+const void* SkGlyphAtlas::imageAt(const Location& location, size_t* rowBytes) const {
+    const Page& page = *fPages[location.fPage];
+    *rowBytes = page.fRowBytes;
+    return page.fPixels.get() + location.fY * page.fRowBytes
+                              + location.fX * bytes_per_pixel(page.fFormat);
+}
+
+const void* SkGlyphAtlas::find(const SkGlyph& glyph, size_t* rowBytes) const {
+    const Location* location = fLocations.find(glyph.getPackedID());
+    return location != nullptr ? this->imageAt(*location, rowBytes) : nullptr;
+}
+
+const void* SkGlyphAtlas::add(const SkGlyph& glyph, const void* image, size_t* rowBytes,
+                              size_t* bytesAllocated) {
+    SkASSERT(CanHold(glyph));
+    SkASSERT(!fLocations.find(glyph.getPackedID()));
+    *bytesAllocated = 0;
+
+    // Only the newest page of each format takes new glyphs; older ones are close to full.
+    SkMask::Format format = static_cast<SkMask::Format>(glyph.fMaskFormat);
+    int pageIndex = -1;
+    for (int i = this->pageCount() - 1; i >= 0; --i) {
+        if (fPages[i]->fFormat == format) {
+            pageIndex = i;
+            break;
+        }
+    }
+
+    SkIPoint16 loc;
+    if (pageIndex < 0 || !fPages[pageIndex]->fSkyline.addRect(glyph.fWidth, glyph.fHeight, &loc)) {
+        fPages.push_back(skstd::make_unique<Page>(format));
+        pageIndex = this->pageCount() - 1;
+        *bytesAllocated = sizeof(Page) + fPages.back()->fRowBytes * kPageHeight;
+        SkAssertResult(fPages.back()->fSkyline.addRect(glyph.fWidth, glyph.fHeight, &loc));
+    }
+
+    Location* location = fLocations.set(glyph.getPackedID(), Location{pageIndex, loc.fX, loc.fY});
+    char* dst = (char*)this->imageAt(*location, rowBytes);
+    const char* src = (const char*)image;
+    size_t srcRowBytes = glyph.rowBytes();
+    for (int y = 0; y < glyph.fHeight; ++y) {
+        memcpy(dst, src, srcRowBytes);
+        dst += *rowBytes;
+        src += srcRowBytes;
+    }
+    return this->imageAt(*location, rowBytes);
+}
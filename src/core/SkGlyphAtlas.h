@@ -0,0 +1,70 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGlyphAtlas_DEFINED
+#define SkGlyphAtlas_DEFINED
+
+#include "SkGlyph.h"
+#include "SkTHash.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// When set, the raster backend blits small glyphs out of their strikes' glyph atlases.
+extern std::atomic<bool> gSkUseRasterGlyphAtlas;
+
+/** \class SkGlyphAtlas
+
+    Packs copies of the A8 and LCD16 images of a strike's small glyphs into pages of pixels, so
+    that drawing a run of small text reads from a few pages instead of from an allocation per
+    glyph. Each format has its own pages, and glyphs are packed into the newest page of their
+    format with a skyline packer, like the GPU atlas's GrRectanizerSkyline.
+
+    The atlas isn't thread safe; SkStrike uses it while checked out.
+*/
+class SkGlyphAtlas {
+public:
+    static constexpr int kPageWidth  = 256;
+    static constexpr int kPageHeight = 64;
+    // Glyphs wider or taller than this are left out of the atlas.
+    static constexpr int kMaxGlyphSize = 32;
+
+    SkGlyphAtlas();
+    ~SkGlyphAtlas();
+
+    static bool CanHold(const SkGlyph& glyph);
+
+    /** Returns the glyph's image in the atlas, and sets rowBytes to the stride of its page, or
+        returns null if it hasn't been added.
+    */
+    const void* find(const SkGlyph& glyph, size_t* rowBytes) const;
+
+    /** Copies image, the glyph's image, into the atlas, and returns it as find() would. Returns
+        the number of bytes allocated for a new page in bytesAllocated, if any.
+    */
+    const void* add(const SkGlyph& glyph, const void* image, size_t* rowBytes,
+                    size_t* bytesAllocated);
+
+    int pageCount() const { return SkToInt(fPages.size()); }
+
+private:
+    class Skyline;
+    struct Page;
+
+    struct Location {
+        int     fPage;
+        int16_t fX, fY;
+    };
+
+    const void* imageAt(const Location& location, size_t* rowBytes) const;
+
+    SkTHashMap<SkPackedGlyphID, Location> fLocations;
+    std::vector<std::unique_ptr<Page>> fPages;
+};
+
+#endif  // SkGlyphAtlas_DEFINED
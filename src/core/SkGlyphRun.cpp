@@ -233,6 +233,45 @@ void SkGlyphRunBuilder::drawTextBlob(const SkPaint& paint, const SkTextBlob& blo
     }
 }
 
+const SkGlyphRunList& SkGlyphRunBuilder::textBlobToGlyphRunListIgnoringRSXForm(
+        const SkPaint& paint, const SkTextBlob& blob, SkPoint origin) {
+    size_t totalGlyphs = 0;
+    for (SkTextBlobRunIterator it(&blob); !it.done(); it.next()) {
+        totalGlyphs += it.glyphCount();
+    }
+    this->initialize(totalGlyphs);
+
+    SkPoint* positions = fPositions;
+    for (SkTextBlobRunIterator it(&blob); !it.done(); it.next()) {
+        size_t runSize = it.glyphCount();
+        auto text = SkSpan<const char>(it.text(), it.textSize());
+        auto clusters = SkSpan<const uint32_t>(it.clusters(), runSize);
+        auto glyphIDs = SkSpan<const SkGlyphID>{it.glyphs(), runSize};
+
+        switch (it.positioning()) {
+            case SkTextBlobRunIterator::kDefault_Positioning:
+                this->simplifyDrawText(
+                        it.font(), glyphIDs, it.offset(), positions, text, clusters);
+                break;
+            case SkTextBlobRunIterator::kHorizontal_Positioning:
+                this->simplifyDrawPosTextH(
+                        it.font(), glyphIDs, it.pos(), it.offset().y(), positions, text, clusters);
+                break;
+            case SkTextBlobRunIterator::kFull_Positioning:
+                this->simplifyDrawPosText(
+                        it.font(), glyphIDs, (const SkPoint*)it.pos(), text, clusters);
+                break;
+            case SkTextBlobRunIterator::kRSXform_Positioning:
+                break;
+        }
+
+        positions += runSize;
+    }
+
+    this->makeGlyphRunList(paint, &blob, origin);
+    return this->useGlyphRunList();
+}
+
 void SkGlyphRunBuilder::drawGlyphsWithPositions(const SkPaint& paint, const SkFont& font,
                                             SkSpan<const SkGlyphID> glyphIDs, const SkPoint* pos) {
     if (!glyphIDs.empty()) {
@@ -120,6 +120,11 @@ public:
             const SkPaint&, const SkFont&, SkSpan<const SkGlyphID> glyphIDs, const SkPoint* pos);
     void drawTextBlob(const SkPaint& paint, const SkTextBlob& blob, SkPoint origin, SkBaseDevice*);
 
+    // Builds the glyph runs of blob without drawing them. RSXform runs are left out, since they
+    // are drawn glyph by glyph.
+    const SkGlyphRunList& textBlobToGlyphRunListIgnoringRSXForm(
+            const SkPaint& paint, const SkTextBlob& blob, SkPoint origin);
+
     const SkGlyphRunList& useGlyphRunList();
 
     bool empty() const { return fGlyphRunListStorage.size() == 0; }
@@ -24,6 +24,8 @@
 #include "SkDistanceFieldGen.h"
 #include "SkDraw.h"
 #include "SkFontPriv.h"
+#include "SkGlyphAtlas.h"
+#include "SkMakeUnique.h"
 #include "SkMaskFilter.h"
 #include "SkPaintPriv.h"
 #include "SkPathEffect.h"
@@ -35,6 +37,9 @@
 #include "SkTDArray.h"
 #include "SkTraceEvent.h"
 
+#include <algorithm>
+#include <vector>
+
 // -- SkGlyphCacheCommon ---------------------------------------------------------------------------
 
 SkVector SkStrikeCommon::PixelRounding(bool isSubpixel, SkAxisAlignment axisAlignment) {
@@ -228,6 +233,8 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
             matrix.postTranslate(rounding.x(), rounding.y());
             matrix.mapPoints(fPositions, glyphRun.positions().data(), runSize);
 
+            // Small glyphs may come from the strike's atlas instead, which packs them together.
+            bool useAtlas = gSkUseRasterGlyphAtlas;
             SkTDArray<SkMask> masks;
             masks.setReserve(runSize);
             const SkPoint* positionCursor = fPositions;
@@ -236,7 +243,15 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
                 if (check_glyph_position(position)) {
                     const SkGlyph& glyph = cache->getGlyphMetrics(glyphID, position);
                     const void* image;
-                    if (!glyph.isEmpty() && (image = cache->findImage(glyph))) {
+                    size_t atlasRowBytes;
+                    if (glyph.isEmpty()) {
+                        continue;
+                    }
+                    if (useAtlas && (image = cache->findAtlasImage(glyph, &atlasRowBytes))) {
+                        SkMask mask = create_mask(glyph, position, image);
+                        mask.fRowBytes = atlasRowBytes;
+                        masks.push_back(mask);
+                    } else if ((image = cache->findImage(glyph))) {
                         masks.push_back(create_mask(glyph, position, image));
                     }
                 }
@@ -246,6 +261,92 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
     }
 }
 
+void SkGlyphRunListPainter::prerasterizeForBitmapDevice(
+        SkSpan<const SkGlyphRunList* const> glyphRunLists, const SkMatrix& deviceMatrix,
+        SkExecutor* executor) {
+    // A strike can only be checked out once, and runs often share strikes, so keep the strikes
+    // checked out along with the glyphs each still needs images for.
+    struct StrikeGlyphs {
+        SkExclusiveStrikePtr fStrike;
+        std::vector<const SkGlyph*> fGlyphs;
+    };
+    std::vector<StrikeGlyphs> strikes;
+
+    for (const SkGlyphRunList* glyphRunList : glyphRunLists) {
+        ScopedBuffers _ = this->ensureBuffers(*glyphRunList);
+
+        // Choose the strikes the same way drawForBitmapDevice() does.
+        const SkPaint& runPaint = glyphRunList->paint();
+        auto& props = (kN32_SkColorType == fColorType && runPaint.isSrcOver())
+                      ? fDeviceProps
+                      : fBitmapFallbackProps;
+
+        SkPoint origin = glyphRunList->origin();
+        for (auto& glyphRun : *glyphRunList) {
+            const SkFont& runFont = glyphRun.font();
+            if (ShouldDrawAsPath(runPaint, runFont, deviceMatrix)) {
+                continue;
+            }
+
+            SkAutoDescriptor ad;
+            SkScalerContextEffects effects;
+            auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+                    runFont, runPaint, props, fScalerContextFlags, deviceMatrix, &ad, &effects);
+            auto found = std::find_if(strikes.begin(), strikes.end(),
+                                      [desc](const StrikeGlyphs& strike) {
+                                          return strike.fStrike->getDescriptor() == *desc;
+                                      });
+            if (found == strikes.end()) {
+                strikes.push_back({SkStrikeCache::FindOrCreateStrikeExclusive(
+                                           *desc, effects, *runFont.getTypefaceOrDefault()),
+                                   {}});
+                found = strikes.end() - 1;
+            }
+            SkStrike* cache = found->fStrike.get();
+
+            // Subpixel glyphs depend on their positions, so find them as they'll be drawn.
+            SkMatrix matrix = deviceMatrix;
+            matrix.preTranslate(origin.x(), origin.y());
+            SkPoint rounding = cache->rounding();
+            matrix.postTranslate(rounding.x(), rounding.y());
+            matrix.mapPoints(fPositions, glyphRun.positions().data(), glyphRun.runSize());
+
+            const SkPoint* positionCursor = fPositions;
+            for (auto glyphID : glyphRun.glyphsIDs()) {
+                auto position = *positionCursor++;
+                if (check_glyph_position(position)) {
+                    const SkGlyph& glyph = cache->getGlyphMetrics(glyphID, position);
+                    if (!glyph.isEmpty() && glyph.fImage == nullptr) {
+                        found->fGlyphs.push_back(&glyph);
+                    }
+                }
+            }
+        }
+    }
+
+    for (StrikeGlyphs& strike : strikes) {
+        strike.fStrike->prepareImages(
+                SkSpan<const SkGlyph* const>{strike.fGlyphs.data(), strike.fGlyphs.size()},
+                executor);
+    }
+}
+
+void SkGlyphRunListPainter::prerasterizeForBitmapDevice(
+        SkSpan<const SkTextBlob* const> blobs, const SkPoint origins[], const SkPaint& paint,
+        const SkMatrix& deviceMatrix, SkExecutor* executor) {
+    // Each glyph run list refers to its builder's storage, so every blob needs its own builder.
+    std::vector<std::unique_ptr<SkGlyphRunBuilder>> builders;
+    std::vector<const SkGlyphRunList*> glyphRunLists;
+    for (size_t i = 0; i < blobs.size(); ++i) {
+        builders.push_back(skstd::make_unique<SkGlyphRunBuilder>());
+        glyphRunLists.push_back(&builders.back()->textBlobToGlyphRunListIgnoringRSXForm(
+                paint, *blobs[i], origins[i]));
+    }
+    this->prerasterizeForBitmapDevice(
+            SkSpan<const SkGlyphRunList* const>{glyphRunLists.data(), glyphRunLists.size()},
+            deviceMatrix, executor);
+}
+
 // Getting glyphs to the screen in a fallback situation can be complex. Here is the set of
 // transformations that have to happen. Normally, they would all be accommodated by the font
 // scaler, but the atlas has an upper limit to the glyphs it can handle. So the GPU is used to
@@ -20,6 +20,7 @@ class GrColorSpaceInfo;
 class GrRenderTargetContext;
 #endif
 
+class SkExecutor;
 class SkGlyphRunPainterInterface;
 
 class SkStrikeCommon {
@@ -66,6 +67,17 @@ public:
             const SkGlyphRunList& glyphRunList, const SkMatrix& deviceMatrix,
             const BitmapDevicePainter* bitmapDevice);
 
+    // Makes the glyph images drawForBitmapDevice() will need for these glyph run lists, using
+    // executor's threads, so drawing them later finds the images already in their strikes. Runs
+    // drawn as paths are skipped.
+    void prerasterizeForBitmapDevice(SkSpan<const SkGlyphRunList* const> glyphRunLists,
+                                     const SkMatrix& deviceMatrix, SkExecutor* executor);
+
+    // As above, for blobs drawn with paint at the matching origins. RSXform runs are skipped.
+    void prerasterizeForBitmapDevice(SkSpan<const SkTextBlob* const> blobs, const SkPoint origins[],
+                                     const SkPaint& paint, const SkMatrix& deviceMatrix,
+                                     SkExecutor* executor);
+
 #if SK_SUPPORT_GPU
     // A nullptr for process means that the calls to the cache will be performed, but none of the
     // callbacks will be called.
@@ -40,6 +40,7 @@
 #include "SkBlitMask_opts.h"
 #include "SkBlitRow_opts.h"
 #include "SkChecksum_opts.h"
+#include "SkCoverageDelta_opts.h"
 #include "SkRasterPipeline_opts.h"
 #include "SkSwizzler_opts.h"
 #include "SkUtils_opts.h"
@@ -68,6 +69,8 @@ namespace SkOpts {
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
 
+    DEFINE_DEFAULT(coverage_deltas_to_alpha);
+
     DEFINE_DEFAULT(memset16);
     DEFINE_DEFAULT(memset32);
     DEFINE_DEFAULT(memset64);
@@ -97,6 +100,7 @@ namespace SkOpts {
     void Init_sse42();
     void Init_avx();
     void Init_hsw();
+    void Init_skx();
     void Init_crc32();
 
     static void init() {
@@ -119,6 +123,10 @@ namespace SkOpts {
             if (SkCpu::Supports(SkCpu::HSW)) { Init_hsw();   }
         #endif
 
+        #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX512
+            if (SkCpu::Supports(SkCpu::SKX)) { Init_skx();   }
+        #endif
+
     #elif defined(SK_CPU_ARM64)
         if (SkCpu::Supports(SkCpu::CRC32)) { Init_crc32(); }
 
@@ -126,6 +134,57 @@ namespace SkOpts {
 #endif
     }
 
+    static void Init_baseline_raster_pipeline() {
+    #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
+        SK_RASTER_PIPELINE_STAGES(M)
+        just_return_highp = (StageFn)SK_OPTS_NS::just_return;
+        start_pipeline_highp = SK_OPTS_NS::start_pipeline;
+    #undef M
+
+    #define M(st) stages_lowp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::lowp::st;
+        SK_RASTER_PIPELINE_STAGES(M)
+        just_return_lowp = (StageFn)SK_OPTS_NS::lowp::just_return;
+        start_pipeline_lowp = SK_OPTS_NS::lowp::start_pipeline;
+    #undef M
+    }
+
+    bool SetRasterPipelineStagesForBenchmarks(const char* isa) {
+        if (0 == strcmp(isa, "native")) {
+            Init_baseline_raster_pipeline();
+            init();
+            return true;
+        }
+        if (0 == strcmp(isa, "baseline")) {
+            Init_baseline_raster_pipeline();
+            return true;
+        }
+#if !defined(SK_BUILD_NO_OPTS) && defined(SK_CPU_X86)
+    #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SSE41
+        if (0 == strcmp(isa, "sse41") && SkCpu::Supports(SkCpu::SSE41)) {
+            Init_sse41();
+            return true;
+        }
+    #endif
+    #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX
+        if (0 == strcmp(isa, "avx") && SkCpu::Supports(SkCpu::AVX)) {
+            Init_avx();
+            return true;
+        }
+        if (0 == strcmp(isa, "hsw") && SkCpu::Supports(SkCpu::HSW)) {
+            Init_hsw();
+            return true;
+        }
+    #endif
+    #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX512
+        if (0 == strcmp(isa, "skx") && SkCpu::Supports(SkCpu::SKX)) {
+            Init_skx();
+            return true;
+        }
+    #endif
+#endif
+        return false;
+    }
+
     void Init() {
         static SkOnce once;
         once(init);
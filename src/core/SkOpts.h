@@ -8,6 +8,7 @@
 #ifndef SkOpts_DEFINED
 #define SkOpts_DEFINED
 
+#include "SkFixed.h"
 #include "SkRasterPipeline.h"
 #include "SkTypes.h"
 #include "SkXfermodePriv.h"
@@ -20,6 +21,12 @@ namespace SkOpts {
     // Called by SkGraphics::Init().
     void Init();
 
+    // For benchmarks comparing instruction sets: points the raster pipeline stage tables at the
+    // stages built for isa ("baseline", "sse41", "avx", "hsw", or "skx"), returning false and
+    // leaving them alone if this build or CPU can't run them.  "native" restores the usual choice.
+    // Not thread safe; nothing may be running a pipeline while the tables change.
+    bool SetRasterPipelineStagesForBenchmarks(const char* isa);
+
     // Declare function pointers here...
 
     // May return nullptr if we haven't specialized the given Mode.
@@ -43,6 +50,11 @@ namespace SkOpts {
                            grayA_to_RGBA,   // i.e. expand to color channels
                            grayA_to_rgbA;   // i.e. expand to color channels and premultiply
 
+    // Accumulates count coverage deltas (count is a multiple of 8) left to right and converts the
+    // resulting coverages to alphas, just like CoverageToAlpha() or ConvexCoverageToAlpha().
+    extern void (*coverage_deltas_to_alpha)(const SkFixed deltas[], SkAlpha alphas[], int count,
+                                            bool isEvenOdd, bool isInverse, bool isConvex);
+
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void SK_API (*memset32)(uint32_t[], uint32_t, int);
     extern void (*memset64)(uint64_t[], uint64_t, int);
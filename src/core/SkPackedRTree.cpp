@@ -0,0 +1,241 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPackedRTree.h"
+
+#include "SkMathPriv.h"
+#include "SkNx.h"
+#include "SkTSort.h"
+
+#include <utility>
+
+static_assert(SkPackedRTree::kFanout == 8, "search() tests the children of a node as an Sk8f.");
+
+namespace {
+
+// Spreads the low 16 bits of x out to the even bits.
+uint32_t interleave(uint32_t x) {
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+// Returns the distance of (x, y) along a Hilbert curve through a 65536 x 65536 grid.
+//
+// Walking the curve a quadrant at a time is simple but branchy and slow, so this computes the
+// orientation of every quadrant at once as a prefix scan over the bits of x and y instead.
+// See "Hilbert curves in O(log(n)) time", rawrunprotected.com (2012).
+uint32_t hilbert_index(uint32_t x, uint32_t y) {
+    uint32_t A, B, C, D;
+    {
+        uint32_t a = x ^ y,
+                 b = 0xFFFF ^ a,
+                 c = 0xFFFF ^ (x | y),
+                 d = x & (y ^ 0xFFFF);
+        A = a | (b >> 1);
+        B = (a >> 1) ^ a;
+        C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+        D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+    }
+    for (int shift = 2; shift <= 8; shift *= 2) {
+        uint32_t a = A, b = B, c = C, d = D;
+        A  = (a & (a >> shift)) ^ (b & (b >> shift));
+        B  = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+        C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+        D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+    }
+    uint32_t a  = C ^ (C >> 1),
+             b  = D ^ (D >> 1),
+             i0 = x ^ y,
+             i1 = b | (0xFFFF ^ (i0 | a));
+    return (interleave(i1) << 1) | interleave(i0);
+}
+
+// Maps v in [min, min + extent] to [0, 65535].
+uint32_t quantize(float v, float min, float extent) {
+    float q = extent > 0 ? (v - min) / extent * 65535 : 0;
+    return (uint32_t)SkTPin(q, 0.0f, 65535.0f);
+}
+
+struct Leaf {
+    uint32_t fHilbertIndex;
+    int      fOpIndex;
+};
+
+// Sorts leaves by their Hilbert index, a byte at a time.  Each pass is stable, so leaves with
+// the same index stay in op order.
+void radix_sort(SkTDArray<Leaf>* leaves) {
+    SkAutoTMalloc<Leaf> scratch(leaves->count());
+    Leaf* src = leaves->begin();
+    Leaf* dst = scratch.get();
+    for (int shift = 0; shift < 32; shift += 8) {
+        int offsets[256] = {0};
+        for (int i = 0; i < leaves->count(); i++) {
+            offsets[(src[i].fHilbertIndex >> shift) & 0xff]++;
+        }
+        for (int i = 0, sum = 0; i < 256; i++) {
+            int count = offsets[i];
+            offsets[i] = sum;
+            sum += count;
+        }
+        for (int i = 0; i < leaves->count(); i++) {
+            dst[offsets[(src[i].fHilbertIndex >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    // An even number of passes leaves the sorted leaves back where they started.
+    SkASSERT(src == leaves->begin());
+}
+
+int round_up_to_fanout(int count) {
+    return (count + SkPackedRTree::kFanout - 1) / SkPackedRTree::kFanout
+                                                * SkPackedRTree::kFanout;
+}
+
+}  // namespace
+
+SkRect SkPackedRTree::getRootBound() const {
+    return fCount ? fRootBound : SkRect::MakeEmpty();
+}
+
+void SkPackedRTree::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(0 == fCount);
+
+    SkTDArray<Leaf> leaves;
+    leaves.setReserve(N);
+    fRootBound.setEmpty();
+    for (int i = 0; i < N; i++) {
+        if (!boundsArray[i].isEmpty()) {
+            leaves.push_back(Leaf{0, i});
+            fRootBound.join(boundsArray[i]);
+        }
+    }
+    fCount = leaves.count();
+    fOpCount = N;
+    if (0 == fCount) {
+        return;
+    }
+
+    // Sort the leaves along the curve through their centers.
+    for (Leaf& leaf : leaves) {
+        const SkRect& bounds = boundsArray[leaf.fOpIndex];
+        leaf.fHilbertIndex = hilbert_index(
+                quantize(bounds.centerX(), fRootBound.fLeft, fRootBound.width()),
+                quantize(bounds.centerY(), fRootBound.fTop,  fRootBound.height()));
+    }
+    radix_sort(&leaves);
+
+    // Each level has an entry for each node of the level below, up to a level of one node.
+    int entries = round_up_to_fanout(fCount);
+    int totalEntries = entries;
+    fLevels.push_back(0);
+    while (entries > kFanout) {
+        entries = round_up_to_fanout(entries / kFanout);
+        fLevels.push_back(totalEntries);
+        totalEntries += entries;
+    }
+    fEntryCount = totalEntries;
+
+    // Padding entries are inverted, so they never intersect anything.
+    fLefts  .reset(totalEntries);
+    fTops   .reset(totalEntries);
+    fRights .reset(totalEntries);
+    fBottoms.reset(totalEntries);
+    for (int i = 0; i < totalEntries; i++) {
+        fLefts[i] = fTops[i] = SK_ScalarInfinity;
+        fRights[i] = fBottoms[i] = SK_ScalarNegativeInfinity;
+    }
+
+    fOpIndices.reset(round_up_to_fanout(fCount));
+    for (int i = 0; i < fCount; i++) {
+        const SkRect& bounds = boundsArray[leaves[i].fOpIndex];
+        fLefts[i]   = bounds.fLeft;
+        fTops[i]    = bounds.fTop;
+        fRights[i]  = bounds.fRight;
+        fBottoms[i] = bounds.fBottom;
+        fOpIndices[i] = leaves[i].fOpIndex;
+    }
+    for (int i = fCount; i < round_up_to_fanout(fCount); i++) {
+        fOpIndices[i] = -1;
+    }
+
+    for (int level = 1; level < fLevels.count(); level++) {
+        const int children = fLevels[level - 1],
+                  nodes    = (fLevels[level] - children) / kFanout;
+        for (int node = 0; node < nodes; node++) {
+            const int first = children + node * kFanout,
+                      entry = fLevels[level] + node;
+            for (int i = first; i < first + kFanout; i++) {
+                fLefts[entry]   = SkTMin(fLefts[entry],   fLefts[i]);
+                fTops[entry]    = SkTMin(fTops[entry],    fTops[i]);
+                fRights[entry]  = SkTMax(fRights[entry],  fRights[i]);
+                fBottoms[entry] = SkTMax(fBottoms[entry], fBottoms[i]);
+            }
+        }
+    }
+}
+
+void SkPackedRTree::search(const SkRect& query, SkTDArray<int>* results) const {
+    if (fCount > 0 && SkRect::Intersects(fRootBound, query)) {
+        const int start = results->count();
+        this->search(fLevels.count() - 1, 0, query, results);
+        // The leaves are in Hilbert order, so put the hits back in op order.  Sorting a few hits
+        // is cheap, but when a query hits a good part of the picture, it's faster to mark each
+        // op that was hit and read them back in order.
+        const int hitCount = results->count() - start;
+        if (hitCount * 32 > fOpCount) {
+            SkAutoSTMalloc<64, uint32_t> hits((fOpCount + 31) / 32);
+            sk_bzero(hits.get(), (fOpCount + 31) / 32 * sizeof(uint32_t));
+            for (int i = start; i < results->count(); i++) {
+                hits[(*results)[i] / 32] |= 1u << ((*results)[i] % 32);
+            }
+            int* result = results->begin() + start;
+            for (int i = 0; i < (fOpCount + 31) / 32; i++) {
+                for (uint32_t word = hits[i]; word; word &= word - 1) {
+                    *result++ = i * 32 + 31 - SkCLZ(word & (~word + 1));
+                }
+            }
+            SkASSERT(result == results->end());
+        } else if (hitCount > 1) {
+            SkTQSort(results->begin() + start, results->end() - 1);
+        }
+    }
+}
+
+void SkPackedRTree::search(int level, int node, const SkRect& query,
+                           SkTDArray<int>* results) const {
+    const int first = fLevels[level] + node * kFanout;
+    // The same test as SkRect::Intersects(), for all the children at once.
+    const Sk8f l = Sk8f::Max(Sk8f::Load(fLefts   + first), Sk8f(query.fLeft)),
+               t = Sk8f::Max(Sk8f::Load(fTops    + first), Sk8f(query.fTop)),
+               r = Sk8f::Min(Sk8f::Load(fRights  + first), Sk8f(query.fRight)),
+               b = Sk8f::Min(Sk8f::Load(fBottoms + first), Sk8f(query.fBottom));
+    const Sk8f hit = (l < r).thenElse(t < b, Sk8f(0));
+    uint32_t hits[kFanout];
+    hit.store(hits);
+    for (int i = 0; i < kFanout; i++) {
+        if (hits[i]) {
+            if (0 == level) {
+                results->push_back(fOpIndices[first + i]);
+            } else {
+                this->search(level - 1, node * kFanout + i, query, results);
+            }
+        }
+    }
+}
+
+size_t SkPackedRTree::bytesUsed() const {
+    size_t byteCount = sizeof(SkPackedRTree);
+
+    byteCount += fEntryCount * 4 * sizeof(float);
+    byteCount += round_up_to_fanout(fCount) * sizeof(int);
+    byteCount += fLevels.reserved() * sizeof(int);
+
+    return byteCount;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPackedRTree_DEFINED
+#define SkPackedRTree_DEFINED
+
+#include "SkBBoxHierarchy.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+
+/**
+ * An R-Tree packed into flat arrays, an alternative to SkRTree for large pictures.
+ *
+ * Like SkRTree, it's bulk loaded, but it sorts the bounds along a Hilbert curve through their
+ * centers first, so that each node holds nearby bounds even when they're recorded out of order.
+ * Every node has kFanout children; the nodes of each level are stored one after another, so the
+ * children of a node are found by index rather than by pointer. The bounds of the children are
+ * stored as separate arrays of lefts, tops, rights and bottoms, so that a search tests a query
+ * against all the children of a node at once with SIMD.
+ *
+ * For more details see:
+ *
+ *  Kamel, I.; Faloutsos, C. (1993). "On packing R-trees"
+ */
+class SkPackedRTree : public SkBBoxHierarchy {
+public:
+    SkPackedRTree() {}
+    ~SkPackedRTree() override {}
+
+    void insert(const SkRect[], int N) override;
+    // As with SkRTree, results are in increasing order.
+    void search(const SkRect& query, SkTDArray<int>* results) const override;
+    size_t bytesUsed() const override;
+
+    SkRect getRootBound() const override;
+
+    // Methods and constants below here are only public for tests.
+
+    // Return the depth of the tree structure.
+    int getDepth() const { return fLevels.count(); }
+    // Insertion count (not overall node count, which may be greater).
+    int getCount() const { return fCount; }
+
+    static const int kFanout = 8;
+
+private:
+    void search(int level, int node, const SkRect& query, SkTDArray<int>* results) const;
+
+    // This is the count of data elements (rather than total nodes in the tree)
+    int fCount = 0;
+    // The count passed to insert(), one more than the largest op index.
+    int fOpCount = 0;
+    SkRect fRootBound = SkRect::MakeEmpty();
+
+    // Where each level's entries start in the bounds arrays, from the leaves up. Each level has
+    // a multiple of kFanout entries; the last one is the root node.
+    SkTDArray<int> fLevels;
+
+    // The bounds of all the entries, and the op index of each leaf.
+    SkAutoTMalloc<float> fLefts, fTops, fRights, fBottoms;
+    SkAutoTMalloc<int>   fOpIndices;
+    size_t               fEntryCount = 0;
+
+    typedef SkBBoxHierarchy INHERITED;
+};
+
+#endif
@@ -7,7 +7,9 @@
 
 #include "SkPicture.h"
 
+#include "SkBigPicture.h"
 #include "SkImageGenerator.h"
+#include "SkMakeUnique.h"
 #include "SkMathPriv.h"
 #include "SkPictureCommon.h"
 #include "SkPictureData.h"
@@ -15,6 +17,8 @@
 #include "SkPicturePriv.h"
 #include "SkPictureRecord.h"
 #include "SkPictureRecorder.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
 #include "SkSerialProcs.h"
 #include "SkTo.h"
 #include <atomic>
@@ -118,7 +122,8 @@ bool SkPicture::BufferIsSKP(SkReadBuffer* buffer, SkPictInfo* pInfo) {
 
 sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
                                         const SkPictureData* data,
-                                        SkReadBuffer* buffer) {
+                                        SkReadBuffer* buffer,
+                                        const SkRect* cullRect) {
     if (!data) {
         return nullptr;
     }
@@ -127,7 +132,20 @@ sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
     }
     SkPicturePlayback playback(data);
     SkPictureRecorder r;
-    playback.draw(r.beginRecording(info.fCullRect), nullptr/*no callback*/, buffer);
+    if (cullRect) {
+        SkRect cull = info.fCullRect;
+        if (!cull.intersect(*cullRect)) {
+            cull.setEmpty();
+        }
+        SkCanvas* canvas = r.beginRecording(cull);
+        if (data->opBBH()) {
+            playback.draw(canvas, *cullRect);
+        } else {
+            playback.draw(canvas, nullptr/*no callback*/, buffer);
+        }
+    } else {
+        playback.draw(r.beginRecording(info.fCullRect), nullptr/*no callback*/, buffer);
+    }
     return r.finishRecordingAsPicture();
 }
 
@@ -135,6 +153,11 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
     return MakeFromStream(stream, procs, nullptr);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkRect& cullRect,
+                                           const SkDeserialProcs* procs) {
+    return MakeFromStream(stream, procs, nullptr, &cullRect);
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs) {
     if (!data) {
@@ -152,8 +175,104 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialPro
     return MakeFromStream(&stream, procs, nullptr);
 }
 
+// Plays back SkPictureData directly, instead of forwardporting it to an SkRecord, so that its
+// op data and images can stay in the mapped data they were read from.
+class SkMappedPicture final : public SkPicture {
+public:
+    SkMappedPicture(const SkRect& cull, std::unique_ptr<SkPictureData> data)
+        : fCullRect(cull)
+        , fData(std::move(data)) {}
+
+    void playback(SkCanvas* canvas, AbortCallback* callback) const override {
+        // Like SkBigPicture, use the BBH unless the query contains the whole picture.
+        const SkRect query = canvas->getLocalClipBounds();
+        if (fData->opBBH() && !callback && !query.contains(fCullRect)) {
+            SkPicturePlayback(fData.get()).draw(canvas, query);
+        } else {
+            SkPicturePlayback(fData.get()).draw(canvas, callback, nullptr);
+        }
+    }
+
+    SkRect cullRect() const override { return fCullRect; }
+
+    int approximateOpCount() const override {
+        int count = fOpCount.load(std::memory_order_relaxed);
+        if (count < 0) {
+            count = CountOps(*fData->opData());
+            fOpCount.store(count, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    size_t approximateBytesUsed() const override {
+        return sizeof(*this) + sizeof(SkPictureData) + fData->opData()->size();
+    }
+
+private:
+    // Hops over the op headers written by SkPictureRecord::addDraw().
+    static int CountOps(const SkData& ops) {
+        const uint32_t* words = (const uint32_t*)ops.data();
+        const size_t wordCount = ops.size() / sizeof(uint32_t);
+        int count = 0;
+        for (size_t i = 0; i < wordCount; ++count) {
+            size_t size = words[i] & MASK_24;
+            if (size == MASK_24) {
+                if (i + 1 >= wordCount) {
+                    break;
+                }
+                // addDraw() adds one to the size of large ops, not the size of the extra word.
+                size = (size_t)words[i + 1] + 3;
+            }
+            if (size < sizeof(uint32_t)) {
+                break;
+            }
+            i += size / sizeof(uint32_t);
+        }
+        return count;
+    }
+
+    const SkRect                         fCullRect;
+    const std::unique_ptr<SkPictureData> fData;
+    mutable std::atomic<int>             fOpCount{-1};
+
+    typedef SkPicture INHERITED;
+};
+
+sk_sp<SkPicture> SkPicture::MakeFromMappedData(sk_sp<SkData> data,
+                                               const SkDeserialProcs* procsPtr) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    SkPictInfo info;
+    if (!StreamIsSKP(&stream, &info)) {
+        return nullptr;
+    }
+    uint8_t trailingStreamByteAfterPictInfo;
+    if (!stream.readU8(&trailingStreamByteAfterPictInfo)) {
+        return nullptr;
+    }
+    if (trailingStreamByteAfterPictInfo != kPictureData_TrailingStreamByteAfterPictInfo ||
+        info.getVersion() < SkReadBuffer::kPadPictureData_Version) {
+        // Custom pictures are up to procs, and older pictures can't be read in place.
+        return MakeFromData(data.get(), procsPtr);
+    }
+
+    SkDeserialProcs procs;
+    if (procsPtr) {
+        procs = *procsPtr;
+    }
+    std::unique_ptr<SkPictureData> pictureData(
+            SkPictureData::CreateFromStream(&stream, info, procs, nullptr, data.get()));
+    if (!pictureData || !pictureData->opData()) {
+        return nullptr;
+    }
+    return sk_make_sp<SkMappedPicture>(info.fCullRect, std::move(pictureData));
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialProcs* procsPtr,
-                                           SkTypefacePlayback* typefaces) {
+                                           SkTypefacePlayback* typefaces,
+                                           const SkRect* cullRect) {
     SkPictInfo info;
     if (!StreamIsSKP(stream, &info)) {
         return nullptr;
@@ -170,7 +289,7 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
         case kPictureData_TrailingStreamByteAfterPictInfo: {
             std::unique_ptr<SkPictureData> data(
                     SkPictureData::CreateFromStream(stream, info, procs, typefaces));
-            return Forwardport(info, data.get(), nullptr);
+            return Forwardport(info, data.get(), nullptr, cullRect);
         }
         case kCustom_TrailingStreamByteAfterPictInfo: {
             int32_t ssize;
@@ -213,13 +332,52 @@ sk_sp<SkPicture> SkPicturePriv::MakeFromBuffer(SkReadBuffer& buffer) {
     return SkPicture::Forwardport(info, data.get(), &buffer);
 }
 
+// Notes where each op of an SkBigPicture starts in the op data it's played back into.
+class OpOffsetRecorder final : public SkPicture::AbortCallback {
+public:
+    explicit OpOffsetRecorder(const SkPictureRecord* rec) : fRec(rec) {}
+
+    bool abort() override {
+        fOffsets.push_back(SkToU32(fRec->writeStream().bytesWritten()));
+        return false;
+    }
+
+    SkTDArray<uint32_t> fOffsets;
+
+private:
+    const SkPictureRecord* fRec;
+};
+
 SkPictureData* SkPicture::backport() const {
     SkPictInfo info = this->createHeader();
     SkPictureRecord rec(SkISize::Make(info.fCullRect.width(), info.fCullRect.height()), 0/*flags*/);
+
+    // Pictures with a BBH carry one for the ops in their data, so readers can cull them.
+    const SkBigPicture* big = this->asSkBigPicture();
+    if (big && !big->bbh()) {
+        big = nullptr;
+    }
+    OpOffsetRecorder offsets(&rec);
+
     rec.beginRecording();
+    if (big) {
+        big->playbackAllOps(&rec, &offsets);
+    } else {
         this->playback(&rec);
+    }
     rec.endRecording();
-    return new SkPictureData(rec, info);
+
+    SkPictureData* data = new SkPictureData(rec, info);
+    if (big) {
+        const SkRecord& record = *big->record();
+        SkAutoTMalloc<SkRect> bounds(record.count());
+        SkRecordFillBounds(info.fCullRect, record, bounds);
+        std::unique_ptr<SkRTree> bbh = skstd::make_unique<SkRTree>(
+                info.fCullRect.width() / info.fCullRect.height());
+        bbh->insert(bounds, record.count());
+        data->setOpBBH(std::move(bbh), std::move(offsets.fOffsets));
+    }
+    return data;
 }
 
 void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procs) const {
@@ -7,7 +7,6 @@
 
 #include "SkPictureData.h"
 
-#include "SkAutoMalloc.h"
 #include "SkImageGenerator.h"
 #include "SkMakeUnique.h"
 #include "SkPictureRecord.h"
@@ -93,6 +92,18 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// Pads the stream so that the data of the next tag starts 4-byte aligned, as SkReadBuffer needs
+// it to be. A picture read from memory, like a mapped file, can then be read in place. Tags and
+// sizes are 4 bytes, so it's enough to align where the next tag starts.
+static void write_pad_for_next_tag(SkWStream* stream) {
+    size_t pad = (0 - stream->bytesWritten()) & 3;
+    if (pad) {
+        static const char kZeros[4] = {0, 0, 0, 0};
+        write_tag_size(stream, SK_PICT_PAD_TAG, pad);
+        stream->write(kZeros, pad);
+    }
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -199,9 +210,18 @@ static SkSerialProcs skip_typeface_proc(const SkSerialProcs& procs) {
 void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
                               SkRefCntSet* topLevelTypeFaceSet) const {
     // This can happen at pretty much any time, so might as well do it first.
+    write_pad_for_next_tag(stream);
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
+    if (fOpBBH) {
+        SkBinaryWriteBuffer bbh;
+        bbh.writeIntArray((const int32_t*)fOpOffsets.begin(), fOpOffsets.count());
+        fOpBBH->flatten(bbh);
+        write_tag_size(stream, SK_PICT_BBH_TAG, bbh.bytesWritten());
+        bbh.writeToStream(stream);
+    }
+
     // We serialize all typefaces into the typeface section of the top-level picture.
     SkRefCntSet localTypefaceSet;
     SkRefCntSet* typefaceSet = topLevelTypeFaceSet ? topLevelTypeFaceSet : &localTypefaceSet;
@@ -238,6 +258,7 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     }
 
     // Write the buffer.
+    write_pad_for_next_tag(stream);
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
@@ -277,6 +298,25 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Returns the next size bytes of the stream. If they are 4-byte aligned and in mapped, they are
+// shared with it instead of copied, and shared is set.
+static sk_sp<SkData> share_or_copy_from_stream(SkStream* stream, size_t size,
+                                               const SkData* mapped, bool* shared = nullptr) {
+    const char* base = (const char*)stream->getMemoryBase();
+    if (mapped && base && stream->hasPosition()) {
+        const char* bytes = base + stream->getPosition();
+        const char* begin = (const char*)mapped->data();
+        if (bytes >= begin && size <= (size_t)(begin + mapped->size() - bytes) &&
+            SkIsAlign4((uintptr_t)bytes) && stream->skip(size) == size) {
+            if (shared) {
+                *shared = true;
+            }
+            return SkData::MakeSubset(mapped, bytes - begin, size);
+        }
+    }
+    return SkData::MakeFromStream(stream, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
@@ -285,11 +325,49 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            fOpData = share_or_copy_from_stream(stream, size, fMappedData);
             if (!fOpData) {
                 return false;
             }
             break;
+        case SK_PICT_PAD_TAG:
+            if (fInfo.getVersion() < SkReadBuffer::kPadPictureData_Version ||
+                size > 3 || stream->skip(size) != size) {
+                return false;
+            }
+            break;
+        case SK_PICT_BBH_TAG: {
+            // The offsets are checked against the op data, so it must come first.
+            if (fInfo.getVersion() < SkReadBuffer::kSerializeBBH_Version || !fOpData || fOpBBH) {
+                return false;
+            }
+            sk_sp<SkData> storage = SkData::MakeFromStream(stream, size);
+            if (!storage) {
+                return false;
+            }
+            SkReadBuffer buffer(storage->data(), size);
+            buffer.setVersion(fInfo.getVersion());
+            const uint32_t count = buffer.getArrayCount();
+            if (!buffer.validateCanReadN<int32_t>(count)) {
+                return false;
+            }
+            fOpOffsets.setCount(count);
+            if (!buffer.readIntArray((int32_t*)fOpOffsets.begin(), count)) {
+                return false;
+            }
+            uint32_t prev = 0;
+            for (uint32_t offset : fOpOffsets) {
+                if (!buffer.validate(offset >= prev && offset <= fOpData->size() &&
+                                     SkIsAlign4(offset))) {
+                    return false;
+                }
+                prev = offset;
+            }
+            fOpBBH = SkRTree::MakeFromBuffer(buffer, count);
+            if (!fOpBBH) {
+                return false;
+            }
+        } break;
         case SK_PICT_FACTORY_TAG: {
             if (!stream->readU32(&size)) { return false; }
             fFactoryPlayback = skstd::make_unique<SkFactoryPlayback>(size);
@@ -329,13 +407,18 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            bool shared = false;
+            sk_sp<SkData> storage = share_or_copy_from_stream(stream, size, fMappedData, &shared);
+            if (!storage) {
                 return false;
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(storage->data(), size);
             buffer.setVersion(fInfo.getVersion());
+            if (shared) {
+                // Images can refer to their encoded data in place, too.
+                buffer.setBackingData(std::move(storage));
+            }
 
             if (!fFactoryPlayback) {
                 return false;
@@ -467,13 +550,17 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkData* mapped) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, procs, topLevelTFPlayback)) {
+    data->fMappedData = mapped;
+    bool parsed = data->parseStream(stream, procs, topLevelTFPlayback);
+    data->fMappedData = nullptr;
+    if (!parsed) {
         return nullptr;
     }
     return data.release();
@@ -12,7 +12,9 @@
 #include "SkDrawable.h"
 #include "SkPicture.h"
 #include "SkPictureFlat.h"
+#include "SkRTree.h"
 #include "SkTArray.h"
+#include "SkTDArray.h"
 
 #include <memory>
 
@@ -65,6 +67,12 @@ public:
 #define SK_PICT_VERTICES_BUFFER_TAG SkSetFourByteTag('v', 'e', 'r', 't')
 #define SK_PICT_IMAGE_BUFFER_TAG    SkSetFourByteTag('i', 'm', 'a', 'g')
 
+// Zero bytes that align the op data and buffer of streamed pictures, so they can be read in place.
+#define SK_PICT_PAD_TAG     SkSetFourByteTag('p', 'a', 'd', ' ')
+
+// The BBH of the ops of streamed pictures that have one, and where each op starts in the op data.
+#define SK_PICT_BBH_TAG     SkSetFourByteTag('b', 'b', 'h', ' ')
+
 // Always write this guy last (with no length field afterwards)
 #define SK_PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
 
@@ -77,11 +85,13 @@ T* read_index_base_1_or_null(SkReadBuffer* reader, const SkTArray<sk_sp<T>>& arr
 class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
-    // Does not affect ownership of SkStream.
+    // Does not affect ownership of SkStream. If the stream reads from mapped, the op data and
+    // encoded images share it instead of being copied.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
-                                           SkTypefacePlayback*);
+                                           SkTypefacePlayback*,
+                                           const SkData* mapped = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*) const;
@@ -89,6 +99,15 @@ public:
 
     const sk_sp<SkData>& opData() const { return fOpData; }
 
+    // If the picture this was made from has a BBH, the SkRecord ops it indexes start at these
+    // offsets in the op data. Each op runs until the next one starts; some may be empty.
+    void setOpBBH(std::unique_ptr<SkRTree> bbh, SkTDArray<uint32_t> opOffsets) {
+        fOpBBH = std::move(bbh);
+        fOpOffsets = std::move(opOffsets);
+    }
+    const SkRTree* opBBH() const { return fOpBBH.get(); }
+    const SkTDArray<uint32_t>& opOffsets() const { return fOpOffsets; }
+
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
@@ -146,6 +165,8 @@ private:
     SkTArray<SkPath>   fPaths;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
+    std::unique_ptr<SkRTree> fOpBBH;
+    SkTDArray<uint32_t>      fOpOffsets;
 
     const SkPath    fEmptyPath;
     const SkBitmap  fEmptyBitmap;
@@ -159,6 +180,9 @@ private:
     SkTypefacePlayback                 fTFPlayback;
     std::unique_ptr<SkFactoryPlayback> fFactoryPlayback;
 
+    // The data being parsed, if the picture is read in place from it.
+    const SkData* fMappedData = nullptr;
+
     const SkPictInfo fInfo;
 
     static void WriteFactories(SkWStream* stream, const SkFactorySet& rec);
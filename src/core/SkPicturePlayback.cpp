@@ -103,6 +103,44 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
     }
 }
 
+void SkPicturePlayback::draw(SkCanvas* canvas, const SkRect& query) {
+    SkASSERT(fPictureData->opBBH());
+    AutoResetOpID aroi(this);
+    SkASSERT(0 == fCurOffset);
+
+    SkTDArray<int> ops;
+    fPictureData->opBBH()->search(query, &ops);
+    const SkTDArray<uint32_t>& offsets = fPictureData->opOffsets();
+    const size_t opDataSize = fPictureData->opData()->size();
+
+    SkReadBuffer reader(fPictureData->opData()->bytes(), opDataSize);
+    SkMatrix initialMatrix = canvas->getTotalMatrix();
+    SkAutoCanvasRestore acr(canvas, false);
+
+    for (int index : ops) {
+        size_t start = offsets[index],
+               stop  = index + 1 < offsets.count() ? offsets[index + 1] : opDataSize;
+        // A clip that emptied the canvas may have skipped ahead to its restore, past this op.
+        start = SkTMax(start, reader.offset());
+        if (start >= stop) {
+            continue;
+        }
+        reader.skip(start - reader.offset());
+        while (reader.isValid() && reader.offset() < stop) {
+            fCurOffset = reader.offset();
+            uint32_t size;
+            DrawType op = ReadOpAndSize(&reader, &size);
+            if (!reader.validate(op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
+                return;
+            }
+            this->handleOp(&reader, op, size, canvas, initialMatrix);
+        }
+        if (!reader.isValid()) {
+            return;
+        }
+    }
+}
+
 static void validate_offsetToRestore(SkReadBuffer* reader, size_t offsetToRestore) {
     if (offsetToRestore) {
         reader->validate(SkIsAlign4(offsetToRestore) && offsetToRestore >= reader->offset());
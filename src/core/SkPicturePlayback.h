@@ -25,6 +25,9 @@ public:
 
     void draw(SkCanvas* canvas, SkPicture::AbortCallback*, SkReadBuffer* buffer);
 
+    // Draws only the ops that the picture data's BBH finds in query. The data must have a BBH.
+    void draw(SkCanvas* canvas, const SkRect& query);
+
     // TODO: remove the curOp calls after cleaning up GrGatherDevice
     // Return the ID of the operation currently being executed when playing
     // back. 0 indicates no call is active.
@@ -7,6 +7,12 @@
 
 #include "SkRTree.h"
 
+#include "SkMakeUnique.h"
+#include "SkReadBuffer.h"
+#include "SkWriteBuffer.h"
+
+#include <vector>
+
 SkRTree::SkRTree(SkScalar aspectRatio)
     : fCount(0), fAspectRatio(isfinite(aspectRatio) ? aspectRatio : 1) {}
 
@@ -187,3 +193,107 @@ size_t SkRTree::bytesUsed() const {
 
     return byteCount;
 }
+
+void SkRTree::flatten(SkWriteBuffer& buffer) const {
+    buffer.writeInt(fCount);
+    buffer.writeScalar(fAspectRatio);
+    if (0 == fCount) {
+        return;
+    }
+    // Subtrees are written as indices into fNodes.
+    buffer.writeInt(fNodes.count());
+    buffer.writeRect(fRoot.fBounds);
+    buffer.writeInt(SkToInt(fRoot.fSubtree - fNodes.begin()));
+    for (const Node& node : fNodes) {
+        buffer.writeUInt(node.fLevel);
+        buffer.writeUInt(node.fNumChildren);
+        for (int i = 0; i < node.fNumChildren; ++i) {
+            const Branch& child = node.fChildren[i];
+            buffer.writeRect(child.fBounds);
+            buffer.writeInt(0 == node.fLevel ? child.fOpIndex
+                                             : SkToInt(child.fSubtree - fNodes.begin()));
+        }
+    }
+}
+
+std::unique_ptr<SkRTree> SkRTree::MakeFromBuffer(SkReadBuffer& buffer, int opCount) {
+    // Each level has at least kMinChildren times fewer nodes than the one below, except the top.
+    static const uint32_t kMaxLevels = 32;
+
+    const int count = buffer.readInt();
+    std::unique_ptr<SkRTree> tree = skstd::make_unique<SkRTree>(buffer.readScalar());
+    if (!buffer.validate(count >= 0)) {
+        return nullptr;
+    }
+    if (0 == count) {
+        return tree;
+    }
+
+    const int nodeCount = buffer.readInt();
+    buffer.readRect(&tree->fRoot.fBounds);
+    const int root = buffer.readInt();
+    // A node takes at least seven ints: its level, child count, and one child.
+    if (!buffer.validate(nodeCount > 0 && root >= 0 && root < nodeCount) ||
+        !buffer.validateCanReadN<int32_t>(7 * (size_t)nodeCount)) {
+        return nullptr;
+    }
+
+    tree->fNodes.setCount(nodeCount);
+    for (Node& node : tree->fNodes) {
+        const uint32_t level = buffer.readUInt(),
+                       numChildren = buffer.readUInt();
+        if (!buffer.validate(level < kMaxLevels &&
+                             numChildren > 0 && numChildren <= (uint32_t)kMaxChildren)) {
+            return nullptr;
+        }
+        node.fLevel = SkToU16(level);
+        node.fNumChildren = SkToU16(numChildren);
+        for (int i = 0; i < node.fNumChildren; ++i) {
+            buffer.readRect(&node.fChildren[i].fBounds);
+            node.fChildren[i].fOpIndex = buffer.readInt();
+        }
+    }
+    if (!buffer.isValid()) {
+        return nullptr;
+    }
+
+    // Now point branches at their subtrees. Each subtree is one level down, so searches end, and
+    // has a single parent, so they visit each node once.
+    std::vector<bool> referenced(nodeCount);
+    int leaves = 0;
+    uint16_t maxLevel = 0;
+    for (Node& node : tree->fNodes) {
+        maxLevel = SkTMax(maxLevel, node.fLevel);
+        if (0 == node.fLevel) {
+            leaves += node.fNumChildren;
+        }
+        for (int i = 0; i < node.fNumChildren; ++i) {
+            Branch& child = node.fChildren[i];
+            const int index = child.fOpIndex;
+            if (0 == node.fLevel) {
+                if (!buffer.validate(index >= 0 && index < opCount)) {
+                    return nullptr;
+                }
+            } else {
+                if (!buffer.validate(index >= 0 && index < nodeCount && !referenced[index] &&
+                                     tree->fNodes[index].fLevel + 1 == node.fLevel)) {
+                    return nullptr;
+                }
+                referenced[index] = true;
+                child.fSubtree = &tree->fNodes[index];
+            }
+        }
+    }
+    // Every node but the root hangs off exactly one other, so they're all part of the tree.
+    for (int i = 0; i < nodeCount; ++i) {
+        if (!buffer.validate(referenced[i] == (i != root))) {
+            return nullptr;
+        }
+    }
+    if (!buffer.validate(tree->fNodes[root].fLevel == maxLevel && leaves == count)) {
+        return nullptr;
+    }
+    tree->fRoot.fSubtree = &tree->fNodes[root];
+    tree->fCount = count;
+    return tree;
+}
@@ -12,6 +12,11 @@
 #include "SkRect.h"
 #include "SkTDArray.h"
 
+#include <memory>
+
+class SkReadBuffer;
+class SkWriteBuffer;
+
 /**
  * An R-Tree implementation. In short, it is a balanced n-ary tree containing a hierarchy of
  * bounding rectangles.
@@ -54,6 +59,12 @@ public:
     // Get the root bound.
     SkRect getRootBound() const override;
 
+    // Writes the tree, so that MakeFromBuffer() can read it back without bulk loading it again.
+    void flatten(SkWriteBuffer&) const;
+
+    // Returns null if the buffer doesn't hold a tree whose op indices are less than opCount.
+    static std::unique_ptr<SkRTree> MakeFromBuffer(SkReadBuffer&, int opCount);
+
     // These values were empirically determined to produce reasonable performance in most cases.
     static const int kMinChildren = 6,
                      kMaxChildren = 11;
@@ -9,6 +9,8 @@
 #include "SkOpts.h"
 #include <algorithm>
 
+std::atomic<bool> gSkFuseRasterPipelineStages{true};
+
 SkRasterPipeline::SkRasterPipeline(SkArenaAlloc* alloc) : fAlloc(alloc) {
     this->reset();
 }
@@ -27,6 +29,30 @@ void SkRasterPipeline::append(StockStage stage, void* ctx) {
     this->unchecked_append(stage, ctx);
 }
 void SkRasterPipeline::unchecked_append(StockStage stage, void* ctx) {
+    // Pairs of adjacent stages we replace with a single fused stage as they're appended, saving a
+    // stage call (and passing every register along) per pixel.  At most one stage of each pair
+    // takes a context, and the fused stage takes that one.  Roughly most common first.
+    static const struct {
+        StockStage first, second, fused;
+    } kFusedStages[] = {
+        { swap_rb,       store_8888,  store_bgra    },
+        { load_8888_dst, swap_rb_dst, load_bgra_dst },
+        { load_8888,     swap_rb,     load_bgra     },
+        { gather_8888,   swap_rb,     gather_bgra   },
+    };
+    if (gSkFuseRasterPipelineStages && fStages && !fStages->rawFunction) {
+        for (const auto& f : kFusedStages) {
+            if (fStages->stage == (uint64_t)f.first && stage == f.second) {
+                SkASSERT(!fStages->ctx || !ctx);
+                fStages->stage = (uint64_t)f.fused;
+                if (ctx) {
+                    fStages->ctx  = ctx;
+                    fSlotsNeeded += 1;
+                }
+                return;
+            }
+        }
+    }
     fStages = fAlloc->make<StageList>( StageList{fStages, (uint64_t) stage, ctx, false} );
     fNumStages   += 1;
     fSlotsNeeded += ctx ? 2 : 1;
@@ -259,6 +285,8 @@ void SkRasterPipeline::append_gamut_clamp_if_normalized(const SkImageInfo& dstIn
     }
 }
 
+// We don't cache built programs.  Building one is a table lookup per stage, about 25ns for an
+// eight stage pipeline, less than it costs to key and look one up in a cache.
 SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) const {
     // We'll try to build a lowp pipeline, but if that fails fallback to a highp float pipeline.
     void** reset_point = ip;
@@ -14,6 +14,7 @@
 #include "SkNx.h"
 #include "SkTArray.h" // TODO: unused
 #include "SkTypes.h"
+#include <atomic>
 #include <functional>
 #include <vector>  // TODO: unused
 
@@ -48,6 +49,7 @@
     M(load_f16)  M(load_f16_dst)  M(store_f16)  M(gather_f16)      \
     M(load_f32)  M(load_f32_dst)  M(store_f32)  M(gather_f32)      \
     M(load_8888) M(load_8888_dst) M(store_8888) M(gather_8888)     \
+    M(load_bgra) M(load_bgra_dst) M(store_bgra) M(gather_bgra)     \
     M(load_1010102) M(load_1010102_dst) M(store_1010102) M(gather_1010102) \
     M(alpha_to_gray) M(alpha_to_gray_dst) M(luminance_to_alpha)    \
     M(bilerp_clamp_8888)                                           \
@@ -95,6 +97,10 @@
     M(gauss_a_to_rgba)                                             \
     M(emboss)
 
+// When true (the default), SkRasterPipeline fuses some common pairs of stages as they're appended,
+// e.g. load_8888 then swap_rb into load_bgra.  Benchmarks turn this off to measure the difference.
+extern std::atomic<bool> gSkFuseRasterPipelineStages;
+
 // The largest number of pixels we handle at a time.
 static const int SkRasterPipeline_kMaxStride = 16;
 
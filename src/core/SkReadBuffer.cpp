@@ -319,10 +319,21 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
         return nullptr;
     }
 
-    sk_sp<SkData> data = SkData::MakeUninitialized(size);
-    if (!this->readPad32(data->writable_data(), size)) {
-        this->validate(false);
-        return nullptr;
+    sk_sp<SkData> data;
+    const char* base = fBackingData ? (const char*)fBackingData->data() : nullptr;
+    const char* curr = (const char*)fReader.peek();
+    if (base && curr >= base && curr + size <= base + fBackingData->size()) {
+        // Share the encoded bytes with the buffer's backing data, e.g. a mapped file.
+        if (!this->skip(size)) {
+            return nullptr;
+        }
+        data = SkData::MakeSubset(fBackingData.get(), curr - base, size);
+    } else {
+        data = SkData::MakeUninitialized(size);
+        if (!this->readPad32(data->writable_data(), size)) {
+            this->validate(false);
+            return nullptr;
+        }
     }
     if (this->isVersionLT(kDontNegateImageSize_Version)) {
         (void)this->read32();   // originX
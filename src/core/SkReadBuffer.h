@@ -9,6 +9,7 @@
 #define SkReadBuffer_DEFINED
 
 #include "SkColorFilter.h"
+#include "SkData.h"
 #include "SkSerialProcs.h"
 #include "SkDrawLooper.h"
 #include "SkFont.h"
@@ -23,7 +24,6 @@
 #include "SkShaderBase.h"
 #include "SkWriteBuffer.h"
 
-class SkData;
 class SkImage;
 
 #ifndef SK_DISABLE_READBUFFER
@@ -47,6 +47,8 @@ public:
         kSaveBehind_Version                = 66,
         kSerializeFonts_Version            = 67,
         kPaintDoesntSerializeFonts_Version = 68,
+        kPadPictureData_Version            = 69,
+        kSerializeBBH_Version              = 70,
     };
 
     /**
@@ -166,6 +168,12 @@ public:
     }
 
     void setDeserialProcs(const SkDeserialProcs& procs);
+
+    /**
+     *  Tells the buffer that its memory is owned by data, so that encoded images can share it
+     *  instead of being copied out.
+     */
+    void setBackingData(sk_sp<SkData> data) { fBackingData = std::move(data); }
     const SkDeserialProcs& getDeserialProcs() const { return fProcs; }
 
     /**
@@ -226,6 +234,7 @@ private:
     int                     fFactoryCount;
 
     SkDeserialProcs fProcs;
+    sk_sp<SkData>   fBackingData;
 
     static bool IsPtrAlign4(const void* ptr) {
         return SkIsAlign4((uintptr_t)ptr);
@@ -255,6 +264,8 @@ public:
         kSaveBehind_Version                = 66,
         kSerializeFonts_Version            = 67,
         kPaintDoesntSerializeFonts_Version = 68,
+        kPadPictureData_Version            = 69,
+        kSerializeBBH_Version              = 70,
     };
 
     bool isVersionLT(Version) const { return false; }
@@ -339,6 +350,7 @@ public:
     void setTypefaceArray(sk_sp<SkTypeface>[], int)        {}
     void setFactoryPlayback(SkFlattenable::Factory[], int) {}
     void setDeserialProcs(const SkDeserialProcs&)          {}
+    void setBackingData(sk_sp<SkData>)                     {}
 
     const SkDeserialProcs& getDeserialProcs() const {
         static const SkDeserialProcs procs;
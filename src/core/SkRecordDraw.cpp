@@ -128,6 +128,7 @@ DRAW(DrawPicture, drawPicture(r.picture.get(), &r.matrix, r.paint));
 DRAW(DrawPoints, drawPoints(r.mode, r.count, r.pts, r.paint));
 DRAW(DrawRRect, drawRRect(r.rrect, r.paint));
 DRAW(DrawRect, drawRect(r.rect, r.paint));
+DRAW(DrawRects, experimental_DrawRectsV1(r.rects, r.colors, r.count, r.paint));
 DRAW(DrawEdgeAARect, experimental_DrawEdgeAARectV1(r.rect, r.aa, r.color, r.mode));
 DRAW(DrawRegion, drawRegion(r.region, r.paint));
 DRAW(DrawTextBlob, drawTextBlob(r.blob.get(), r.x, r.y, r.paint));
@@ -362,6 +363,13 @@ private:
     Bounds bounds(const NoOp&)  const { return Bounds::MakeEmpty(); }    // NoOps don't draw.
 
     Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
+    Bounds bounds(const DrawRects& op) const {
+        // Bound the corners, so rects with no area but a stroke count too.
+        const SkRect* rects = op.rects;
+        SkRect rect;
+        rect.set(reinterpret_cast<const SkPoint*>(rects), 2 * op.count);
+        return this->adjustAndMap(rect, &op.paint);
+    }
     Bounds bounds(const DrawEdgeAARect& op) const { return this->adjustAndMap(op.rect, nullptr); }
 
     Bounds bounds(const DrawRegion& op) const {
@@ -8,8 +8,10 @@
 #include "SkRecordOpts.h"
 
 #include "SkCanvasPriv.h"
+#include "SkColorFilter.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
 
 using namespace SkRecords;
@@ -289,6 +291,430 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Reads the matrix a Concat or Translate concatenates.
+struct ConcatMatrix {
+    SkMatrix operator()(const Concat& op)    { return op.matrix; }
+    SkMatrix operator()(const Translate& op) { return SkMatrix::MakeTrans(op.dx, op.dy); }
+
+    template <typename T>
+    SkMatrix operator()(const T&) { return SkMatrix::I(); }
+};
+
+// Concat-[NoOp]*-Concat concatenates the same matrix as one Concat of their product, and a
+// Concat followed by a SetMatrix does nothing at all.  Translates are Concats too.  The folded
+// matrix can round a little differently than concatenating the two one at a time.
+struct ConcatMerger {
+    typedef Pattern<Or<Is<Concat>, Is<Translate>>,
+                    Greedy<Is<NoOp>>,
+                    Or<Is<Concat>, Is<Translate>, Is<SetMatrix>>>
+        Match;
+
+    bool onMatch(SkRecord* record, Match*, int begin, int end) {
+        Is<SetMatrix> isSetMatrix;
+        if (record->mutate(end-1, isSetMatrix)) {
+            record->replace<NoOp>(begin);
+            fCount += 1;
+            return true;
+        }
+
+        Is<Translate> first, last;
+        const bool translates = record->mutate(begin, first) && record->mutate(end-1, last);
+        const SkMatrix matrix = SkMatrix::Concat(record->visit(begin, ConcatMatrix()),
+                                                 record->visit(end-1, ConcatMatrix()));
+        const SkScalar dx = translates ? first.get()->dx + last.get()->dx : 0,
+                       dy = translates ? first.get()->dy + last.get()->dy : 0;
+
+        record->replace<NoOp>(begin);
+        if (translates ? (0 == dx && 0 == dy) : matrix.isIdentity()) {
+            record->replace<NoOp>(end-1);
+            fCount += 2;
+            return true;
+        }
+        // Translates stay Translates, which are cheaper to play back.
+        if (translates) {
+            new (record->replace<Translate>(end-1)) Translate{dx, dy};
+        } else {
+            new (record->replace<Concat>(end-1)) Concat{matrix};
+        }
+        fCount += 1;
+        return true;
+    }
+
+    int fCount = 0;
+};
+
+int SkRecordMergeMatrices(SkRecord* record) {
+    ConcatMerger pass;
+    // Each match folds a pair; run until the chains are down to one command.
+    while (apply(&pass, record));
+    return pass.fCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Draws don't change the clip, so a ClipRect that contains the ClipRect before it, with only
+// draws between them, can't shrink the clip.  Both clips have to be hard-edged: intersecting an
+// antialiased clip multiplies in the coverage of its edge, even when it contains the clip.
+struct RedundantClipRectNooper {
+    typedef Pattern<Is<ClipRect>,
+                    Greedy<Or<Is<NoOp>, IsDraw>>,
+                    Is<ClipRect>>
+        Match;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        const ClipRect* first = match->first<ClipRect>();
+        const ClipRect* last  = match->third<ClipRect>();
+        if (first->opAA.aa() || first->opAA.op() != SkClipOp::kIntersect ||
+             last->opAA.aa() ||  last->opAA.op() != SkClipOp::kIntersect ||
+            !last->rect.contains(first->rect)) {
+            return false;
+        }
+        record->replace<NoOp>(end-1);
+        fCount += 1;
+        return true;
+    }
+
+    int fCount = 0;
+};
+
+int SkRecordNoopRedundantClips(SkRecord* record) {
+    RedundantClipRectNooper pass;
+    // The search picks up after each match, so it takes another pass to compare the first
+    // ClipRect with the one after the one we no-opped.
+    while (apply(&pass, record));
+    return pass.fCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Does paint draw just the pixels of its geometry, with no antialiasing or effects that might
+// grow, shrink or soften them?
+static bool hard_edged_fill(const SkPaint* paint) {
+    return !paint || (!paint->isAntiAlias()                      &&
+                      paint->getStyle() == SkPaint::kFill_Style &&
+                      !paint->getPathEffect()                   &&
+                      !paint->getMaskFilter()                   &&
+                      !paint->getImageFilter()                  &&
+                      !paint->getLooper());
+}
+
+// Does paint replace every pixel it draws, whatever was there before?
+static bool replaces_dst(const SkPaint& paint) {
+    if (paint.getMaskFilter() || paint.getImageFilter() || paint.getLooper()) {
+        return false;
+    }
+    switch (paint.getBlendMode()) {
+        case SkBlendMode::kClear:
+        case SkBlendMode::kSrc:
+            return true;
+        case SkBlendMode::kSrcOver: {
+            const SkColorFilter* colorFilter = paint.getColorFilter();
+            return 0xFF == paint.getAlpha()                                &&
+                   (!paint.getShader() || paint.getShader()->isOpaque())   &&
+                   (!colorFilter ||
+                    (colorFilter->getFlags() & SkColorFilter::kAlphaUnchanged_Flag));
+        }
+        default:
+            return false;
+    }
+}
+
+namespace {
+
+// What a command means to CoveredDrawNooper.
+struct Coverage {
+    enum Kind {
+        kNoOp,      // Skipped over.
+        kDraw,      // A draw that a later one may hide.
+        kBarrier,   // Anything else: it may change the clip or matrix, or mustn't be hidden.
+    };
+    enum Covers {
+        kNothing,
+        kClip,      // Every pixel in the clip.
+        kRect,      // The pixels whose centers fRect contains.
+    };
+
+    Kind   fKind      = kBarrier;
+    Covers fCovers    = kNothing;
+    // A hard-edged rect touches the pixels whose centers it contains, so it's hidden by any
+    // kRect coverage whose rect contains it.
+    bool   fHardRect  = false;
+    SkRect fRect      = SkRect::MakeEmpty();
+
+    static Coverage Make(Kind kind) {
+        Coverage coverage;
+        coverage.fKind = kind;
+        return coverage;
+    }
+};
+
+struct FindCoverage {
+    Coverage operator()(const NoOp&) { return Coverage::Make(Coverage::kNoOp); }
+
+    // Pictures and drawables may annotate, and DrawBehind draws under what's there.
+    Coverage operator()(const DrawPicture&)  { return Coverage::Make(Coverage::kBarrier); }
+    Coverage operator()(const DrawDrawable&) { return Coverage::Make(Coverage::kBarrier); }
+    Coverage operator()(const DrawBehind&)   { return Coverage::Make(Coverage::kBarrier); }
+
+    Coverage operator()(const DrawPaint& op) {
+        Coverage coverage = Coverage::Make(Coverage::kDraw);
+        if (replaces_dst(op.paint) && !op.paint.getPathEffect()) {
+            coverage.fCovers = Coverage::kClip;
+        }
+        return coverage;
+    }
+
+    Coverage operator()(const DrawRect& op) {
+        Coverage coverage = Coverage::Make(Coverage::kDraw);
+        if (hard_edged_fill(&op.paint)) {
+            coverage.fHardRect = true;
+            coverage.fRect = op.rect;
+            if (replaces_dst(op.paint)) {
+                coverage.fCovers = Coverage::kRect;
+            }
+        }
+        return coverage;
+    }
+
+    Coverage operator()(const DrawImageRect& op) {
+        Coverage coverage = Coverage::Make(Coverage::kDraw);
+        if (hard_edged_fill(op.paint)) {
+            coverage.fHardRect = true;
+            coverage.fRect = op.dst;
+        }
+        return coverage;
+    }
+
+    template <typename T>
+    SK_WHEN(T::kTags & kDraw_Tag, Coverage) operator()(const T&) {
+        return Coverage::Make(Coverage::kDraw);
+    }
+
+    template <typename T>
+    SK_WHEN(!(T::kTags & kDraw_Tag), Coverage) operator()(const T&) {
+        return Coverage::Make(Coverage::kBarrier);
+    }
+};
+
+// Tracks whether an antialiased clip is in effect.
+struct AAClipTracker {
+    void operator()(const Save&)         { fSaved.push_back(fAA); }
+    void operator()(const SaveBehind&)   { fSaved.push_back(fAA); }
+    void operator()(const SaveLayer& op) {
+        fSaved.push_back(fAA);
+        fAA = fAA || op.clipMask;
+    }
+    void operator()(const Restore&) {
+        if (!fSaved.isEmpty()) {
+            fAA = fSaved.top();
+            fSaved.pop();
+        }
+    }
+    void operator()(const ClipPath& op)  { fAA = fAA || op.opAA.aa(); }
+    void operator()(const ClipRRect& op) { fAA = fAA || op.opAA.aa(); }
+    void operator()(const ClipRect& op)  { fAA = fAA || op.opAA.aa(); }
+
+    template <typename T>
+    void operator()(const T&) {}
+
+    SkTDArray<bool> fSaved;
+    bool            fAA = false;
+};
+
+}  // namespace
+
+// A draw can't show through a later draw that replaces every pixel it touched, as long as only
+// draws come between them to leave the clip and matrix alone.  Where an antialiased clip covers
+// part of a pixel, though, each draw only blends into it, so draws under one aren't hidden.
+// That's only known for the record's own clips; callers promise a hard clip at playback.
+int SkRecordNoopCoveredDraws(SkRecord* record) {
+    struct Hideable {
+        int    fIndex;
+        bool   fHardRect;
+        SkRect fRect;
+    };
+    // Look back over only so many draws, to keep this linear.
+    static const int kMaxHideable = 256;
+
+    SkTDArray<Hideable> hideable;
+    AAClipTracker clip;
+    int count = 0;
+    for (int i = 0; i < record->count(); i++) {
+        record->visit(i, clip);
+        const Coverage coverage = record->visit(i, FindCoverage());
+        if (Coverage::kBarrier == coverage.fKind || clip.fAA) {
+            hideable.rewind();
+            continue;
+        }
+        if (Coverage::kNoOp == coverage.fKind) {
+            continue;
+        }
+
+        if (Coverage::kClip == coverage.fCovers) {
+            for (const Hideable& draw : hideable) {
+                record->replace<NoOp>(draw.fIndex);
+            }
+            count += hideable.count();
+            hideable.rewind();
+        } else if (Coverage::kRect == coverage.fCovers) {
+            int kept = 0;
+            for (const Hideable& draw : hideable) {
+                if (draw.fHardRect && coverage.fRect.contains(draw.fRect)) {
+                    record->replace<NoOp>(draw.fIndex);
+                    count++;
+                } else {
+                    hideable[kept++] = draw;
+                }
+            }
+            hideable.setCount(kept);
+        }
+
+        if (hideable.count() == kMaxHideable) {
+            hideable.remove(0);
+        }
+        hideable.push_back(Hideable{i, coverage.fHardRect, coverage.fRect});
+    }
+    return count;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Loopers and image filters apply to a whole batch at once, not to each of its draws.
+static bool can_batch(const SkPaint* paint) {
+    return !paint || (!paint->getLooper() && !paint->getImageFilter());
+}
+
+// Does a draw with paint b draw the same as one with paint a, but for its color?
+static bool same_but_color(const SkPaint& a, const SkPaint& b) {
+    SkPaint recolored(b);
+    recolored.setColor(a.getColor());
+    return a == recolored;
+}
+
+// Fills in entry to draw op as part of a DrawImageSet, if it can be.  Sets always sample with
+// kFast_SrcRectConstraint, and draw with a paint of only their quality, blend mode, alpha and
+// antialiasing.
+static bool as_image_set_entry(const DrawImageRect& op, SkCanvas::ImageSetEntry* entry,
+                               SkFilterQuality* quality, SkBlendMode* mode) {
+    const SkImage* image = op.image.get();
+    const SkRect bounds = SkRect::MakeIWH(image->width(), image->height());
+    const SkRect src = op.src ? *op.src : bounds;
+    if (!bounds.contains(src) ||
+        (op.constraint == SkCanvas::kStrict_SrcRectConstraint && src != bounds)) {
+        return false;
+    }
+
+    SkPaint paint;
+    if (op.paint) {
+        // The color of the paint only matters to alpha-only images, which sets draw in black.
+        paint.setColor(op.paint->getColor());
+        paint.setFilterQuality(op.paint->getFilterQuality());
+        paint.setBlendMode(op.paint->getBlendMode());
+        paint.setAntiAlias(op.paint->isAntiAlias());
+        if (image->isAlphaOnly() || !(paint == *op.paint) ||
+            paint.getFilterQuality() > kLow_SkFilterQuality) {
+            return false;
+        }
+    }
+
+    entry->fImage    = op.image;
+    entry->fSrcRect  = src;
+    entry->fDstRect  = op.dst;
+    entry->fAlpha    = paint.getAlpha() / 255.0f;
+    entry->fAAFlags  = paint.isAntiAlias() ? SkCanvas::kAll_QuadAAFlags
+                                           : SkCanvas::kNone_QuadAAFlags;
+    *quality = paint.getFilterQuality();
+    *mode    = paint.getBlendMode();
+    return true;
+}
+
+// Runs of DrawRects with the same paint but for color draw the same as a DrawRects, which draws
+// as if drawRect() were called for each rect.  The same goes for runs of DrawImageRects of one
+// image and a DrawImageSet.  Sets of several images are left alone; every image in a set is
+// drawn, or decoded, even where the canvas would have rejected its rect.
+int SkRecordMergeDraws(SkRecord* record) {
+    SkTDArray<int> run;
+    int count = 0;
+    for (int i = 0; i < record->count(); i++) {
+        Is<DrawRect> isRect;
+        Is<DrawImageRect> isImageRect;
+        if (record->mutate(i, isRect) && can_batch(&isRect.get()->paint)) {
+            const SkPaint paint = isRect.get()->paint;
+            bool sameColor = true;
+            run.rewind();
+            run.push_back(i);
+            for (int j = i + 1; j < record->count(); j++) {
+                Is<NoOp> isNoOp;
+                Is<DrawRect> next;
+                if (record->mutate(j, next) && same_but_color(paint, next.get()->paint)) {
+                    sameColor = sameColor && next.get()->paint.getColor() == paint.getColor();
+                    run.push_back(j);
+                } else if (!record->mutate(j, isNoOp)) {
+                    break;
+                }
+            }
+            if (run.count() < 2) {
+                continue;
+            }
+
+            SkRect* rects = record->alloc<SkRect>(run.count());
+            SkColor* colors = sameColor ? nullptr : record->alloc<SkColor>(run.count());
+            for (int k = 0; k < run.count(); k++) {
+                record->mutate(run[k], isRect);
+                rects[k] = isRect.get()->rect;
+                if (colors) {
+                    colors[k] = isRect.get()->paint.getColor();
+                }
+                record->replace<NoOp>(run[k]);
+            }
+            new (record->replace<DrawRects>(i)) DrawRects{paint, rects, colors, run.count()};
+            count += run.count() - 1;
+            i = run.top();
+        } else if (record->mutate(i, isImageRect)) {
+            const sk_sp<const SkImage> image = isImageRect.get()->image;
+            SkAutoTArray<SkCanvas::ImageSetEntry> set(1);
+            SkFilterQuality quality;
+            SkBlendMode mode;
+            if (!as_image_set_entry(*isImageRect.get(), &set[0], &quality, &mode)) {
+                continue;
+            }
+            run.rewind();
+            run.push_back(i);
+            for (int j = i + 1; j < record->count(); j++) {
+                Is<NoOp> isNoOp;
+                Is<DrawImageRect> next;
+                SkCanvas::ImageSetEntry entry;
+                SkFilterQuality nextQuality;
+                SkBlendMode nextMode;
+                if (record->mutate(j, next) && next.get()->image == image &&
+                    as_image_set_entry(*next.get(), &entry, &nextQuality, &nextMode) &&
+                    nextQuality == quality && nextMode == mode) {
+                    run.push_back(j);
+                } else if (!record->mutate(j, isNoOp)) {
+                    break;
+                }
+            }
+            if (run.count() < 2) {
+                continue;
+            }
+
+            set.reset(run.count());
+            for (int k = 0; k < run.count(); k++) {
+                record->mutate(run[k], isImageRect);
+                SkAssertResult(as_image_set_entry(*isImageRect.get(), &set[k], &quality, &mode));
+                record->replace<NoOp>(run[k]);
+            }
+            new (record->replace<DrawImageSet>(i)) DrawImageSet{std::move(set), run.count(),
+                                                                quality, mode};
+            count += run.count() - 1;
+            i = run.top();
+        }
+    }
+    return count;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -310,9 +736,22 @@ void SkRecordOptimize(SkRecord* record) {
     record->defrag();
 }
 
-void SkRecordOptimize2(SkRecord* record) {
+void SkRecordOptimize2(SkRecord* record, SkRecordOptStats* stats, bool hardClip) {
+    SkRecordOptStats ignored;
+    if (!stats) {
+        stats = &ignored;
+    }
+
+    // Folding Concats away may leave SetMatrices next to each other.
+    stats->fMatrices += SkRecordMergeMatrices(record);
     multiple_set_matrices(record);
     SkRecordNoopSaveRestores(record);
+    stats->fClips += SkRecordNoopRedundantClips(record);
+    // Hide draws before merging them, so the batches only draw what shows.
+    if (hardClip) {
+        stats->fCoveredDraws += SkRecordNoopCoveredDraws(record);
+    }
+    stats->fMergedDraws += SkRecordMergeDraws(record);
     // See why we turn this off in SkRecordOptimize above.
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
     SkRecordNoopSaveLayerDrawRestores(record);
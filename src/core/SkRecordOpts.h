@@ -26,7 +26,36 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
-// Experimental optimizers
-void SkRecordOptimize2(SkRecord*);
+// Folds Concat-Concat and Translate-Translate chains into one command, and no-ops any Concat or
+// Translate that a SetMatrix overrides.  Returns how many commands it no-opped.
+int SkRecordMergeMatrices(SkRecord*);
+
+// No-ops hard-edged ClipRects that contain the ClipRect before them, with only draws in between,
+// as they can't shrink the clip.  Returns how many clips it no-opped.
+int SkRecordNoopRedundantClips(SkRecord*);
+
+// No-ops draws hidden by a later opaque draw with the same clip and matrix.  Returns how many
+// draws it no-opped.
+//
+// Only safe for records played back under a hard (non-antialiased) clip: where an antialiased
+// clip partially covers a pixel, the later draw blends with the hidden one rather than replacing
+// it, so no-opping the hidden draw changes the output.
+int SkRecordNoopCoveredDraws(SkRecord*);
+
+// Merges runs of DrawRects that differ only by color into one batched DrawRects, and runs of
+// DrawImageRects of the same image into one DrawImageSet.  Returns how many draws it no-opped.
+int SkRecordMergeDraws(SkRecord*);
+
+// How many commands each of SkRecordOptimize2()'s passes no-opped.
+struct SkRecordOptStats {
+    int fMatrices     = 0;
+    int fClips        = 0;
+    int fCoveredDraws = 0;
+    int fMergedDraws  = 0;
+};
+
+// Experimental optimizers.  SkRecordNoopCoveredDraws() only runs if hardClip promises the record
+// will always be played back under a hard clip; see above.
+void SkRecordOptimize2(SkRecord*, SkRecordOptStats* = nullptr, bool hardClip = false);
 
 #endif//SkRecordOpts_DEFINED
@@ -68,6 +68,7 @@ namespace SkRecords {
     M(DrawPoints)                                                   \
     M(DrawRRect)                                                    \
     M(DrawRect)                                                     \
+    M(DrawRects)                                                    \
     M(DrawEdgeAARect)                                               \
     M(DrawRegion)                                                   \
     M(DrawTextBlob)                                                 \
@@ -290,6 +291,11 @@ RECORD(DrawRRect, kDraw_Tag|kHasPaint_Tag,
 RECORD(DrawRect, kDraw_Tag|kHasPaint_Tag,
         SkPaint paint;
         SkRect rect);
+RECORD(DrawRects, kDraw_Tag|kHasPaint_Tag,
+        SkPaint paint;
+        PODArray<SkRect> rects;
+        PODArray<SkColor> colors;
+        int count);
 RECORD(DrawEdgeAARect, kDraw_Tag,
        SkRect rect;
        SkCanvas::QuadAAFlags aa;
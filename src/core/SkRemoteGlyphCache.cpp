@@ -7,7 +7,9 @@
 
 #include "SkRemoteGlyphCache.h"
 
+#include <algorithm>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <new>
 #include <string>
@@ -16,9 +18,13 @@
 #include "SkDevice.h"
 #include "SkDraw.h"
 #include "SkGlyphRun.h"
+#include "SkMilestone.h"
 #include "SkRemoteGlyphCacheImpl.h"
 #include "SkStrike.h"
 #include "SkStrikeCache.h"
+#include "SkOpts.h"
+#include "SkPackBits.h"
+#include "SkStream.h"
 #include "SkTLazy.h"
 #include "SkTraceEvent.h"
 #include "SkTypeface_remote.h"
@@ -40,6 +46,7 @@ static SkDescriptor* auto_descriptor_from_desc(const SkDescriptor* source_desc,
         uint32_t size;
         auto ptr = source_desc->findEntry(kRec_SkDescriptorTag, &size);
         SkScalerContextRec rec;
+        if (!ptr || size != sizeof(rec)) return nullptr;
         std::memcpy(&rec, ptr, size);
         rec.fFontID = font_id;
         desc->addEntry(kRec_SkDescriptorTag, sizeof(rec), &rec);
@@ -132,13 +139,15 @@ public:
 
         ad->reset(desc_length);
         memcpy(ad->getDesc(), const_cast<const char*>(result), desc_length);
-        return true;
+        return ad->getDesc()->getLength() == desc_length;
     }
 
     const volatile void* read(size_t size, size_t alignment) {
       return this->ensureAtLeast(size, alignment);
     }
 
+    size_t bytesRead() const { return fBytesRead; }
+
 private:
     const volatile char* ensureAtLeast(size_t size, size_t alignment) {
         size_t padded = pad(fBytesRead, alignment);
@@ -157,6 +166,369 @@ private:
     size_t fBytesRead = 0u;
 };
 
+// -- FrameSerializer -----------------------------------------------------------------------------
+// The compressed strike data is a series of frames, each a FrameHeader followed by a payload of
+// records: typefaces, and glyphs of strikes. Integers in the payload are varints, and signed ones
+// are zigzag encoded first.
+struct FrameHeader {
+    uint32_t magic;
+    uint32_t payloadSize;
+};
+
+static constexpr uint32_t kFrameMagic = SkSetFourByteTag('s', 'k', 'g', 'f');
+
+enum RecordType : uint8_t {
+    kTypeface_RecordType = 1,
+    kStrike_RecordType   = 2,
+};
+
+enum GlyphFlags : uint8_t {
+    kPath_GlyphFlag         = 1 << 0,  // The glyph was sent for its path instead of its image.
+    kHasPath_GlyphFlag      = 1 << 1,
+    kPackedImage_GlyphFlag  = 1 << 2,  // The image is run length encoded.
+    kForceBW_GlyphFlag      = 1 << 3,
+    kSameAdvanceX_GlyphFlag = 1 << 4,  // The advance is that of the glyph before.
+    kZeroAdvanceY_GlyphFlag = 1 << 5,
+};
+
+class FrameSerializer {
+public:
+    FrameSerializer(std::vector<uint8_t>* buffer, size_t frameSize)
+            : fBuffer{buffer}, fFrameSize{frameSize} {}
+
+    void writeByte(uint8_t byte) {
+        this->beginFrame();
+        fBuffer->push_back(byte);
+    }
+
+    void writeVarint(uint64_t value) {
+        for (; value >= 0x80; value >>= 7) {
+            this->writeByte(static_cast<uint8_t>(value | 0x80));
+        }
+        this->writeByte(static_cast<uint8_t>(value));
+    }
+
+    void writeSigned(int64_t value) {
+        this->writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void writeBytes(const void* data, size_t size) {
+        this->beginFrame();
+        auto* bytes = static_cast<const uint8_t*>(data);
+        fBuffer->insert(fBuffer->end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void write(const T& data) {
+        this->writeBytes(&data, sizeof(T));
+    }
+
+    // Writes a placeholder for a count that is only known later, and returns its offset for
+    // setCount().
+    size_t reserveCount() {
+        this->beginFrame();
+        size_t offset = fBuffer->size();
+        this->write<uint32_t>(0u);
+        return offset;
+    }
+
+    void setCount(size_t offset, uint32_t count) {
+        memcpy(&(*fBuffer)[offset], &count, sizeof(count));
+    }
+
+    bool frameIsFull() const {
+        return fInFrame && fBuffer->size() - fFrameStart >= fFrameSize;
+    }
+
+    void endFrame() {
+        if (!fInFrame) return;
+        FrameHeader header{kFrameMagic,
+                           SkToU32(fBuffer->size() - fFrameStart - sizeof(FrameHeader))};
+        memcpy(&(*fBuffer)[fFrameStart], &header, sizeof(header));
+        fInFrame = false;
+    }
+
+private:
+    void beginFrame() {
+        if (fInFrame) return;
+        fFrameStart = fBuffer->size();
+        fBuffer->resize(fFrameStart + sizeof(FrameHeader));
+        fInFrame = true;
+    }
+
+    std::vector<uint8_t>* fBuffer;
+    const size_t fFrameSize;
+    size_t fFrameStart = 0u;
+    bool fInFrame = false;
+};
+
+// -- FrameDeserializer ---------------------------------------------------------------------------
+// Reads the payload of a frame. Like the Deserializer, it reads untrusted data, and reads each
+// piece of memory only once.
+class FrameDeserializer {
+public:
+    FrameDeserializer(const volatile char* memory, size_t memorySize)
+            : fMemory(memory), fMemorySize(memorySize) {}
+
+    bool readByte(uint8_t* byte) {
+        if (fBytesRead == fMemorySize) return false;
+        *byte = fMemory[fBytesRead++];
+        return true;
+    }
+
+    bool readVarint(uint64_t* value) {
+        *value = 0u;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte;
+            if (!this->readByte(&byte)) return false;
+            *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool readSigned(int64_t* value) {
+        uint64_t zigzag;
+        if (!this->readVarint(&zigzag)) return false;
+        *value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        return true;
+    }
+
+    // Reads a varint, failing if it doesn't fit in T.
+    template <typename T>
+    bool readVarint(T* value) {
+        uint64_t wide;
+        if (!this->readVarint(&wide) || wide > std::numeric_limits<T>::max()) return false;
+        *value = static_cast<T>(wide);
+        return true;
+    }
+
+    template <typename T>
+    bool readSigned(T* value) {
+        int64_t wide;
+        if (!this->readSigned(&wide) ||
+            wide < std::numeric_limits<T>::min() || wide > std::numeric_limits<T>::max()) {
+            return false;
+        }
+        *value = static_cast<T>(wide);
+        return true;
+    }
+
+    template <typename T>
+    bool read(T* val) {
+        auto* result = this->readBytes(sizeof(T));
+        if (!result) return false;
+
+        memcpy(val, const_cast<const char*>(result), sizeof(T));
+        return true;
+    }
+
+    const volatile char* readBytes(size_t size) {
+        if (size > this->bytesLeft()) return nullptr;
+
+        auto* result = fMemory + fBytesRead;
+        fBytesRead += size;
+        return result;
+    }
+
+    size_t bytesLeft() const { return fMemorySize - fBytesRead; }
+
+private:
+    const volatile char* fMemory;
+    size_t fMemorySize;
+    size_t fBytesRead = 0u;
+};
+
+// The state that the glyphs of a strike record are delta encoded against.
+struct GlyphDeltas {
+    uint32_t prevID = 0u;
+    float prevAdvanceX = 0.f;
+};
+
+static bool same_bits(float a, float b) { return SkFloat2Bits(a) == SkFloat2Bits(b); }
+
+static void write_compressed_glyph(const SkGlyph& glyph, uint8_t flags, GlyphDeltas* deltas,
+                                   FrameSerializer* serializer) {
+    if (glyph.fForceBW) flags |= kForceBW_GlyphFlag;
+    if (same_bits(glyph.fAdvanceX, deltas->prevAdvanceX)) flags |= kSameAdvanceX_GlyphFlag;
+    if (same_bits(glyph.fAdvanceY, 0.f)) flags |= kZeroAdvanceY_GlyphFlag;
+
+    serializer->writeByte(flags);
+    serializer->writeByte(glyph.fMaskFormat);
+    uint32_t id = glyph.getPackedID().value();
+    serializer->writeSigned(static_cast<int64_t>(id) - deltas->prevID);
+    if (!(flags & kSameAdvanceX_GlyphFlag)) serializer->write<float>(glyph.fAdvanceX);
+    if (!(flags & kZeroAdvanceY_GlyphFlag)) serializer->write<float>(glyph.fAdvanceY);
+    serializer->writeVarint(glyph.fWidth);
+    serializer->writeVarint(glyph.fHeight);
+    serializer->writeSigned(glyph.fTop);
+    serializer->writeSigned(glyph.fLeft);
+
+    deltas->prevID = id;
+    deltas->prevAdvanceX = glyph.fAdvanceX;
+}
+
+static bool read_compressed_glyph(FrameDeserializer* deserializer, GlyphDeltas* deltas,
+                                  uint8_t* flags, SkTLazy<SkGlyph>& glyph) {
+    uint8_t maskFormat;
+    int64_t idDelta;
+    if (!deserializer->readByte(flags)) return false;
+    if (!deserializer->readByte(&maskFormat)) return false;
+    if (!deserializer->readSigned(&idDelta)) return false;
+
+    int64_t id = deltas->prevID + idDelta;
+    if (id < 0 || id > std::numeric_limits<uint32_t>::max()) return false;
+    uint32_t packedID = static_cast<uint32_t>(id);
+    SkPackedGlyphID glyphID;
+    memcpy(&glyphID, &packedID, sizeof(glyphID));
+    glyph.init(glyphID);
+
+    glyph->fAdvanceX = deltas->prevAdvanceX;
+    if (!(*flags & kSameAdvanceX_GlyphFlag) && !deserializer->read<float>(&glyph->fAdvanceX)) {
+        return false;
+    }
+    if (!(*flags & kZeroAdvanceY_GlyphFlag) && !deserializer->read<float>(&glyph->fAdvanceY)) {
+        return false;
+    }
+    if (!deserializer->readVarint(&glyph->fWidth)) return false;
+    if (!deserializer->readVarint(&glyph->fHeight)) return false;
+    if (!deserializer->readSigned(&glyph->fTop)) return false;
+    if (!deserializer->readSigned(&glyph->fLeft)) return false;
+    glyph->fForceBW = (*flags & kForceBW_GlyphFlag) ? 1 : 0;
+    glyph->fMaskFormat = maskFormat;
+
+    deltas->prevID = packedID;
+    deltas->prevAdvanceX = glyph->fAdvanceX;
+    return true;
+}
+
+// Each row of an image is replaced by its difference from the row above, which turns the
+// vertical strokes of a glyph into runs of zeros, and the result is run length encoded. Returns
+// false if that doesn't make the image smaller, in which case the differences are sent as is.
+static bool pack_image(size_t rowBytes, std::vector<uint8_t>* image,
+                       std::vector<uint8_t>* packed) {
+    uint8_t* pixels = image->data();
+    for (size_t i = image->size(); i-- > rowBytes;) {
+        pixels[i] -= pixels[i - rowBytes];
+    }
+
+    packed->resize(SkPackBits::ComputeMaxSize8(image->size()));
+    packed->resize(SkPackBits::Pack8(pixels, image->size(), packed->data(), packed->size()));
+    return packed->size() < image->size();
+}
+
+static bool read_compressed_image(FrameDeserializer* deserializer, bool isPacked,
+                                  size_t rowBytes, size_t imageSize, std::vector<uint8_t>* image) {
+    if (isPacked) {
+        uint64_t packedSize;
+        if (!deserializer->readVarint(&packedSize)) return false;
+        // A run of PackBits takes at least two bytes for at most 128, which bounds the image
+        // before it is allocated.
+        if (packedSize > deserializer->bytesLeft() || imageSize / 64 > packedSize) return false;
+        auto* packed = deserializer->readBytes(packedSize);
+        image->resize(imageSize);
+        if (SkPackBits::Unpack8(const_cast<const uint8_t*>(
+                                        reinterpret_cast<const volatile uint8_t*>(packed)),
+                                packedSize, image->data(), imageSize) != (int)imageSize) {
+            return false;
+        }
+    } else {
+        auto* pixels = deserializer->readBytes(imageSize);
+        if (!pixels) return false;
+        image->resize(imageSize);
+        memcpy(image->data(), const_cast<const char*>(pixels), imageSize);
+    }
+
+    uint8_t* pixels = image->data();
+    for (size_t i = rowBytes; i < imageSize; i++) {
+        pixels[i] += pixels[i - rowBytes];
+    }
+    return true;
+}
+
+static int points_in_verb(uint8_t verb) {
+    switch (verb) {
+        case SkPath::kMove_Verb:  return 1;
+        case SkPath::kLine_Verb:  return 1;
+        case SkPath::kQuad_Verb:  return 2;
+        case SkPath::kConic_Verb: return 2;
+        case SkPath::kCubic_Verb: return 3;
+        default:                  return 0;
+    }
+}
+
+// Paths are sent as their verbs, two to a byte, then their points, conic weights and fill type.
+static void write_compressed_path(const SkPath& path, FrameSerializer* serializer) {
+    int verbCount = path.countVerbs();
+    SkAutoSTMalloc<64, uint8_t> verbs(verbCount);
+    path.getVerbs(verbs.get(), verbCount);
+    serializer->writeVarint(verbCount);
+    for (int i = 0; i < verbCount; i += 2) {
+        uint8_t high = i + 1 < verbCount ? verbs[i + 1] : 0;
+        serializer->writeByte(verbs[i] | (high << 4));
+    }
+
+    int pointCount = path.countPoints();
+    SkAutoSTMalloc<64, SkPoint> points(pointCount);
+    path.getPoints(points.get(), pointCount);
+    serializer->writeBytes(points.get(), pointCount * sizeof(SkPoint));
+
+    SkPath::RawIter iter(path);
+    SkPoint pts[4];
+    for (SkPath::Verb verb; (verb = iter.next(pts)) != SkPath::kDone_Verb;) {
+        if (verb == SkPath::kConic_Verb) serializer->write<float>(iter.conicWeight());
+    }
+    serializer->writeByte(path.getFillType());
+}
+
+static bool read_compressed_path(FrameDeserializer* deserializer, SkPath* path) {
+    uint64_t verbCount;
+    if (!deserializer->readVarint(&verbCount)) return false;
+    if (verbCount > deserializer->bytesLeft() * 2) return false;
+    auto* packedVerbs = deserializer->readBytes((verbCount + 1) / 2);
+    if (!packedVerbs) return false;
+
+    SkAutoSTMalloc<64, uint8_t> verbs(verbCount);
+    size_t pointCount = 0, conicCount = 0;
+    for (size_t i = 0; i < verbCount; i++) {
+        verbs[i] = (packedVerbs[i / 2] >> (i % 2 * 4)) & 0xf;
+        if (verbs[i] > SkPath::kClose_Verb) return false;
+        pointCount += points_in_verb(verbs[i]);
+        conicCount += verbs[i] == SkPath::kConic_Verb;
+    }
+
+    SkAutoSTMalloc<64, SkPoint> points(pointCount);
+    auto* pointData = deserializer->readBytes(pointCount * sizeof(SkPoint));
+    if (!pointData) return false;
+    memcpy(points.get(), const_cast<const char*>(pointData), pointCount * sizeof(SkPoint));
+
+    SkAutoSTMalloc<16, float> weights(conicCount);
+    auto* weightData = deserializer->readBytes(conicCount * sizeof(float));
+    if (!weightData) return false;
+    memcpy(weights.get(), const_cast<const char*>(weightData), conicCount * sizeof(float));
+
+    uint8_t fillType;
+    if (!deserializer->readByte(&fillType)) return false;
+    if (fillType > SkPath::kInverseEvenOdd_FillType) return false;
+
+    path->reset();
+    path->setFillType(static_cast<SkPath::FillType>(fillType));
+    const SkPoint* pt = points.get();
+    const float* weight = weights.get();
+    for (size_t i = 0; i < verbCount; i++) {
+        switch (verbs[i]) {
+            case SkPath::kMove_Verb:  path->moveTo(pt[0]);                         break;
+            case SkPath::kLine_Verb:  path->lineTo(pt[0]);                         break;
+            case SkPath::kQuad_Verb:  path->quadTo(pt[0], pt[1]);                  break;
+            case SkPath::kConic_Verb: path->conicTo(pt[0], pt[1], *weight++);      break;
+            case SkPath::kCubic_Verb: path->cubicTo(pt[0], pt[1], pt[2]);          break;
+            case SkPath::kClose_Verb: path->close();                              break;
+        }
+        pt += points_in_verb(verbs[i]);
+    }
+    return true;
+}
+
 // Paths use a SkWriter32 which requires 4 byte alignment.
 static const size_t kPathAlignment  = 4u;
 
@@ -172,6 +544,17 @@ bool read_path(Deserializer* deserializer, SkGlyph* glyph, SkStrike* cache) {
     return cache->initializePath(glyph, path, pathSize);
 }
 
+static void write_path(const SkPath* path, Serializer* serializer) {
+    if (!path) {
+        serializer->write<uint64_t>(0u);
+        return;
+    }
+
+    size_t pathSize = path->writeToMemory(nullptr);
+    serializer->write<uint64_t>(pathSize);
+    path->writeToMemory(serializer->allocate(pathSize, kPathAlignment));
+}
+
 size_t SkDescriptorMapOperators::operator()(const SkDescriptor* key) const {
     return key->getChecksum();
 }
@@ -313,6 +696,27 @@ void SkStrikeServer::writeStrikeData(std::vector<uint8_t>* memory) {
     fLockedDescs.clear();
 }
 
+void SkStrikeServer::writeCompressedStrikeData(std::vector<uint8_t>* memory, size_t frameSize) {
+    if (fLockedDescs.empty() && fTypefacesToSend.empty()) {
+        return;
+    }
+
+    FrameSerializer serializer(memory, frameSize);
+    for (const auto& tf : fTypefacesToSend) {
+        serializer.writeByte(kTypeface_RecordType);
+        serializer.write<WireTypeface>(tf);
+    }
+    fTypefacesToSend.clear();
+
+    for (const auto* desc : fLockedDescs) {
+        auto it = fRemoteGlyphStateMap.find(desc);
+        SkASSERT(it != fRemoteGlyphStateMap.end());
+        it->second->writePendingGlyphsCompressed(&serializer);
+    }
+    fLockedDescs.clear();
+    serializer.endFrame();
+}
+
 SkStrikeServer::SkGlyphCacheState* SkStrikeServer::getOrCreateCache(
         const SkPaint& paint,
         const SkFont& font,
@@ -446,7 +850,7 @@ void SkStrikeServer::SkGlyphCacheState::addGlyph(SkPackedGlyphID glyph, bool asP
     pending->push_back(glyph);
 }
 
-static void writeGlyph(SkGlyph* glyph, Serializer* serializer) {
+static void writeGlyph(const SkGlyph* glyph, Serializer* serializer) {
     serializer->write<SkPackedGlyphID>(glyph->getPackedID());
     serializer->write<float>(glyph->fAdvanceX);
     serializer->write<float>(glyph->fAdvanceY);
@@ -505,6 +909,92 @@ void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serialize
     this->resetScalerContext();
 }
 
+void SkStrikeServer::SkGlyphCacheState::writePendingGlyphsCompressed(
+        FrameSerializer* serializer) {
+    if (!this->hasPendingGlyphs()) {
+        this->resetScalerContext();
+        return;
+    }
+
+    SkFontMetrics fontMetrics;
+    fContext->getFontMetrics(&fontMetrics);
+
+    // The glyphs go in strike records, which start with what the client needs to find the
+    // strike. When a frame fills up, the record is ended, and the rest of the glyphs go in a new
+    // record in a new frame.
+    size_t countOffset = 0u;
+    uint32_t glyphCount = 0u;
+    GlyphDeltas deltas;
+    auto nextGlyph = [&]() {
+        if (glyphCount > 0u && !serializer->frameIsFull()) {
+            glyphCount++;
+            return;
+        }
+        if (glyphCount > 0u) serializer->setCount(countOffset, glyphCount);
+        if (serializer->frameIsFull()) serializer->endFrame();
+
+        const SkDescriptor& desc = *fDescriptor.getDesc();
+        serializer->writeByte(kStrike_RecordType);
+        serializer->writeVarint(fContext->getTypeface()->uniqueID());
+        serializer->writeVarint(fDiscardableHandleId);
+        serializer->writeVarint(desc.getLength());
+        serializer->writeBytes(&desc, desc.getLength());
+        serializer->write<SkFontMetrics>(fontMetrics);
+        countOffset = serializer->reserveCount();
+        glyphCount = 1u;
+        deltas = GlyphDeltas();
+    };
+
+    // In order, the IDs of the glyphs differ by little.
+    std::sort(fPendingGlyphImages.begin(), fPendingGlyphImages.end());
+    std::sort(fPendingGlyphPaths.begin(), fPendingGlyphPaths.end());
+
+    // Write glyphs images.
+    std::vector<uint8_t> image, packed;
+    for (const auto& glyphID : fPendingGlyphImages) {
+        SkGlyph glyph{glyphID};
+        fContext->getMetrics(&glyph);
+        auto imageSize = glyph.computeImageSize();
+        uint8_t flags = 0u;
+        if (imageSize != 0u) {
+            SkGlyph imageGlyph = glyph;
+            image.resize(imageSize);
+            imageGlyph.fImage = image.data();
+            fContext->getImage(imageGlyph);
+            if (pack_image(glyph.rowBytes(), &image, &packed)) flags |= kPackedImage_GlyphFlag;
+        }
+
+        nextGlyph();
+        write_compressed_glyph(glyph, flags, &deltas, serializer);
+        if (imageSize == 0u) continue;
+
+        if (flags & kPackedImage_GlyphFlag) {
+            serializer->writeVarint(packed.size());
+            serializer->writeBytes(packed.data(), packed.size());
+        } else {
+            serializer->writeBytes(image.data(), image.size());
+        }
+    }
+    fPendingGlyphImages.clear();
+
+    // Write glyphs paths.
+    for (const auto& glyphID : fPendingGlyphPaths) {
+        SkGlyph glyph{glyphID};
+        fContext->getMetrics(&glyph);
+        SkPath path;
+        bool hasPath = fContext->getPath(glyphID, &path);
+
+        nextGlyph();
+        write_compressed_glyph(glyph, kPath_GlyphFlag | (hasPath ? kHasPath_GlyphFlag : 0),
+                               &deltas, serializer);
+        if (hasPath) write_compressed_path(path, serializer);
+    }
+    fPendingGlyphPaths.clear();
+
+    serializer->setCount(countOffset, glyphCount);
+    this->resetScalerContext();
+}
+
 void SkStrikeServer::SkGlyphCacheState::ensureScalerContext() {
     if (fContext == nullptr) {
         fContext = fTypeface->createScalerContext(fEffects, fDescriptor.getDesc());
@@ -585,14 +1075,7 @@ bool SkStrikeServer::SkGlyphCacheState::decideCouldDrawFromPath(const SkGlyph& g
 void SkStrikeServer::SkGlyphCacheState::writeGlyphPath(const SkPackedGlyphID& glyphID,
                                                        Serializer* serializer) const {
     SkPath path;
-    if (!fContext->getPath(glyphID, &path)) {
-        serializer->write<uint64_t>(0u);
-        return;
-    }
-
-    size_t pathSize = path.writeToMemory(nullptr);
-    serializer->write<uint64_t>(pathSize);
-    path.writeToMemory(serializer->allocate(pathSize, kPathAlignment));
+    write_path(fContext->getPath(glyphID, &path) ? &path : nullptr, serializer);
 }
 
 
@@ -678,6 +1161,54 @@ static bool readGlyph(SkTLazy<SkGlyph>& glyph, Deserializer* deserializer) {
     return true;
 }
 
+// Reads the glyph images and paths of a strike, as written by
+// SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(), into strike.
+static bool read_glyphs(Deserializer* deserializer, SkStrike* strike) {
+    uint64_t glyphImagesCount = 0u;
+    if (!deserializer->read<uint64_t>(&glyphImagesCount)) return false;
+    for (size_t j = 0; j < glyphImagesCount; j++) {
+        SkTLazy<SkGlyph> glyph;
+        if (!readGlyph(glyph, deserializer)) return false;
+
+        SkGlyph* allocatedGlyph = strike->getRawGlyphByID(glyph->getPackedID());
+
+        // Update the glyph unless it's already got an image (from fallback),
+        // preserving any path that might be present.
+        if (allocatedGlyph->fImage == nullptr) {
+            auto* glyphPath = allocatedGlyph->fPathData;
+            *allocatedGlyph = *glyph;
+            allocatedGlyph->fPathData = glyphPath;
+        }
+
+        auto imageSize = glyph->computeImageSize();
+        if (imageSize == 0u) continue;
+
+        auto* image = deserializer->read(imageSize, allocatedGlyph->formatAlignment());
+        if (!image) return false;
+        strike->initializeImage(image, imageSize, allocatedGlyph);
+    }
+
+    uint64_t glyphPathsCount = 0u;
+    if (!deserializer->read<uint64_t>(&glyphPathsCount)) return false;
+    for (size_t j = 0; j < glyphPathsCount; j++) {
+        SkTLazy<SkGlyph> glyph;
+        if (!readGlyph(glyph, deserializer)) return false;
+
+        SkGlyph* allocatedGlyph = strike->getRawGlyphByID(glyph->getPackedID());
+
+        // Update the glyph unless it's already got a path (from fallback),
+        // preserving any image that might be present.
+        if (allocatedGlyph->fPathData == nullptr) {
+            auto* glyphImage = allocatedGlyph->fImage;
+            *allocatedGlyph = *glyph;
+            allocatedGlyph->fImage = glyphImage;
+        }
+
+        if (!read_path(deserializer, allocatedGlyph, strike)) return false;
+    }
+    return true;
+}
+
 bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySize) {
     SkASSERT(memorySize != 0u);
     Deserializer deserializer(static_cast<const volatile char*>(memory), memorySize);
@@ -713,40 +1244,44 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
         SkFontMetrics fontMetrics;
         if (!deserializer.read<SkFontMetrics>(&fontMetrics)) READ_FAILURE
 
-        // Get the local typeface from remote fontID.
-        auto* tf = fRemoteFontIdToTypeface.find(spec.typefaceID)->get();
-        // Received strikes for a typeface which doesn't exist.
-        if (!tf) READ_FAILURE
+        auto strike = this->findOrCreateStrike(spec, *sourceAd.getDesc(), &fontMetrics);
+        if (!strike) READ_FAILURE
 
-        // Replace the ContextRec in the desc from the server to create the client
-        // side descriptor.
-        // TODO: Can we do this in-place and re-compute checksum? Instead of a complete copy.
-        SkAutoDescriptor ad;
-        auto* client_desc = auto_descriptor_from_desc(sourceAd.getDesc(), tf->uniqueID(), &ad);
-
-        auto strike = fStrikeCache->findStrikeExclusive(*client_desc);
-        if (strike == nullptr) {
-            // Note that we don't need to deserialize the effects since we won't be generating any
-            // glyphs here anyway, and the desc is still correct since it includes the serialized
-            // effects.
-            SkScalerContextEffects effects;
-            auto scaler = SkStrikeCache::CreateScalerContext(*client_desc, effects, *tf);
-            strike = fStrikeCache->createStrikeExclusive(
-                    *client_desc, std::move(scaler), &fontMetrics,
-                    skstd::make_unique<DiscardableStrikePinner>(spec.discardableHandleId,
-                                                                fDiscardableHandleManager));
-            auto proxyContext = static_cast<SkScalerContextProxy*>(strike->getScalerContext());
-            proxyContext->initCache(strike.get(), fStrikeCache);
-        }
+        if (!read_glyphs(&deserializer, strike.get())) READ_FAILURE
+    }
 
-        uint64_t glyphImagesCount = 0u;
-        if (!deserializer.read<uint64_t>(&glyphImagesCount)) READ_FAILURE
-        for (size_t j = 0; j < glyphImagesCount; j++) {
-            SkTLazy<SkGlyph> glyph;
-            if (!readGlyph(glyph, &deserializer)) READ_FAILURE
+    return true;
+}
 
-            SkGlyph* allocatedGlyph = strike->getRawGlyphByID(glyph->getPackedID());
+// Reads the glyphs of a strike record, as written by
+// SkStrikeServer::SkGlyphCacheState::writePendingGlyphsCompressed(), into strike.
+static bool read_compressed_glyphs(FrameDeserializer* deserializer, uint32_t glyphCount,
+                                   SkStrike* strike, std::vector<uint8_t>* scratch) {
+    GlyphDeltas deltas;
+    for (uint32_t i = 0; i < glyphCount; i++) {
+        uint8_t flags;
+        SkTLazy<SkGlyph> glyph;
+        if (!read_compressed_glyph(deserializer, &deltas, &flags, glyph)) return false;
 
+        SkGlyph* allocatedGlyph = strike->getRawGlyphByID(glyph->getPackedID());
+
+        if (flags & kPath_GlyphFlag) {
+            // Update the glyph unless it's already got a path (from fallback),
+            // preserving any image that might be present.
+            if (allocatedGlyph->fPathData == nullptr) {
+                auto* glyphImage = allocatedGlyph->fImage;
+                *allocatedGlyph = *glyph;
+                allocatedGlyph->fImage = glyphImage;
+            }
+            if (!(flags & kHasPath_GlyphFlag)) continue;
+
+            SkPath path;
+            if (!read_compressed_path(deserializer, &path)) return false;
+            size_t pathSize = path.writeToMemory(nullptr);
+            scratch->resize(pathSize);
+            path.writeToMemory(scratch->data());
+            if (!strike->initializePath(allocatedGlyph, scratch->data(), pathSize)) return false;
+        } else {
             // Update the glyph unless it's already got an image (from fallback),
             // preserving any path that might be present.
             if (allocatedGlyph->fImage == nullptr) {
@@ -758,34 +1293,122 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
             auto imageSize = glyph->computeImageSize();
             if (imageSize == 0u) continue;
 
-            auto* image = deserializer.read(imageSize, allocatedGlyph->formatAlignment());
-            if (!image) READ_FAILURE
-            strike->initializeImage(image, imageSize, allocatedGlyph);
+            if (!read_compressed_image(deserializer, flags & kPackedImage_GlyphFlag,
+                                       glyph->rowBytes(), imageSize, scratch)) {
+                return false;
+            }
+            strike->initializeImage(scratch->data(), imageSize, allocatedGlyph);
         }
+    }
+    return true;
+}
 
-        uint64_t glyphPathsCount = 0u;
-        if (!deserializer.read<uint64_t>(&glyphPathsCount)) READ_FAILURE
-        for (size_t j = 0; j < glyphPathsCount; j++) {
-            SkTLazy<SkGlyph> glyph;
-            if (!readGlyph(glyph, &deserializer)) READ_FAILURE
+bool SkStrikeClient::readCompressedStrikeData(const volatile void* memory, size_t memorySize) {
+    SkASSERT(memorySize != 0u);
+    auto* frame = static_cast<const volatile char*>(memory);
+    std::vector<uint8_t> scratch;
+
+    while (memorySize > 0u) {
+        FrameHeader header;
+        if (memorySize < sizeof(header)) READ_FAILURE
+        memcpy(&header, const_cast<const char*>(frame), sizeof(header));
+        if (header.magic != kFrameMagic) READ_FAILURE
+        if (header.payloadSize > memorySize - sizeof(header)) READ_FAILURE
+
+        FrameDeserializer deserializer(frame + sizeof(header), header.payloadSize);
+        while (deserializer.bytesLeft() > 0u) {
+            uint8_t recordType;
+            if (!deserializer.readByte(&recordType)) READ_FAILURE
+
+            if (recordType == kTypeface_RecordType) {
+                WireTypeface wire;
+                if (!deserializer.read<WireTypeface>(&wire)) READ_FAILURE
+                addTypeface(wire);
+                continue;
+            }
+            if (recordType != kStrike_RecordType) READ_FAILURE
+
+            StrikeSpec spec;
+            uint32_t descLength;
+            if (!deserializer.readVarint(&spec.typefaceID)) READ_FAILURE
+            if (!deserializer.readVarint(&spec.discardableHandleId)) READ_FAILURE
+            if (!deserializer.readVarint(&descLength)) READ_FAILURE
+            if (descLength < sizeof(SkDescriptor) || SkAlign4(descLength) != descLength) {
+                READ_FAILURE
+            }
 
-            SkGlyph* allocatedGlyph = strike->getRawGlyphByID(glyph->getPackedID());
+            auto* descData = deserializer.readBytes(descLength);
+            if (!descData) READ_FAILURE
+            SkAutoDescriptor sourceAd(descLength);
+            memcpy(sourceAd.getDesc(), const_cast<const char*>(descData), descLength);
+            if (sourceAd.getDesc()->getLength() != descLength) READ_FAILURE
 
-            // Update the glyph unless it's already got a path (from fallback),
-            // preserving any image that might be present.
-            if (allocatedGlyph->fPathData == nullptr) {
-                auto* glyphImage = allocatedGlyph->fImage;
-                *allocatedGlyph = *glyph;
-                allocatedGlyph->fImage = glyphImage;
-            }
+            SkFontMetrics fontMetrics;
+            if (!deserializer.read<SkFontMetrics>(&fontMetrics)) READ_FAILURE
+
+            uint32_t glyphCount;
+            if (!deserializer.read<uint32_t>(&glyphCount)) READ_FAILURE
+
+            auto strike = this->findOrCreateStrike(spec, *sourceAd.getDesc(), &fontMetrics);
+            if (!strike) READ_FAILURE
 
-            if (!read_path(&deserializer, allocatedGlyph, strike.get())) READ_FAILURE
+            if (!read_compressed_glyphs(&deserializer, glyphCount, strike.get(), &scratch)) {
+                READ_FAILURE
+            }
         }
+
+        frame += sizeof(header) + header.payloadSize;
+        memorySize -= sizeof(header) + header.payloadSize;
     }
 
     return true;
 }
 
+size_t SkStrikeClient::CompleteFramesSize(const void* memory, size_t memorySize) {
+    auto* bytes = static_cast<const char*>(memory);
+    size_t size = 0u;
+    FrameHeader header;
+    while (memorySize - size >= sizeof(header)) {
+        memcpy(&header, bytes + size, sizeof(header));
+        if (header.payloadSize > memorySize - size - sizeof(header)) break;
+        size += sizeof(header) + header.payloadSize;
+    }
+    return size;
+}
+
+SkExclusiveStrikePtr SkStrikeClient::findOrCreateStrike(const StrikeSpec& spec,
+                                                        const SkDescriptor& sourceDesc,
+                                                        SkFontMetrics* fontMetrics) {
+    // Get the local typeface from remote fontID.
+    auto* tfPtr = fRemoteFontIdToTypeface.find(spec.typefaceID);
+    // Received strikes for a typeface which doesn't exist.
+    if (!tfPtr) return SkExclusiveStrikePtr();
+    SkTypeface* tf = tfPtr->get();
+
+    // Replace the ContextRec in the desc from the server to create the client
+    // side descriptor.
+    // TODO: Can we do this in-place and re-compute checksum? Instead of a complete copy.
+    SkAutoDescriptor ad;
+    auto* client_desc = auto_descriptor_from_desc(&sourceDesc, tf->uniqueID(), &ad);
+    if (!client_desc) return SkExclusiveStrikePtr();
+
+    auto strike = fStrikeCache->findStrikeExclusive(*client_desc);
+    if (strike == nullptr) {
+        // Note that we don't need to deserialize the effects since we won't be generating any
+        // glyphs here anyway, and the desc is still correct since it includes the serialized
+        // effects.
+        SkScalerContextEffects effects;
+        auto scaler = SkStrikeCache::CreateScalerContext(*client_desc, effects, *tf);
+        strike = fStrikeCache->createStrikeExclusive(
+                *client_desc, std::move(scaler), fontMetrics,
+                skstd::make_unique<DiscardableStrikePinner>(spec.discardableHandleId,
+                                                            fDiscardableHandleManager));
+        auto proxyContext = static_cast<SkScalerContextProxy*>(strike->getScalerContext());
+        proxyContext->initCache(strike.get(), fStrikeCache);
+    }
+    return strike;
+}
+
 sk_sp<SkTypeface> SkStrikeClient::deserializeTypeface(const void* buf, size_t len) {
     WireTypeface wire;
     if (len != sizeof(wire)) return nullptr;
@@ -803,3 +1426,230 @@ sk_sp<SkTypeface> SkStrikeClient::addTypeface(const WireTypeface& wire) {
     fRemoteFontIdToTypeface.set(wire.typefaceID, newTypeface);
     return std::move(newTypeface);
 }
+
+// -- SkStrikeCacheFile ----------------------------------------------------------------------------
+// A file is a StrikeCacheFileHeader followed by its strikes. Each strike is a
+// StrikeCacheFileStrike, then the strike's descriptor with a zero font id, and then its glyphs as
+// read by read_glyphs(). Strikes start 8 byte aligned, so that a Deserializer can start at one.
+// Files are only used by the Skia milestone that wrote them, and each strike only by the
+// rasterizer version that made its glyphs.
+static constexpr uint32_t kStrikeCacheFileMagic   = SkSetFourByteTag('s', 'k', 's', 'c');
+static constexpr uint32_t kStrikeCacheFileVersion = 3;
+
+struct StrikeCacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t skiaMilestone;
+    uint32_t padding;
+    uint64_t strikeCount;
+};
+
+struct StrikeCacheFileStrike {
+    uint32_t typefaceHash;
+    uint32_t rasterizerVersion;
+    uint64_t size;  // of the rest of the strike
+};
+
+// Returns a hash of the typeface's font data and variation, or 0 if it has no font data.
+static uint32_t hash_typeface_data(const SkTypeface& typeface) {
+    int ttcIndex;
+    std::unique_ptr<SkStreamAsset> stream = typeface.openStream(&ttcIndex);
+    if (!stream) {
+        return 0;
+    }
+    // Hash the data a chunk at a time, straight from memory if the stream has it there, rather
+    // than copying the whole font. Either way the chunks are the same, and so is the hash.
+    static constexpr size_t kChunkSize = 4096;
+    const size_t length = stream->getLength();
+    uint32_t hash = ttcIndex;
+    if (const char* memory = static_cast<const char*>(stream->getMemoryBase())) {
+        for (size_t offset = 0; offset < length; offset += kChunkSize) {
+            hash = SkOpts::hash(memory + offset, SkTMin(kChunkSize, length - offset), hash);
+        }
+    } else {
+        char chunk[kChunkSize];
+        for (size_t offset = 0; offset < length; offset += kChunkSize) {
+            size_t size = SkTMin(kChunkSize, length - offset);
+            if (stream->read(chunk, size) != size) {
+                return 0;
+            }
+            hash = SkOpts::hash(chunk, size, hash);
+        }
+    }
+
+    int axisCount = typeface.getVariationDesignPosition(nullptr, 0);
+    if (axisCount > 0) {
+        SkAutoSTMalloc<4, SkFontArguments::VariationPosition::Coordinate> coords(axisCount);
+        if (typeface.getVariationDesignPosition(coords.get(), axisCount) == axisCount) {
+            hash = SkOpts::hash(coords.get(), axisCount * sizeof(coords[0]), hash);
+        }
+    }
+    return hash ? hash : 1;
+}
+
+// Like Deserializer::readDescriptor(), but also checks that the descriptor's length is the one
+// it was written with, as the file may have been damaged.
+static bool read_file_descriptor(Deserializer* deserializer, SkAutoDescriptor* ad) {
+    Deserializer peek = *deserializer;
+    uint32_t length = 0;
+    return peek.read<uint32_t>(&length) && length >= sizeof(SkDescriptor) &&
+           deserializer->readDescriptor(ad) && ad->getDesc()->getLength() == length;
+}
+
+static uint64_t strike_key(uint32_t typefaceHash, const SkDescriptor& desc) {
+    return (uint64_t)typefaceHash << 32 | desc.getChecksum();
+}
+
+sk_sp<SkData> SkStrikeCacheFile::Serialize(const SkStrikeCache& strikeCache) {
+    std::vector<uint8_t> buffer;
+    Serializer serializer(&buffer);
+    serializer.emplace<StrikeCacheFileHeader>(kStrikeCacheFileMagic, kStrikeCacheFileVersion,
+                                              (uint32_t)SK_MILESTONE, 0u, 0u);
+    uint64_t strikeCount = 0;
+
+    // Hashing a typeface reads all of its font data, so do it without holding the cache's locks:
+    // note the typefaces first, hash them, and then write the strikes of those we could hash.
+    SkTHashMap<SkFontID, sk_sp<SkTypeface>> typefaces;
+    strikeCache.forEachStrike([&](const SkStrike& strike) {
+        SkTypeface* typeface = strike.getScalerContext()->getTypeface();
+        if (!typefaces.find(typeface->uniqueID())) {
+            typefaces.set(typeface->uniqueID(), sk_ref_sp(typeface));
+        }
+    });
+    SkTHashMap<SkFontID, uint32_t> typefaceHashes;
+    typefaces.foreach([&](SkFontID id, sk_sp<SkTypeface>* typeface) {
+        typefaceHashes.set(id, hash_typeface_data(**typeface));
+    });
+
+    strikeCache.forEachStrike([&](const SkStrike& strike) {
+        const SkScalerContext* scaler = strike.getScalerContext();
+        const uint32_t* typefaceHash = typefaceHashes.find(scaler->getTypeface()->uniqueID());
+        if (!typefaceHash || !*typefaceHash) {
+            return;  // A typeface that's new since we hashed them, or has no font data.
+        }
+
+        // The buffer may move as it grows, so remember where this strike starts.
+        serializer.allocate(0, alignof(StrikeCacheFileStrike));
+        size_t strikeOffset = buffer.size();
+        serializer.emplace<StrikeCacheFileStrike>(*typefaceHash,
+                                                  scaler->getRasterizerVersion(), 0u);
+
+        SkAutoDescriptor ad;
+        serializer.writeDescriptor(*auto_descriptor_from_desc(&strike.getDescriptor(), 0, &ad));
+
+        // Glyphs with images (or empty ones) go with the images, and the rest with the paths,
+        // with or without one, so that their metrics are saved too.
+        std::vector<const SkGlyph*> images, paths;
+        strike.forEachCachedGlyph([&](const SkGlyph& glyph) {
+            bool hasImage = glyph.fImage != nullptr ||
+                            (glyph.isFullMetrics() && glyph.computeImageSize() == 0);
+            if (hasImage) {
+                images.push_back(&glyph);
+            }
+            if (!hasImage || glyph.fPathData != nullptr) {
+                paths.push_back(&glyph);
+            }
+        });
+
+        serializer.emplace<uint64_t>(images.size());
+        for (const SkGlyph* glyph : images) {
+            writeGlyph(glyph, &serializer);
+            auto imageSize = glyph->computeImageSize();
+            if (imageSize == 0u) continue;
+            memcpy(serializer.allocate(imageSize, glyph->formatAlignment()), glyph->fImage,
+                   imageSize);
+        }
+
+        serializer.emplace<uint64_t>(paths.size());
+        for (const SkGlyph* glyph : paths) {
+            writeGlyph(glyph, &serializer);
+            bool hasPath = glyph->fPathData != nullptr && glyph->fPathData->fHasPath;
+            write_path(hasPath ? &glyph->fPathData->fPath : nullptr, &serializer);
+        }
+
+        auto* strikeHeader = reinterpret_cast<StrikeCacheFileStrike*>(&buffer[strikeOffset]);
+        strikeHeader->size = buffer.size() - strikeOffset - sizeof(StrikeCacheFileStrike);
+        strikeCount += 1;
+    });
+
+    reinterpret_cast<StrikeCacheFileHeader*>(buffer.data())->strikeCount = strikeCount;
+    return SkData::MakeWithCopy(buffer.data(), buffer.size());
+}
+
+bool SkStrikeCacheFile::Write(const SkStrikeCache& strikeCache, const char path[]) {
+    sk_sp<SkData> data = Serialize(strikeCache);
+    SkFILEWStream stream(path);
+    return stream.isValid() && stream.write(data->data(), data->size());
+}
+
+sk_sp<SkStrikeCacheFile> SkStrikeCacheFile::Make(sk_sp<SkData> data) {
+    if (!data) {
+        return nullptr;
+    }
+    Deserializer deserializer(static_cast<const volatile char*>(data->data()), data->size());
+
+    StrikeCacheFileHeader header;
+    if (!deserializer.read<StrikeCacheFileHeader>(&header) ||
+        header.magic != kStrikeCacheFileMagic || header.version != kStrikeCacheFileVersion ||
+        header.skiaMilestone != SK_MILESTONE) {
+        return nullptr;
+    }
+
+    // Index the strikes, but leave reading their glyphs until they're needed.
+    sk_sp<SkStrikeCacheFile> file(new SkStrikeCacheFile(data));
+    for (uint64_t i = 0; i < header.strikeCount; ++i) {
+        StrikeCacheFileStrike strike;
+        if (!deserializer.read<StrikeCacheFileStrike>(&strike)) return nullptr;
+        size_t offset = deserializer.bytesRead();
+        if (strike.size > SIZE_MAX) return nullptr;
+        auto* memory = deserializer.read(strike.size, 1);
+        if (!memory) return nullptr;
+
+        Deserializer strikeDeserializer(static_cast<const volatile char*>(memory), strike.size);
+        SkAutoDescriptor ad;
+        if (!read_file_descriptor(&strikeDeserializer, &ad)) return nullptr;
+
+        uint64_t key = strike_key(strike.typefaceHash, *ad.getDesc());
+        if (!file->fStrikes.find(key)) {
+            file->fStrikes.set(key, {offset, (size_t)strike.size, strike.rasterizerVersion});
+        }
+    }
+    return file;
+}
+
+sk_sp<SkStrikeCacheFile> SkStrikeCacheFile::Open(const char path[]) {
+    return Make(SkData::MakeFromFileName(path));
+}
+
+uint32_t SkStrikeCacheFile::typefaceHash(const SkTypeface& typeface) {
+    SkAutoMutexAcquire lock(fTypefaceHashesMutex);
+    uint32_t* hash = fTypefaceHashes.find(typeface.uniqueID());
+    if (!hash) {
+        hash = fTypefaceHashes.set(typeface.uniqueID(), hash_typeface_data(typeface));
+    }
+    return *hash;
+}
+
+void SkStrikeCacheFile::preloadStrike(const SkTypeface& typeface, SkStrike* strike) {
+    uint32_t typefaceHash = this->typefaceHash(typeface);
+    if (!typefaceHash) {
+        return;
+    }
+
+    SkAutoDescriptor ad;
+    auto* desc = auto_descriptor_from_desc(&strike->getDescriptor(), 0, &ad);
+    const Strike* saved = fStrikes.find(strike_key(typefaceHash, *desc));
+    if (!saved || saved->fRasterizerVersion != strike->getScalerContext()->getRasterizerVersion()) {
+        return;
+    }
+
+    Deserializer deserializer(
+            static_cast<const volatile char*>(fData->data()) + saved->fOffset, saved->fSize);
+    SkAutoDescriptor savedAd;
+    if (!read_file_descriptor(&deserializer, &savedAd) || *savedAd.getDesc() != *desc) {
+        return;
+    }
+    // The data was checked when the file was made, so this only fails if it was damaged since,
+    // in which case any glyphs read so far are still valid.
+    (void)read_glyphs(&deserializer, strike);
+}
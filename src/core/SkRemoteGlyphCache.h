@@ -21,10 +21,13 @@
 #include "SkMakeUnique.h"
 #include "SkNoDrawCanvas.h"
 #include "SkRefCnt.h"
+#include "SkMutex.h"
 #include "SkSerialProcs.h"
+#include "SkStrikeCache.h"
 #include "SkStrikeInterface.h"
 #include "SkTypeface.h"
 
+class FrameSerializer;
 class Serializer;
 enum SkAxisAlignment : uint32_t;
 class SkDescriptor;
@@ -33,6 +36,7 @@ struct SkPackedGlyphID;
 enum SkScalerContextFlags : uint32_t;
 class SkStrikeCache;
 class SkTypefaceProxy;
+struct StrikeSpec;
 struct WireTypeface;
 
 class SkStrikeServer;
@@ -124,6 +128,15 @@ public:
     // unlocked after this call.
     void writeStrikeData(std::vector<uint8_t>* memory);
 
+    // Like writeStrikeData(), but in a smaller format for SkStrikeClient::
+    // readCompressedStrikeData(): glyph metrics are delta encoded, images are run
+    // length encoded and paths are packed. The data is split into frames, each
+    // closed once it holds about frameSize bytes, so that it can be sent and read
+    // a frame at a time while the rest is still being written or sent.
+    static constexpr size_t kDefaultFrameSize = 64 * 1024;
+    void writeCompressedStrikeData(std::vector<uint8_t>* memory,
+                                   size_t frameSize = kDefaultFrameSize);
+
     // Methods used internally in skia ------------------------------------------
     class SkGlyphCacheState;
 
@@ -210,10 +223,25 @@ public:
     // Returns false if the data is invalid.
     bool readStrikeData(const volatile void* memory, size_t memorySize);
 
+    // Deserializes whole frames of strike data from
+    // SkStrikeServer::writeCompressedStrikeData(). Frames must be read in the
+    // order they were written, but may be read in any number of calls.
+    // Returns false if the data is invalid, or ends with a partial frame.
+    bool readCompressedStrikeData(const volatile void* memory, size_t memorySize);
+
+    // Returns the size of the whole frames at the start of memory, which can be
+    // passed to readCompressedStrikeData() while the rest is still arriving.
+    static size_t CompleteFramesSize(const void* memory, size_t memorySize);
+
 private:
     class DiscardableStrikePinner;
 
     sk_sp<SkTypeface> addTypeface(const WireTypeface& wire);
+    // Returns the client strike for a strike from the server, or null if the
+    // strike refers to an unknown typeface or has an invalid descriptor.
+    SkExclusiveStrikePtr findOrCreateStrike(const StrikeSpec& spec,
+                                            const SkDescriptor& sourceDesc,
+                                            SkFontMetrics* fontMetrics);
 
     SkTHashMap<SkFontID, sk_sp<SkTypeface>> fRemoteFontIdToTypeface;
     sk_sp<DiscardableHandleManager> fDiscardableHandleManager;
@@ -221,4 +249,52 @@ private:
     const bool fIsLogging;
 };
 
+// Saves the glyphs in an SkStrikeCache, so that a later process can load them instead of making
+// them again. Strikes are keyed by their descriptors and a hash of their typeface's font data,
+// so any process that makes the same typefaces can use them, as long as it's built from the same
+// Skia milestone and rasterizes with the same font library version. To load them, set the file as
+// the cache's preloader:
+//
+//     SkStrikeCache::GlobalStrikeCache()->setPreloader(SkStrikeCacheFile::Open(path));
+//
+// The glyphs are stored like those SkStrikeServer sends to SkStrikeClient.
+class SK_API SkStrikeCacheFile final : public SkStrikePreloader {
+public:
+    // Returns the glyphs of the strikes in strikeCache, for Make().
+    static sk_sp<SkData> Serialize(const SkStrikeCache& strikeCache);
+
+    // Writes the glyphs of the strikes in strikeCache to a file, for Open().
+    static bool Write(const SkStrikeCache& strikeCache, const char path[]);
+
+    // Returns null if data did not come from Serialize().
+    static sk_sp<SkStrikeCacheFile> Make(sk_sp<SkData> data);
+
+    // Memory maps the file. Returns null if it can't be read, or was not made by Write().
+    static sk_sp<SkStrikeCacheFile> Open(const char path[]);
+
+    int strikeCount() const { return fStrikes.count(); }
+
+    // Fills in strike with the glyphs saved for it, if there are any.
+    void preloadStrike(const SkTypeface& typeface, SkStrike* strike) override;
+
+private:
+    struct Strike {
+        size_t   fOffset;
+        size_t   fSize;
+        uint32_t fRasterizerVersion;  // of the scaler context that made the glyphs
+    };
+
+    explicit SkStrikeCacheFile(sk_sp<SkData> data) : fData{std::move(data)} {}
+
+    uint32_t typefaceHash(const SkTypeface& typeface);
+
+    sk_sp<SkData> fData;
+    // Keyed by the typeface hash and the checksum of the descriptor with a zero font id.
+    SkTHashMap<uint64_t, Strike> fStrikes;
+
+    // Hashing the font data is slow, so remember it for each typeface.
+    SkMutex fTypefaceHashesMutex;
+    SkTHashMap<SkFontID, uint32_t> fTypefaceHashes;
+};
+
 #endif  // SkRemoteGlyphCache_DEFINED
@@ -24,6 +24,7 @@ public:
 
     void addGlyph(SkPackedGlyphID, bool pathOnly);
     void writePendingGlyphs(Serializer* serializer);
+    void writePendingGlyphsCompressed(FrameSerializer* serializer);
     SkDiscardableHandleId discardableHandleId() const { return fDiscardableHandleId; }
 
     bool isSubpixel() const { return fIsSubpixel; }
@@ -573,6 +573,23 @@ void SkScalerContext::getImage(const SkGlyph& origGlyph) {
     }
 }
 
+void SkScalerContext::getImages(SkSpan<const SkGlyph* const> glyphs) {
+    // Mask filters and images made from paths go through getImage() one glyph at a time.
+    if (fMaskFilter || fGenerateImageFromPath) {
+        for (const SkGlyph* glyph : glyphs) {
+            this->getImage(*glyph);
+        }
+        return;
+    }
+    this->generateImages(glyphs);
+}
+
+void SkScalerContext::generateImages(SkSpan<const SkGlyph* const> glyphs) {
+    for (const SkGlyph* glyph : glyphs) {
+        this->generateImage(*glyph);
+    }
+}
+
 bool SkScalerContext::getPath(SkPackedGlyphID glyphID, SkPath* path) {
     return this->internalGetPath(glyphID, path);
 }
@@ -279,8 +279,14 @@ public:
     void        getAdvance(SkGlyph*);
     void        getMetrics(SkGlyph*);
     void        getImage(const SkGlyph&);
+    /** Like calling getImage() on each glyph, but lets the scaler set up once for all of them. */
+    void        getImages(SkSpan<const SkGlyph* const>);
     bool SK_WARN_UNUSED_RESULT getPath(SkPackedGlyphID, SkPath*);
     void        getFontMetrics(SkFontMetrics*);
+    /** Identifies the rasterizer that makes this context's glyphs, e.g. the font library and its
+        version, so that glyphs saved by one can be told apart from another's. 0 if unknown.
+     */
+    uint32_t    getRasterizerVersion() const { return this->generateRasterizerVersion(); }
 
     /** Return the size in bytes of the associated gamma lookup table
      */
@@ -375,6 +381,11 @@ protected:
      */
     virtual void generateImage(const SkGlyph& glyph) = 0;
 
+    /** Generates the images of several glyphs, as generateImage does for each.
+     *  Subclasses whose per-glyph setup is costly can override this to do it once.
+     */
+    virtual void generateImages(SkSpan<const SkGlyph* const> glyphs);
+
     /** Sets the passed path to the glyph outline.
      *  If this cannot be done the path is set to empty;
      *  @return false if this glyph does not have any path.
@@ -392,6 +403,9 @@ protected:
      */
     virtual uint16_t generateCharToGlyph(SkUnichar unichar) = 0;
 
+    /** Returns the version of the rasterizer, for getRasterizerVersion(). */
+    virtual uint32_t generateRasterizerVersion() const { return 0; }
+
     void forceGenerateImageFromPath() { fGenerateImageFromPath = true; }
     void forceOffGenerateImageFromPath() { fGenerateImageFromPath = false; }
 
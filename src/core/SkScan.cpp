@@ -15,6 +15,10 @@ std::atomic<bool> gSkForceAnalyticAA{false};
 
 std::atomic<bool> gSkUseDeltaAA{false};
 std::atomic<bool> gSkForceDeltaAA{false};
+std::atomic<bool> gSkUseThreadedDAA{false};
+
+std::atomic<bool> gSkUseSparseAA{false};
+std::atomic<bool> gSkForceSparseAA{false};
 
 static inline void blitrect(SkBlitter* blitter, const SkIRect& r) {
     blitter->blitRect(r.fLeft, r.fTop, r.width(), r.height());
@@ -26,8 +26,11 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseDeltaAA;
 extern std::atomic<bool> gSkForceDeltaAA;
+extern std::atomic<bool> gSkUseThreadedDAA;  // Fill huge DAA paths' deltas in bands, in parallel.
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+extern std::atomic<bool> gSkUseSparseAA;
+extern std::atomic<bool> gSkForceSparseAA;
 
 class AdditiveBlitter;
 
@@ -77,6 +80,11 @@ public:
     static void AntiFillPath(const SkPath& path, const SkRasterClip& rc, SkBlitter* blitter) {
         AntiFillPath(path, rc, blitter, nullptr);
     }
+
+    // Fills a non-inverse path with 16x16 tiles, blitting the tiles inside the path as solid
+    // rects and spans. AntiFillPath picks it when gSkUseSparseAA is set; public for tests.
+    static void SparseFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                               const SkIRect& clipBounds);
 private:
     friend class SkAAClip;
     friend class SkRegion;
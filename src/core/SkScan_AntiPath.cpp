@@ -718,6 +718,25 @@ static bool ShouldUseAAA(const SkPath& path, SkScalar avgLength, SkScalar comple
 #endif
 }
 
+static bool ShouldUseSparseAA(const SkPath& path, const SkIRect& ir, const SkIRect& clipBounds,
+                              bool forceRLE) {
+    // Sparse AA blits whole tiles, not rows in order, so it can't feed the RLE blitters.
+    if (forceRLE || path.isInverseFillType()) {
+        return false;
+    }
+    if (gSkForceSparseAA) {
+        return true;
+    }
+    if (!gSkUseSparseAA) {
+        return false;
+    }
+    // It only pays off when there are interior tiles to skip, so at least a few tiles.
+    constexpr int kMinSize = 32;
+    SkIRect clippedIR;
+    return clippedIR.intersect(ir, clipBounds) &&
+           clippedIR.width() >= kMinSize && clippedIR.height() >= kMinSize;
+}
+
 void SkScan::SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
                   const SkIRect& clipBounds, bool forceRLE) {
     bool containedInClip = clipBounds.contains(ir);
@@ -838,6 +857,8 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
     if (daaRecord || ShouldUseDAA(path, avgLength, complexity)) {
         SkScan::DAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, daaRecord);
+    } else if (ShouldUseSparseAA(path, ir, clipRgn->getBounds(), forceRLE)) {
+        SkScan::SparseFillPath(path, blitter, ir, clipRgn->getBounds());
     } else if (ShouldUseAAA(path, avgLength, complexity)) {
         // Do not use AAA if path is too complicated:
         // there won't be any speedup or significant visual improvement.
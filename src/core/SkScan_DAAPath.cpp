@@ -21,6 +21,7 @@
 #include "SkScan.h"
 #include "SkScanPriv.h"
 #include "SkTSort.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUTF.h"
 
@@ -156,76 +157,29 @@ public:
     }
 };
 
-template<class Deltas> static SK_ALWAYS_INLINE
-void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRect& clipBounds,
-        Deltas& result, SkBlitter* blitter, bool skipRect, bool pathContainedInClip) {
-    // 1. Build edges
-    SkBezierEdgeBuilder builder;
-    // We have to use clipBounds instead of clippedIR to build edges because of "canCullToTheRight":
-    // if the builder finds a right edge past the right clip, it won't build that right edge.
-    int  count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipBounds);
-
-    if (count == 0) {
-        return;
+// Whether bezier may add deltas to rows [top, bottom). The points of a bezier bound it, and
+// snapping its edges to a fraction of a pixel can't move them past a whole row.
+static inline bool bezier_may_touch_rows(const SkBezier* bezier, int top, int bottom) {
+    SkScalar minY = SkTMin(bezier->fP0.fY, bezier->fP1.fY);
+    SkScalar maxY = SkTMax(bezier->fP0.fY, bezier->fP1.fY);
+    if (bezier->fCount >= 3) {
+        const SkQuad* quad = static_cast<const SkQuad*>(bezier);
+        minY = SkTMin(minY, quad->fP2.fY);
+        maxY = SkTMax(maxY, quad->fP2.fY);
     }
-    SkBezier** list = builder.bezierList();
-
-    // 2. Try to find the rect part because blitAntiRect is so much faster than blitCoverageDeltas
-    int rectTop = clippedIR.fBottom;   // the rect is initialized to be empty as top = bot
-    int rectBot = clippedIR.fBottom;
-    if (skipRect) {             // only find that rect is skipRect == true
-        YLessThan lessThan;     // sort edges in YX order
-        SkTQSort(list, list + count - 1, lessThan);
-        for(int i = 0; i < count - 1; ++i) {
-            SkBezier* lb = list[i];
-            SkBezier* rb = list[i + 1];
-
-            // fCount == 2 ensures that lb and rb are lines instead of quads or cubics.
-            bool lDX0 = lb->fP0.fX == lb->fP1.fX && lb->fCount == 2;
-            bool rDX0 = rb->fP0.fX == rb->fP1.fX && rb->fCount == 2;
-            if (!lDX0 || !rDX0) { // make sure that the edges are vertical
-                continue;
-            }
-
-            SkAnalyticEdge l, r;
-            if (!l.setLine(lb->fP0, lb->fP1) || !r.setLine(rb->fP0, rb->fP1)) {
-                continue;
-            }
-
-            SkFixed xorUpperY = l.fUpperY ^ r.fUpperY;
-            SkFixed xorLowerY = l.fLowerY ^ r.fLowerY;
-            if ((xorUpperY | xorLowerY) == 0) { // equal upperY and lowerY
-                rectTop = SkFixedCeilToInt(l.fUpperY);
-                rectBot = SkFixedFloorToInt(l.fLowerY);
-                if (rectBot > rectTop) { // if bot == top, the rect is too short for blitAntiRect
-                    int L = SkFixedCeilToInt(l.fUpperX);
-                    int R = SkFixedFloorToInt(r.fUpperX);
-                    if (L <= R) {
-                        SkAlpha la = (SkIntToFixed(L) - l.fUpperX) >> 8;
-                        SkAlpha ra = (r.fUpperX - SkIntToFixed(R)) >> 8;
-                        result.setAntiRect(L - 1, rectTop, R - L, rectBot - rectTop, la, ra);
-                    } else { // too thin to use blitAntiRect; reset the rect region to be emtpy
-                        rectTop = rectBot = clippedIR.fBottom;
-                    }
-                }
-                break;
-            }
-
-        }
-    }
-
-    // 3. Sort edges in x so we may need less sorting for delta based on x. This only helps
-    //    SkCoverageDeltaList. And we don't want to sort more than SORT_THRESHOLD edges where
-    //    the log(count) factor of the quick sort may become a bottleneck; when there are so
-    //    many edges, we're unlikely to make deltas sorted anyway.
-    constexpr int SORT_THRESHOLD = 256;
-    if (std::is_same<Deltas, SkCoverageDeltaList>::value && count < SORT_THRESHOLD) {
-        XLessThan lessThan;
-        SkTQSort(list, list + count - 1, lessThan);
+    if (bezier->fCount == 4) {
+        const SkCubic* cubic = static_cast<const SkCubic*>(bezier);
+        minY = SkTMin(minY, cubic->fP3.fY);
+        maxY = SkTMax(maxY, cubic->fP3.fY);
     }
+    return maxY + 1 > top && minY - 1 < bottom;
+}
 
-    // Future todo: parallize and SIMD the following code.
-    // 4. iterate through edges and generate deltas
+// Generate the deltas of edges list[0..count) that fall on rows [top, bottom). Rows
+// [rectTop, rectBot) are covered by the anti-rect, so vertical edges skip them.
+template<class Deltas> static SK_ALWAYS_INLINE
+void add_edge_deltas(SkBezier** list, int count, int top, int bottom, int rectTop, int rectBot,
+        Deltas& result) {
     for(int index = 0; index < count; ++index) {
         SkAnalyticCubicEdge storage;
         SkASSERT(sizeof(SkAnalyticQuadraticEdge) >= sizeof(SkAnalyticEdge));
@@ -235,6 +189,10 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
         SkAnalyticEdge* currE   = &storage;
         bool edgeSet            = false;
 
+        if (!bezier_may_touch_rows(bezier, top, bottom)) {
+            continue;
+        }
+
         int originalWinding = 1;
         bool sortY = true;
         switch (bezier->fCount) {
@@ -271,10 +229,16 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
             SkFixed lowerCeil   = SkFixedCeilToFixed(currE->fLowerY);
             int     iy          = SkFixedFloorToInt(upperFloor);
 
+            // Skip segments entirely above or below our rows. (Cubic edges aren't necessarily
+            // sorted in y, so a segment below our rows doesn't mean that the rest of them are.)
+            if (lowerCeil <= SkIntToFixed(top) || upperFloor >= SkIntToFixed(bottom)) {
+                continue;
+            }
+
             if (lowerCeil <= upperFloor + SK_Fixed1) { // only one row is affected by the currE
                 SkFixed rowHeight = currE->fLowerY - currE->fUpperY;
                 SkFixed nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
-                if (iy >= clippedIR.fTop && iy < clippedIR.fBottom) {
+                if (iy >= top && iy < bottom) {
                     add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
                 }
                 continue;
@@ -285,20 +249,30 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
             SkFixed nextX;
             if (rowHeight != SK_Fixed1) {   // it's a partial row
                 nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
-                add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                if (iy >= top) {
+                    add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                }
             } else {                        // it's a full row so we can leave it to the while loop
                 iy--;                       // compensate the iy++ in the while loop
                 nextX = currE->fX;
             }
 
+            // Jump over the full rows above ours. x moves by exactly fDX per full row, so this
+            // lands on the same nextX as walking those rows one by one.
+            int skipRows = SkTMin(top, SkFixedFloorToInt(currE->fLowerY)) - 1 - iy;
+            if (skipRows > 0) {
+                iy    += skipRows;
+                nextX += skipRows * currE->fDX;
+            }
+
             while (true) { // process the full rows in the middle
                 iy++;
                 SkFixed y = SkIntToFixed(iy);
                 currE->fX = nextX;
                 nextX += currE->fDX;
 
-                if (y + SK_Fixed1 > currE->fLowerY) {
-                    break; // no full rows left, break
+                if (y + SK_Fixed1 > currE->fLowerY || iy >= bottom) {
+                    break; // no full rows left (on our rows), break
                 }
 
                 // Check whether we're in the rect part that will be covered by blitAntiRect
@@ -313,8 +287,7 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
             }
 
             // last partial row
-            if (SkIntToFixed(iy) < currE->fLowerY &&
-                    iy >= clippedIR.fTop && iy < clippedIR.fBottom) {
+            if (SkIntToFixed(iy) < currE->fLowerY && iy >= top && iy < bottom) {
                 rowHeight = currE->fLowerY - SkIntToFixed(iy);
                 nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
                 add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
@@ -324,6 +297,128 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
     }
 }
 
+template<class Deltas>
+static void add_all_edge_deltas(SkBezier** list, int count, const SkIRect& clippedIR,
+        int rectTop, int rectBot, Deltas& result, SkArenaAlloc*) {
+    add_edge_deltas(list, count, clippedIR.fTop, clippedIR.fBottom, rectTop, rectBot, result);
+}
+
+// The number of bands that gSkUseThreadedDAA splits a path with count edges into.
+static int threaded_band_count(int count, const SkIRect& clippedIR) {
+    constexpr int kMinBandHeight    = 32;
+    constexpr int kMinEdgesPerBand  = 256;
+    constexpr int kMaxBands         = 64;
+    if (!gSkUseThreadedDAA) {
+        return 1;
+    }
+    return SkTMin(SkTMin(clippedIR.height() / kMinBandHeight, count / kMinEdgesPerBand),
+                  kMaxBands);
+}
+
+// SkCoverageDeltaList keeps the deltas of each row separately, so huge paths can be split into
+// horizontal bands of rows that are filled in parallel. Every band walks the edges in the same
+// order (skipping those that can't reach it), so every row gets exactly the same deltas, in the
+// same order, as it would from a single walk.
+static void add_all_edge_deltas(SkBezier** list, int count, const SkIRect& clippedIR,
+        int rectTop, int rectBot, SkCoverageDeltaList& result, SkArenaAlloc* alloc) {
+    int bands = threaded_band_count(count, clippedIR);
+    if (bands <= 1) {
+        add_edge_deltas(list, count, clippedIR.fTop, clippedIR.fBottom, rectTop, rectBot, result);
+        return;
+    }
+
+    // Rows that outgrow their initial storage are reallocated from their band's own alloc, so
+    // the bands never share an allocator. Like the list, these allocs live as long as alloc.
+    constexpr size_t kBandAllocSize = 4096;
+    SkArenaAlloc** bandAllocs = alloc->makeArrayDefault<SkArenaAlloc*>(bands);
+    for (int i = 0; i < bands; ++i) {
+        bandAllocs[i] = alloc->make<SkArenaAlloc>(kBandAllocSize);
+    }
+
+    int bandHeight = (clippedIR.height() + bands - 1) / bands;
+    SkTaskGroup().batch(bands, [&](int i) {
+        int top    = clippedIR.fTop + i * bandHeight;
+        int bottom = SkTMin(top + bandHeight, clippedIR.fBottom);
+        if (top < bottom) {
+            SkCoverageDeltaList band(bandAllocs[i], &result, top, bottom);
+            add_edge_deltas(list, count, top, bottom, rectTop, rectBot, band);
+        }
+    });
+}
+
+template<class Deltas> static SK_ALWAYS_INLINE
+void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRect& clipBounds,
+        Deltas& result, SkBlitter* blitter, bool skipRect, bool pathContainedInClip,
+        SkArenaAlloc* alloc) {
+    // 1. Build edges
+    SkBezierEdgeBuilder builder;
+    // We have to use clipBounds instead of clippedIR to build edges because of "canCullToTheRight":
+    // if the builder finds a right edge past the right clip, it won't build that right edge.
+    int  count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipBounds);
+
+    if (count == 0) {
+        return;
+    }
+    SkBezier** list = builder.bezierList();
+
+    // 2. Try to find the rect part because blitAntiRect is so much faster than blitCoverageDeltas
+    int rectTop = clippedIR.fBottom;   // the rect is initialized to be empty as top = bot
+    int rectBot = clippedIR.fBottom;
+    if (skipRect) {             // only find that rect is skipRect == true
+        YLessThan lessThan;     // sort edges in YX order
+        SkTQSort(list, list + count - 1, lessThan);
+        for(int i = 0; i < count - 1; ++i) {
+            SkBezier* lb = list[i];
+            SkBezier* rb = list[i + 1];
+
+            // fCount == 2 ensures that lb and rb are lines instead of quads or cubics.
+            bool lDX0 = lb->fP0.fX == lb->fP1.fX && lb->fCount == 2;
+            bool rDX0 = rb->fP0.fX == rb->fP1.fX && rb->fCount == 2;
+            if (!lDX0 || !rDX0) { // make sure that the edges are vertical
+                continue;
+            }
+
+            SkAnalyticEdge l, r;
+            if (!l.setLine(lb->fP0, lb->fP1) || !r.setLine(rb->fP0, rb->fP1)) {
+                continue;
+            }
+
+            SkFixed xorUpperY = l.fUpperY ^ r.fUpperY;
+            SkFixed xorLowerY = l.fLowerY ^ r.fLowerY;
+            if ((xorUpperY | xorLowerY) == 0) { // equal upperY and lowerY
+                rectTop = SkFixedCeilToInt(l.fUpperY);
+                rectBot = SkFixedFloorToInt(l.fLowerY);
+                if (rectBot > rectTop) { // if bot == top, the rect is too short for blitAntiRect
+                    int L = SkFixedCeilToInt(l.fUpperX);
+                    int R = SkFixedFloorToInt(r.fUpperX);
+                    if (L <= R) {
+                        SkAlpha la = (SkIntToFixed(L) - l.fUpperX) >> 8;
+                        SkAlpha ra = (r.fUpperX - SkIntToFixed(R)) >> 8;
+                        result.setAntiRect(L - 1, rectTop, R - L, rectBot - rectTop, la, ra);
+                    } else { // too thin to use blitAntiRect; reset the rect region to be emtpy
+                        rectTop = rectBot = clippedIR.fBottom;
+                    }
+                }
+                break;
+            }
+
+        }
+    }
+
+    // 3. Sort edges in x so we may need less sorting for delta based on x. This only helps
+    //    SkCoverageDeltaList. And we don't want to sort more than SORT_THRESHOLD edges where
+    //    the log(count) factor of the quick sort may become a bottleneck; when there are so
+    //    many edges, we're unlikely to make deltas sorted anyway.
+    constexpr int SORT_THRESHOLD = 256;
+    if (std::is_same<Deltas, SkCoverageDeltaList>::value && count < SORT_THRESHOLD) {
+        XLessThan lessThan;
+        SkTQSort(list, list + count - 1, lessThan);
+    }
+
+    // 4. iterate through edges and generate deltas
+    add_all_edge_deltas(list, count, clippedIR, rectTop, rectBot, result, alloc);
+}
+
 void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
                          const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record) {
     bool containedInClip = clipBounds.contains(ir);
@@ -368,7 +463,7 @@ void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect&
             record->fType = SkDAARecord::Type::kMask;
             SkCoverageDeltaMask deltaMask(alloc, clippedIR);
             gen_alpha_deltas(path, clippedIR, clipBounds, deltaMask, blitter, skipRect,
-                             containedInClip);
+                             containedInClip, alloc);
             deltaMask.convertCoverageToAlpha(isEvenOdd, isInverse, isConvex);
             record->fMask = deltaMask.prepareSkMask();
         } else {
@@ -376,7 +471,7 @@ void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect&
             SkCoverageDeltaList* deltaList = alloc->make<SkCoverageDeltaList>(
                     alloc, clippedIR, forceRLE);
             gen_alpha_deltas(path, clippedIR, clipBounds, *deltaList, blitter, skipRect,
-                             containedInClip);
+                             containedInClip, alloc);
             record->fList = deltaList;
         }
     }
@@ -0,0 +1,381 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitter.h"
+#include "SkGeometry.h"
+#include "SkMask.h"
+#include "SkPath.h"
+#include "SkScan.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+#include <cmath>
+
+/*
+
+Sparse AA is a sort-middle tile rasterizer:
+
+1. Flatten the path into line segments and clip them to the clip's rows. The parts of segments to
+   the left of the clip move onto its left edge (they still wind everything to their right), and
+   the parts to the right of the clip are dropped, as coverage only flows to the right.
+
+2. Turn every segment into signed area deltas on the pixels it crosses, like DAA does: the
+   coverage of a pixel is the sum of the deltas to its left (inclusive) on its row. Each delta is
+   binned into the 16x16 tile it falls in, and then all deltas are sorted by tile.
+
+3. Walk each row of tiles from left to right, carrying along the winding of each of its 16 pixel
+   rows: the backdrop of the next tile. Tiles with deltas are boundary tiles, which we accumulate
+   into alphas and blit as masks (or rects, when they turn out solid). The tiles between boundary
+   tiles have no edges at all, so each of their rows has the constant coverage of its backdrop,
+   and we blit them as rects and spans without ever looking at their pixels.
+
+*/
+
+static constexpr int      kTileShift        = 4;
+static constexpr int      kTileSize         = 1 << kTileShift;
+static constexpr int      kTileMask         = kTileSize - 1;
+static constexpr SkScalar kFlattenTolerance = 0.25f;
+static constexpr int      kMaxSubdivisions  = 256;
+
+namespace {
+
+struct SparseDelta {
+    uint32_t fTile;     // (tileY << 16) | tileX, in tiles from the clip's top left
+    uint8_t  fX, fY;    // the pixel within the tile
+    float    fDelta;
+
+    bool operator<(const SparseDelta& other) const { return fTile < other.fTile; }
+};
+
+class SparseRasterizer {
+public:
+    SparseRasterizer(const SkIRect& clip, bool isEvenOdd)
+        : fClip(clip)
+        , fWidth(clip.width())
+        , fHeight(clip.height())
+        , fIsEvenOdd(isEvenOdd) {}
+
+    void addPath(const SkPath& path);
+    void blit(SkBlitter* blitter);
+
+private:
+    // Points are relative to the clip's top left.
+    void addLine(SkPoint p0, SkPoint p1);
+    void addClippedLine(SkPoint p0, SkPoint p1, float dir);
+    void addQuad(const SkPoint pts[3]);
+    void addCubic(const SkPoint pts[4]);
+
+    void addDelta(int x, int y, float delta) {
+        if (x >= fWidth || delta == 0) {
+            return;
+        }
+        SkASSERT(x >= 0 && y >= 0 && y < fHeight);
+        *fDeltas.append() = { (uint32_t)(y >> kTileShift) << 16 | (uint32_t)(x >> kTileShift),
+                              (uint8_t)(x & kTileMask), (uint8_t)(y & kTileMask), delta };
+    }
+
+    SkAlpha coverageToAlpha(float coverage) const {
+        coverage = std::abs(coverage);
+        if (fIsEvenOdd) {
+            coverage = std::fmod(coverage, 2.0f);
+            coverage = coverage > 1 ? 2 - coverage : coverage;
+        }
+        return (SkAlpha)(SkTMin(coverage, 1.0f) * 255 + 0.5f);
+    }
+
+    // Blits columns [left, right) of the tile row at top, where every row is solid backdrop.
+    void blitBackdrop(SkBlitter*, int left, int right, int top, int rows,
+                      const float backdrop[], int16_t runs[], SkAlpha aa[]) const;
+
+    const SkIRect           fClip;
+    const int               fWidth;
+    const int               fHeight;
+    const bool              fIsEvenOdd;
+    SkTDArray<SparseDelta>  fDeltas;
+};
+
+void SparseRasterizer::addPath(const SkPath& path) {
+    const SkVector offset = { -SkIntToScalar(fClip.fLeft), -SkIntToScalar(fClip.fTop) };
+
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        for (SkPoint& pt : pts) {
+            pt += offset;
+        }
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                this->addLine(pts[0], pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                this->addQuad(pts);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads converter;
+                const SkPoint* quads = converter.computeQuads(pts, iter.conicWeight(),
+                                                              kFlattenTolerance);
+                for (int i = 0; i < converter.countQuads(); ++i) {
+                    this->addQuad(quads + 2 * i);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                this->addCubic(pts);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static int subdivisions(SkScalar deviation, SkScalar scale) {
+    // A curve whose second difference is deviation strays at most deviation * scale / n^2 from
+    // n lines through n+1 evenly spaced points on it.
+    SkScalar n = SkScalarCeilToScalar(SkScalarSqrt(deviation * scale / kFlattenTolerance));
+    return SkTPin(SkScalarIsFinite(n) ? (int)n : kMaxSubdivisions, 1, kMaxSubdivisions);
+}
+
+void SparseRasterizer::addQuad(const SkPoint pts[3]) {
+    int n = subdivisions((pts[0] - pts[1] - pts[1] + pts[2]).length(), 0.125f);
+    SkPoint prev = pts[0];
+    for (int i = 1; i < n; ++i) {
+        SkScalar t = SkIntToScalar(i) / n,
+                 s = 1 - t;
+        SkPoint next = pts[0] * (s * s) + pts[1] * (2 * s * t) + pts[2] * (t * t);
+        this->addLine(prev, next);
+        prev = next;
+    }
+    this->addLine(prev, pts[2]);
+}
+
+void SparseRasterizer::addCubic(const SkPoint pts[4]) {
+    SkScalar deviation = SkTMax((pts[0] - pts[1] - pts[1] + pts[2]).length(),
+                                (pts[1] - pts[2] - pts[2] + pts[3]).length());
+    int n = subdivisions(deviation, 0.75f);
+    SkPoint prev = pts[0];
+    for (int i = 1; i < n; ++i) {
+        SkScalar t = SkIntToScalar(i) / n,
+                 s = 1 - t;
+        SkPoint next = pts[0] * (s * s * s) + pts[1] * (3 * s * s * t) +
+                       pts[2] * (3 * s * t * t) + pts[3] * (t * t * t);
+        this->addLine(prev, next);
+        prev = next;
+    }
+    this->addLine(prev, pts[3]);
+}
+
+void SparseRasterizer::addLine(SkPoint p0, SkPoint p1) {
+    // Orient the line downwards, remembering its winding.
+    float dir = 1;
+    if (p0.fY > p1.fY) {
+        std::swap(p0, p1);
+        dir = -1;
+    }
+    if (p0.fY == p1.fY || p1.fY <= 0 || p0.fY >= fHeight) {
+        return;
+    }
+
+    // Chop it to the clip's rows.
+    auto xAtY = [&](float y) { return p0.fX + (p1.fX - p0.fX) * ((y - p0.fY) / (p1.fY - p0.fY)); };
+    if (p0.fY < 0) {
+        p0 = { xAtY(0), 0 };
+    }
+    if (p1.fY > fHeight) {
+        p1 = { xAtY(fHeight), (float)fHeight };
+    }
+
+    // Split it where it crosses the clip's left and right edges.
+    float ts[4] = { 0, 0, 0, 1 };
+    int   count = 1;
+    for (float edge : { 0.0f, (float)fWidth }) {
+        if ((p0.fX - edge) * (p1.fX - edge) < 0) {
+            ts[count++] = (edge - p0.fX) / (p1.fX - p0.fX);
+        }
+    }
+    if (count == 3 && ts[1] > ts[2]) {
+        std::swap(ts[1], ts[2]);
+    }
+    ts[count] = 1;
+
+    SkPoint start = p0;
+    for (int i = 1; i <= count; ++i) {
+        SkPoint end = i == count ? p1 : p0 + (p1 - p0) * ts[i];
+        float midX = 0.5f * (start.fX + end.fX);
+        if (midX < fWidth) {
+            // Left of the clip, the line becomes a vertical one on the clip's left edge.
+            SkPoint a = { SkTPin(start.fX, 0.0f, (float)fWidth), start.fY },
+                    b = { SkTPin(end  .fX, 0.0f, (float)fWidth), end  .fY };
+            this->addClippedLine(a, b, dir);
+        }
+        start = end;
+    }
+}
+
+void SparseRasterizer::addClippedLine(SkPoint p0, SkPoint p1, float dir) {
+    if (p0.fY >= p1.fY) {
+        return;
+    }
+    const float dxdy = (p1.fX - p0.fX) / (p1.fY - p0.fY);
+    const int   yEnd = SkTMin((int)std::ceil(p1.fY), fHeight);
+    for (int y = (int)p0.fY; y < yEnd; ++y) {
+        float top    = SkTMax((float)y, p0.fY),
+              bottom = SkTMin((float)y + 1, p1.fY),
+              dy     = bottom - top;
+        if (dy <= 0) {
+            continue;
+        }
+        float xTop    = p0.fX + (top    - p0.fY) * dxdy,
+              xBottom = p0.fX + (bottom - p0.fY) * dxdy,
+              x0      = SkTMax(SkTMin(xTop, xBottom), 0.0f),
+              x1      = SkTMax(xTop, xBottom),
+              d       = dy * dir;
+        int   x0i     = (int)x0,
+              x1i     = (int)std::ceil(x1);
+
+        if (x1i <= x0i + 1) {
+            // The line stays within one pixel on this row; xmf is its average x in that pixel.
+            float xmf = 0.5f * (xTop + xBottom) - x0i;
+            this->addDelta(x0i,     y, d - d * xmf);
+            this->addDelta(x0i + 1, y, d * xmf);
+            continue;
+        }
+
+        // The line crosses several pixels: a triangle in the first, trapezoids in the middle,
+        // and the rest of the area in the last.
+        float s   = 1 / (x1 - x0),
+              x0f = x0 - x0i,
+              a0  = 0.5f * s * (1 - x0f) * (1 - x0f),
+              x1f = x1 - x1i + 1,
+              am  = 0.5f * s * x1f * x1f;
+        this->addDelta(x0i, y, d * a0);
+        if (x1i == x0i + 2) {
+            this->addDelta(x0i + 1, y, d * (1 - a0 - am));
+        } else {
+            float a1 = s * (1.5f - x0f);
+            this->addDelta(x0i + 1, y, d * (a1 - a0));
+            for (int x = x0i + 2; x < x1i - 1; ++x) {
+                this->addDelta(x, y, d * s);
+            }
+            float a2 = a1 + (x1i - x0i - 3) * s;
+            this->addDelta(x1i - 1, y, d * (1 - a2 - am));
+        }
+        this->addDelta(x1i, y, d * am);
+    }
+}
+
+void SparseRasterizer::blitBackdrop(SkBlitter* blitter, int left, int right, int top, int rows,
+                                    const float backdrop[], int16_t runs[], SkAlpha aa[]) const {
+    if (left >= right) {
+        return;
+    }
+    const int width = right - left;
+    for (int r = 0; r < rows; ) {
+        SkAlpha alpha = this->coverageToAlpha(backdrop[r]);
+        if (alpha == 0xFF) {
+            // Solid rows: merge all that follow into one rect.
+            int height = 1;
+            while (r + height < rows && this->coverageToAlpha(backdrop[r + height]) == 0xFF) {
+                height++;
+            }
+            blitter->blitRect(fClip.fLeft + left, fClip.fTop + top + r, width, height);
+            r += height;
+            continue;
+        }
+        if (alpha) {
+            runs[0]     = SkToS16(width);
+            runs[width] = 0;
+            aa[0]       = alpha;
+            blitter->blitAntiH(fClip.fLeft + left, fClip.fTop + top + r, aa, runs);
+        }
+        r++;
+    }
+}
+
+void SparseRasterizer::blit(SkBlitter* blitter) {
+    const int count = fDeltas.count();
+    if (count == 0) {
+        return;
+    }
+    SkTQSort(fDeltas.begin(), fDeltas.end() - 1);
+
+    SkAutoTMalloc<int16_t> runs(fWidth + 1);
+    SkAutoTMalloc<SkAlpha> aa(fWidth + 1);
+
+    for (int i = 0; i < count; ) {
+        const uint32_t tileY = fDeltas[i].fTile >> 16;
+        const int      top   = tileY << kTileShift,
+                       rows  = SkTMin(kTileSize, fHeight - top);
+
+        float backdrop[kTileSize] = {0};
+        int   blitted = 0;     // columns to the left of this have been blitted
+        while (i < count && fDeltas[i].fTile >> 16 == tileY) {
+            // The solid tiles up to this boundary tile.
+            const uint32_t tile  = fDeltas[i].fTile;
+            const int      left  = (tile & 0xFFFF) << kTileShift,
+                           cols  = SkTMin(kTileSize, fWidth - left);
+            this->blitBackdrop(blitter, blitted, left, top, rows, backdrop, runs, aa);
+            blitted = left + cols;
+
+            // The boundary tile itself.
+            float deltas[kTileSize][kTileSize] = {{0}};
+            for (; i < count && fDeltas[i].fTile == tile; ++i) {
+                deltas[fDeltas[i].fY][fDeltas[i].fX] += fDeltas[i].fDelta;
+            }
+
+            SkAlpha alphas[kTileSize * kTileSize];
+            bool allClear = true,
+                 allSolid = true;
+            for (int y = 0; y < rows; ++y) {
+                float coverage = backdrop[y];
+                for (int x = 0; x < cols; ++x) {
+                    coverage += deltas[y][x];
+                    SkAlpha alpha = this->coverageToAlpha(coverage);
+                    alphas[y * kTileSize + x] = alpha;
+                    allClear = allClear && alpha == 0;
+                    allSolid = allSolid && alpha == 0xFF;
+                }
+                // Deltas past the clip's right edge were dropped, so finish the row ourselves.
+                for (int x = cols; x < kTileSize; ++x) {
+                    coverage += deltas[y][x];
+                }
+                backdrop[y] = coverage;
+            }
+
+            const SkIRect bounds = SkIRect::MakeXYWH(fClip.fLeft + left, fClip.fTop + top,
+                                                     cols, rows);
+            if (allSolid) {
+                blitter->blitRect(bounds.fLeft, bounds.fTop, cols, rows);
+            } else if (!allClear) {
+                SkMask mask;
+                mask.fImage    = alphas;
+                mask.fBounds   = bounds;
+                mask.fRowBytes = kTileSize;
+                mask.fFormat   = SkMask::kA8_Format;
+                blitter->blitMask(mask, bounds);
+            }
+        }
+        // Whatever is still wound past the last boundary tile extends to the clip's right edge.
+        this->blitBackdrop(blitter, blitted, fWidth, top, rows, backdrop, runs, aa);
+    }
+}
+
+}  // namespace
+
+void SkScan::SparseFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
+                            const SkIRect& clipBounds) {
+    SkASSERT(!path.isInverseFillType());
+    SkIRect clippedIR;
+    if (!clippedIR.intersect(ir, clipBounds)) {
+        return;
+    }
+
+    SparseRasterizer rasterizer(clippedIR, path.getFillType() == SkPath::kEvenOdd_FillType);
+    rasterizer.addPath(path);
+    rasterizer.blit(blitter);
+}
@@ -7,13 +7,16 @@
 
 #include "SkStrike.h"
 
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkMakeUnique.h"
 #include "SkMutex.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
+#include <atomic>
 #include <cctype>
 
 namespace {
@@ -59,6 +62,10 @@ bool SkStrike::isGlyphCached(SkGlyphID glyphID, SkFixed x, SkFixed y) const {
     return fGlyphMap.find(packedGlyphID) != nullptr;
 }
 
+const SkGlyph* SkStrike::getCachedGlyph(SkPackedGlyphID packedGlyphID) const {
+    return fGlyphMap.findOrNull(packedGlyphID);
+}
+
 SkGlyph* SkStrike::getRawGlyphByID(SkPackedGlyphID id) {
     return lookupByPackedGlyphID(id, kNothing_MetricsType);
 }
@@ -141,6 +148,83 @@ const void* SkStrike::findImage(const SkGlyph& glyph) {
     return glyph.fImage;
 }
 
+const void* SkStrike::findAtlasImage(const SkGlyph& glyph, size_t* rowBytes) {
+    if (!SkGlyphAtlas::CanHold(glyph)) {
+        return nullptr;
+    }
+    if (fAtlas == nullptr) {
+        fAtlas = skstd::make_unique<SkGlyphAtlas>();
+    }
+    if (const void* image = fAtlas->find(glyph, rowBytes)) {
+        return image;
+    }
+    const void* image = this->findImage(glyph);
+    if (image == nullptr) {
+        return nullptr;
+    }
+    size_t bytesAllocated;
+    image = fAtlas->add(glyph, image, rowBytes, &bytesAllocated);
+    fMemoryUsed += bytesAllocated;
+    return image;
+}
+
+void SkStrike::prepareImages(SkSpan<const SkGlyph* const> glyphs, SkExecutor* executor) {
+    // fAlloc isn't thread safe, so allocate all the images up front; the tasks only fill them in.
+    std::vector<const SkGlyph*> toMake;
+    for (const SkGlyph* glyph : glyphs) {
+        SkASSERT(this->belongsToCache(glyph));
+        if (glyph->fWidth > 0 && glyph->fWidth < kMaxGlyphWidth && nullptr == glyph->fImage) {
+            size_t size = const_cast<SkGlyph*>(glyph)->allocImage(&fAlloc);
+            if (glyph->fImage) {
+                fMemoryUsed += size;
+                toMake.push_back(glyph);
+            }
+        }
+    }
+
+    // Each task takes batches of glyphs from toMake until they run out. Tasks only make their own
+    // scaler context once they get a batch, so tasks that find no work left on a busy executor are
+    // cheap. Batches are kept small because a scaler may hold a process-wide lock (FreeType's) for
+    // a whole batch, which would stall every other thread's glyphs.
+    static constexpr int kGlyphsPerBatch = 8;
+    static constexpr int kMinGlyphsPerTask = 16;
+    static constexpr int kMaxTasks = 16;
+    SkSpan<const SkGlyph* const> all{toMake.data(), toMake.size()};
+    std::atomic<size_t> next{0};
+    auto nextBatch = [&]() {
+        size_t start = SkTMin(next.fetch_add(kGlyphsPerBatch, std::memory_order_relaxed),
+                              all.size());
+        return SkSpan<const SkGlyph* const>{all.data() + start,
+                                            SkTMin<size_t>(kGlyphsPerBatch, all.size() - start)};
+    };
+
+    int taskCount = SkTMin(SkToInt(toMake.size()) / kMinGlyphsPerTask, kMaxTasks);
+    if (executor == nullptr || taskCount < 2) {
+        for (auto batch = nextBatch(); !batch.empty(); batch = nextBatch()) {
+            fScalerContext->getImages(batch);
+        }
+        return;
+    }
+
+    SkScalerContextEffects effects = fScalerContext->getEffects();
+    SkTaskGroup tasks(*executor);
+    tasks.batch(taskCount, [&](int) {
+        std::unique_ptr<SkScalerContext> scaler;
+        for (auto batch = nextBatch(); !batch.empty(); batch = nextBatch()) {
+            if (scaler == nullptr) {
+                scaler = fScalerContext->getTypeface()->createScalerContext(
+                        effects, fDesc.getDesc());
+            }
+            scaler->getImages(batch);
+        }
+    });
+    // The calling thread makes images with the strike's own scaler context while it waits.
+    for (auto batch = nextBatch(); !batch.empty(); batch = nextBatch()) {
+        fScalerContext->getImages(batch);
+    }
+    tasks.wait();
+}
+
 void SkStrike::initializeImage(const volatile void* data, size_t size, SkGlyph* glyph) {
     // Don't overwrite the image if we already have one. We could have used a fallback if the
     // glyph was missing earlier.
@@ -424,6 +508,10 @@ void SkStrike::findIntercepts(const SkScalar bounds[2], SkScalar scale, SkScalar
     OffsetResults(intercept, scale, xPos, array, count);
 }
 
+void SkStrike::forEachCachedGlyph(const std::function<void(const SkGlyph&)>& visitor) const {
+    fGlyphMap.foreach([&visitor](const SkGlyph* glyph) { visitor(*glyph); });
+}
+
 void SkStrike::dump() const {
     const SkTypeface* face = fScalerContext->getTypeface();
     const SkScalerContextRec& rec = fScalerContext->getRec();
@@ -12,14 +12,18 @@
 #include "SkFontMetrics.h"
 #include "SkFontTypes.h"
 #include "SkGlyph.h"
+#include "SkGlyphAtlas.h"
 #include "SkGlyphRunPainter.h"
 #include "SkPaint.h"
 #include "SkTHash.h"
 #include "SkScalerContext.h"
 #include "SkStrikeInterface.h"
 #include "SkTemplates.h"
+#include <functional>
 #include <memory>
 
+class SkExecutor;
+
 /** \class SkGlyphCache
 
     This class represents a strike: a specific combination of typeface, size, matrix, etc., and
@@ -31,7 +35,8 @@
     either Find{OrCreate}Exclusive().
 
     The Find*Exclusive() method returns SkExclusiveStrikePtr, which releases exclusive ownership
-    when they go out of scope.
+    when they go out of scope. FindStrikeShared() returns SkSharedStrikePtr, which many threads
+    can hold at once to look up glyphs already in the strike, with getCachedGlyph().
 */
 class SkStrike final : public SkStrikeInterface {
 public:
@@ -42,6 +47,11 @@ public:
     /** Return true if glyph is cached. */
     bool isGlyphCached(SkGlyphID glyphID, SkFixed x, SkFixed y) const;
 
+    /** Returns the glyph if it is already cached, or null; unlike the other lookups, this never
+        adds to the strike, so any number of threads may call it at once.
+    */
+    const SkGlyph* getCachedGlyph(SkPackedGlyphID) const;
+
     /**  Return a glyph that has no information if it is not already filled out. */
     SkGlyph* getRawGlyphByID(SkPackedGlyphID);
 
@@ -73,11 +83,27 @@ public:
     /** Return the number of glyphs currently cached. */
     int countCachedGlyphs() const;
 
+    /** Calls visitor with each glyph currently cached. */
+    void forEachCachedGlyph(const std::function<void(const SkGlyph&)>& visitor) const;
+
     /** Return the image associated with the glyph. If it has not been generated this will
         trigger that.
     */
     const void* findImage(const SkGlyph&);
 
+    /** Makes the images of the glyphs that don't have one yet, as findImage() would, but in
+        small batches, spread over executor's threads, each with its own scaler context. With no
+        executor they are made on this thread. The glyphs must belong to this strike, and their
+        metrics must already be filled out.
+    */
+    void prepareImages(SkSpan<const SkGlyph* const> glyphs, SkExecutor* executor);
+
+    /** Return the glyph's image in this strike's glyph atlas, setting rowBytes to the atlas page's,
+        and adding the image there first if needed. Returns null for glyphs the atlas doesn't
+        hold; use findImage() for those.
+    */
+    const void* findAtlasImage(const SkGlyph&, size_t* rowBytes);
+
     /** Initializes the image associated with the glyph with |data|.
      */
     void initializeImage(const volatile void* data, size_t size, SkGlyph*);
@@ -231,6 +257,9 @@ private:
 
     SkArenaAlloc            fAlloc {kMinAllocAmount};
 
+    // Made on first use, by raster drawing with gSkUseRasterGlyphAtlas set.
+    std::unique_ptr<SkGlyphAtlas> fAtlas;
+
     // used to track (approx) how much ram is tied-up in this cache
     size_t                  fMemoryUsed;
 
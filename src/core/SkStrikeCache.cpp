@@ -8,7 +8,9 @@
 #include "SkStrikeCache.h"
 
 #include <cctype>
+#include <thread>
 
+#include "SkChecksum.h"
 #include "SkGlyphRunPainter.h"
 #include "SkGraphics.h"
 #include "SkMutex.h"
@@ -25,6 +27,7 @@ public:
          const SkFontMetrics& metrics,
          std::unique_ptr<SkStrikePinner> pinner)
             : fStrikeCache{strikeCache}
+            , fShardIndex{ShardIndex(desc)}
             , fStrike{desc, std::move(scaler), metrics}
             , fPinner{std::move(pinner)} {}
 
@@ -59,6 +62,9 @@ public:
     }
 
     SkStrikeCache* const            fStrikeCache;
+    const int                       fShardIndex;
+    // Counts the SharedStrikePtrs to this node. It only goes up with its shard's lock held.
+    std::atomic<int>                fReaders{0};
     Node*                           fNext{nullptr};
     Node*                           fPrev{nullptr};
     SkStrike                        fStrike;
@@ -126,19 +132,73 @@ bool operator == (decltype(nullptr), const SkStrikeCache::ExclusiveStrikePtr& rh
     return nullptr == rhs.fNode;
 }
 
+SkStrikeCache::SharedStrikePtr::SharedStrikePtr(SkStrikeCache::Node* node)
+    : fNode{node} {}
+
+SkStrikeCache::SharedStrikePtr::SharedStrikePtr()
+    : fNode{nullptr} {}
+
+SkStrikeCache::SharedStrikePtr::SharedStrikePtr(SharedStrikePtr&& o)
+    : fNode{o.fNode} {
+    o.fNode = nullptr;
+}
+
+SkStrikeCache::SharedStrikePtr&
+SkStrikeCache::SharedStrikePtr::operator = (SharedStrikePtr&& o) {
+    this->reset();
+    fNode = o.fNode;
+    o.fNode = nullptr;
+    return *this;
+}
+
+SkStrikeCache::SharedStrikePtr::~SharedStrikePtr() {
+    this->reset();
+}
+
+void SkStrikeCache::SharedStrikePtr::reset() {
+    if (fNode != nullptr) {
+        // The node stayed in its shard, so there's nothing else to do; the next purge may
+        // delete it once its last reader is gone.
+        fNode->fReaders.fetch_sub(1, std::memory_order_release);
+        fNode = nullptr;
+    }
+}
+
+const SkStrike* SkStrikeCache::SharedStrikePtr::get() const {
+    return &fNode->fStrike;
+}
+
+const SkStrike* SkStrikeCache::SharedStrikePtr::operator -> () const {
+    return this->get();
+}
+
+SkStrikeCache::SharedStrikePtr::operator bool () const {
+    return fNode != nullptr;
+}
+
 SkStrikeCache::~SkStrikeCache() {
-    Node* node = fHead;
-    while (node) {
-        Node* next = node->fNext;
-        delete node;
-        node = next;
+    for (Shard& shard : fShards) {
+        Node* node = shard.fHead;
+        while (node) {
+            Node* next = node->fNext;
+            delete node;
+            node = next;
+        }
     }
 }
 
+int SkStrikeCache::ShardIndex(const SkDescriptor& desc) {
+    return SkChecksum::CheapMix(desc.getChecksum()) & (kShardCount - 1);
+}
+
 SkExclusiveStrikePtr SkStrikeCache::FindStrikeExclusive(const SkDescriptor& desc) {
     return GlobalStrikeCache()->findStrikeExclusive(desc);
 }
 
+SkSharedStrikePtr SkStrikeCache::FindStrikeShared(const SkDescriptor& desc) {
+    return GlobalStrikeCache()->findStrikeShared(desc);
+}
+
 std::unique_ptr<SkScalerContext> SkStrikeCache::CreateScalerContext(
         const SkDescriptor& desc,
         const SkScalerContextEffects& effects,
@@ -173,8 +233,18 @@ auto SkStrikeCache::findOrCreateStrike(const SkDescriptor& desc,
                                        const SkTypeface& typeface) -> Node* {
     Node* node = this->findAndDetachStrike(desc);
     if (node == nullptr) {
-        auto scaler = CreateScalerContext(desc, effects, typeface);
-        node = this->createStrike(desc, std::move(scaler));
+        node = this->createAndPreloadStrike(desc, effects, typeface);
+    }
+    return node;
+}
+
+auto SkStrikeCache::createAndPreloadStrike(const SkDescriptor& desc,
+                                           const SkScalerContextEffects& effects,
+                                           const SkTypeface& typeface) -> Node* {
+    auto scaler = CreateScalerContext(desc, effects, typeface);
+    Node* node = this->createStrike(desc, std::move(scaler));
+    if (fPreloader) {
+        fPreloader->preloadStrike(typeface, &node->fStrike);
     }
     return node;
 }
@@ -184,8 +254,7 @@ SkScopedStrike SkStrikeCache::findOrCreateScopedStrike(const SkDescriptor& desc,
                                                        const SkTypeface& typeface) {
     Node* node = this->findAndDetachStrike(desc);
     if (node == nullptr) {
-        auto scaler = CreateScalerContext(desc, effects, typeface);
-        node = this->createStrike(desc, std::move(scaler));
+        node = this->createAndPreloadStrike(desc, effects, typeface);
     }
     return SkScopedStrike{node};
 }
@@ -308,13 +377,17 @@ void SkStrikeCache::attachNode(Node* node) {
     if (node == nullptr) {
         return;
     }
-    SkAutoExclusive ac(fLock);
+    SkASSERT(node->fReaders.load(std::memory_order_relaxed) == 0);
+    {
+        Shard* shard = &fShards[node->fShardIndex];
+        SkAutoExclusive ac(shard->fLock);
 
-    this->validate();
-    node->fStrike.validate();
+        this->validateShard(*shard);
+        node->fStrike.validate();
 
-    this->internalAttachToHead(node);
-    this->internalPurge();
+        this->internalAttachToHead(shard, node);
+    }
+    this->purge();
 }
 
 SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc) {
@@ -322,15 +395,58 @@ SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc
 }
 
 auto SkStrikeCache::findAndDetachStrike(const SkDescriptor& desc) -> Node* {
-    SkAutoExclusive ac(fLock);
+    Shard* shard = &fShards[ShardIndex(desc)];
+    bool waiting = false;
+    for (;;) {
+        {
+            SkAutoExclusive ac(shard->fLock);
+            Node* node = this->internalFind(*shard, desc);
+            // Readers are only added with the lock held, so none can start on this node now.
+            if (node == nullptr || node->fReaders.load(std::memory_order_acquire) == 0) {
+                if (waiting) {
+                    shard->fWritersWaiting -= 1;
+                }
+                if (node != nullptr) {
+                    this->internalDetachCache(shard, node);
+                }
+                return node;
+            }
+            if (!waiting) {
+                shard->fWritersWaiting += 1;
+                waiting = true;
+            }
+        }
+        // No new readers start while we wait, and the ones we wait for only look up glyphs
+        // that are already cached. Wait for them rather than create a second strike for desc.
+        std::this_thread::yield();
+    }
+}
+
+SkSharedStrikePtr SkStrikeCache::findStrikeShared(const SkDescriptor& desc) {
+    Shard* shard = &fShards[ShardIndex(desc)];
+    SkAutoExclusive ac(shard->fLock);
+
+    // A writer is waiting for this shard's readers; don't keep it waiting any longer.
+    if (shard->fWritersWaiting > 0) {
+        return SkSharedStrikePtr();
+    }
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
+    Node* node = this->internalFind(*shard, desc);
+    if (node != nullptr) {
+        node->fReaders.fetch_add(1, std::memory_order_relaxed);
+        // Mark it as most recently used.
+        this->internalDetachCache(shard, node);
+        this->internalAttachToHead(shard, node);
+    }
+    return SkSharedStrikePtr(node);
+}
+
+auto SkStrikeCache::internalFind(const Shard& shard, const SkDescriptor& desc) const -> Node* {
+    for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
         if (node->fStrike.getDescriptor() == desc) {
-            this->internalDetachCache(node);
             return node;
         }
     }
-
     return nullptr;
 }
 
@@ -363,28 +479,30 @@ static bool loose_compare(const SkDescriptor& lhs, const SkDescriptor& rhs) {
 
 bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph* glyph,
                                               SkStrike* targetCache) {
-    SkAutoExclusive ac(fLock);
-
     SkGlyphID glyphID = glyph->getGlyphID();
     SkFixed targetSubX = glyph->getSubXFixed(),
             targetSubY = glyph->getSubYFixed();
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fStrike.getDescriptor(), desc)) {
-            auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
-            if (node->fStrike.isGlyphCached(glyphID, targetSubX, targetSubY)) {
-                SkGlyph* fallback = node->fStrike.getRawGlyphByID(targetGlyphID);
-                // This desperate-match node may disappear as soon as we drop fLock, so we
-                // need to copy the glyph from node into this strike, including a
-                // deep copy of the mask.
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
-            }
+    // Strikes for other descriptors live in other shards, so search them all.
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fStrike.getDescriptor(), desc)) {
+                auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
+                if (node->fStrike.isGlyphCached(glyphID, targetSubX, targetSubY)) {
+                    SkGlyph* fallback = node->fStrike.getRawGlyphByID(targetGlyphID);
+                    // This desperate-match node may disappear as soon as we drop the shard's
+                    // lock, so we need to copy the glyph from node into this strike, including
+                    // a deep copy of the mask.
+                    targetCache->initializeGlyphFromFallback(glyph, *fallback);
+                    return true;
+                }
 
-            // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
-            if (const auto* fallback = node->fStrike.getCachedGlyphAnySubPix(glyphID)) {
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
+                // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
+                if (const auto* fallback = node->fStrike.getCachedGlyphAnySubPix(glyphID)) {
+                    targetCache->initializeGlyphFromFallback(glyph, *fallback);
+                    return true;
+                }
             }
         }
     }
@@ -394,23 +512,24 @@ bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph*
 
 bool SkStrikeCache::desperationSearchForPath(
         const SkDescriptor& desc, SkGlyphID glyphID, SkPath* path) {
-    SkAutoExclusive ac(fLock);
-
     // The following is wrong there is subpixel positioning with paths...
     // Paths are only ever at sub-pixel position (0,0), so we can just try that directly rather
     // than try our packed position first then search all others on failure like for masks.
     //
     // This will have to search the sub-pixel positions too.
     // There is also a problem with accounting for cache size with shared path data.
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fStrike.getDescriptor(), desc)) {
-            if (node->fStrike.isGlyphCached(glyphID, 0, 0)) {
-                SkGlyph* from = node->fStrike.getRawGlyphByID(SkPackedGlyphID(glyphID));
-                if (from->fPathData != nullptr) {
-                    // We can just copy the path out by value here, so no need to worry
-                    // about the lifetime of this desperate-match node.
-                    *path = from->fPathData->fPath;
-                    return true;
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fStrike.getDescriptor(), desc)) {
+                if (node->fStrike.isGlyphCached(glyphID, 0, 0)) {
+                    SkGlyph* from = node->fStrike.getRawGlyphByID(SkPackedGlyphID(glyphID));
+                    if (from->fPathData != nullptr) {
+                        // We can just copy the path out by value here, so no need to worry
+                        // about the lifetime of this desperate-match node.
+                        *path = from->fPathData->fPath;
+                        return true;
+                    }
                 }
             }
         }
@@ -454,23 +573,19 @@ auto SkStrikeCache::createStrike(
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->purge(fTotalMemoryUsed.load(std::memory_order_relaxed));
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoExclusive ac(fLock);
-    return fTotalMemoryUsed;
+    return fTotalMemoryUsed.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheCount;
+    return fCacheCount.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheCountLimit;
+    return fCacheCountLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
@@ -479,17 +594,13 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit);
+    this->purge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheSizeLimit;
+    return fCacheSizeLimit.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::setCacheCountLimit(int newCount) {
@@ -497,17 +608,13 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = fCacheCountLimit.exchange(newCount);
+    this->purge();
     return prevCount;
 }
 
 int SkStrikeCache::getCachePointSizeLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fPointSizeLimit;
+    return fPointSizeLimit.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
@@ -515,68 +622,114 @@ int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
         newLimit = 0;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    int prevLimit = fPointSizeLimit;
-    fPointSizeLimit = newLimit;
-    return prevLimit;
+    return fPointSizeLimit.exchange(newLimit);
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
-    SkAutoExclusive ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
 
-    this->validate();
+        this->validateShard(shard);
 
-    for (Node* node = this->internalGetHead(); node != nullptr; node = node->fNext) {
-        visitor(node->fStrike);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            visitor(node->fStrike);
+        }
     }
 }
 
-size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
-    this->validate();
+size_t SkStrikeCache::purge(size_t minBytesNeeded) {
+    auto computeNeeds = [this, minBytesNeeded](size_t* bytesNeeded, int* countNeeded) {
+        size_t totalMemoryUsed = fTotalMemoryUsed.load(std::memory_order_relaxed),
+               cacheSizeLimit  = fCacheSizeLimit .load(std::memory_order_relaxed);
+        int cacheCount      = fCacheCount     .load(std::memory_order_relaxed),
+            cacheCountLimit = fCacheCountLimit.load(std::memory_order_relaxed);
 
-    size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
-    }
-    bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
-    if (bytesNeeded) {
-        // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
-    }
+        *bytesNeeded = 0;
+        if (totalMemoryUsed > cacheSizeLimit) {
+            *bytesNeeded = totalMemoryUsed - cacheSizeLimit;
+        }
+        *bytesNeeded = SkTMax(*bytesNeeded, minBytesNeeded);
+        if (*bytesNeeded) {
+            // no small purges!
+            *bytesNeeded = SkTMax(*bytesNeeded, totalMemoryUsed >> 2);
+        }
 
-    int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
-        // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
-    }
+        *countNeeded = 0;
+        if (cacheCount > cacheCountLimit) {
+            *countNeeded = cacheCount - cacheCountLimit;
+            // no small purges!
+            *countNeeded = SkMax32(*countNeeded, cacheCount >> 2);
+        }
+        return *bytesNeeded || *countNeeded;
+    };
 
+    size_t bytesNeeded;
+    int countNeeded;
     // early exit
-    if (!countNeeded && !bytesNeeded) {
+    if (!computeNeeds(&bytesNeeded, &countNeeded)) {
+        return 0;
+    }
+
+    // Another thread may have purged while we waited.
+    SkAutoExclusive purgeLock(fPurgeLock);
+    if (!computeNeeds(&bytesNeeded, &countNeeded)) {
         return 0;
     }
 
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
-    // Start at the tail and proceed backwards deleting; the list is in LRU
-    // order, with unimportant entries at the tail.
-    Node* node = this->internalGetTail();
-    while (node != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        Node* prev = node->fPrev;
-
-        // Only delete if the strike is not pinned.
-        if (node->fPinner == nullptr || node->fPinner->canDelete()) {
-            bytesFreed += node->fStrike.getMemoryUsed();
-            countFreed += 1;
-            this->internalDetachCache(node);
-            delete node;
+    // There is no LRU order across shards, so first have each shard free its share of the
+    // budgets' excess, which approximates it. Then make up for any pinned or read strikes.
+    const size_t totalMemoryUsed = SkTMax<size_t>(fTotalMemoryUsed.load(), 1);
+    const int    cacheCount      = SkTMax(fCacheCount.load(), 1);
+
+    // Start at the shard's tail and proceed backwards deleting; its list is in LRU order, with
+    // unimportant entries at the tail. Stop when the shard has freed its goals.
+    auto purgeShard = [&](Shard* shard, bool shareOnly) {
+        SkAutoExclusive ac(shard->fLock);
+        this->validateShard(*shard);
+
+        size_t bytesGoal = bytesNeeded - SkTMin(bytesFreed, bytesNeeded);
+        int    countGoal = countNeeded - SkTMin(countFreed, countNeeded);
+        if (shareOnly) {
+            bytesGoal = (size_t)((double)bytesNeeded * shard->fMemoryUsed / totalMemoryUsed) +
+                        (bytesNeeded > 0);
+            countGoal = (int)((int64_t)countNeeded * shard->fCount / cacheCount) +
+                        (countNeeded > 0);
         }
-        node = prev;
-    }
 
-    this->validate();
+        size_t shardBytesFreed = 0;
+        int    shardCountFreed = 0;
+        Node* node = shard->fTail;
+        while (node != nullptr && (shardBytesFreed < bytesGoal || shardCountFreed < countGoal)) {
+            Node* prev = node->fPrev;
+
+            // Only delete if the strike is not pinned, and no one is reading it.
+            if (node->fReaders.load(std::memory_order_acquire) == 0 &&
+                (node->fPinner == nullptr || node->fPinner->canDelete())) {
+                shardBytesFreed += node->fStrike.getMemoryUsed();
+                shardCountFreed += 1;
+                this->internalDetachCache(shard, node);
+                delete node;
+            }
+            node = prev;
+        }
+
+        this->validateShard(*shard);
+        bytesFreed += shardBytesFreed;
+        countFreed += shardCountFreed;
+    };
+
+    for (Shard& shard : fShards) {
+        purgeShard(&shard, true);
+    }
+    for (Shard& shard : fShards) {
+        if (bytesFreed >= bytesNeeded && countFreed >= countNeeded) {
+            break;
+        }
+        purgeShard(&shard, false);
+    }
 
 #ifdef SPEW_PURGE_STATUS
     if (countFreed) {
@@ -588,36 +741,42 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(Node* node) {
+void SkStrikeCache::internalAttachToHead(Shard* shard, Node* node) {
     SkASSERT(nullptr == node->fPrev && nullptr == node->fNext);
-    if (fHead) {
-        fHead->fPrev = node;
-        node->fNext = fHead;
+    if (shard->fHead) {
+        shard->fHead->fPrev = node;
+        node->fNext = shard->fHead;
     }
-    fHead = node;
+    shard->fHead = node;
 
-    if (fTail == nullptr) {
-        fTail = node;
+    if (shard->fTail == nullptr) {
+        shard->fTail = node;
     }
 
-    fCacheCount += 1;
-    fTotalMemoryUsed += node->fStrike.getMemoryUsed();
+    size_t memoryUsed = node->fStrike.getMemoryUsed();
+    shard->fCount += 1;
+    shard->fMemoryUsed += memoryUsed;
+    fCacheCount.fetch_add(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_add(memoryUsed, std::memory_order_relaxed);
 }
 
-void SkStrikeCache::internalDetachCache(Node* node) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= node->fStrike.getMemoryUsed();
+void SkStrikeCache::internalDetachCache(Shard* shard, Node* node) {
+    SkASSERT(shard->fCount > 0);
+    size_t memoryUsed = node->fStrike.getMemoryUsed();
+    shard->fCount -= 1;
+    shard->fMemoryUsed -= memoryUsed;
+    fCacheCount.fetch_sub(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_sub(memoryUsed, std::memory_order_relaxed);
 
     if (node->fPrev) {
         node->fPrev->fNext = node->fNext;
     } else {
-        fHead = node->fNext;
+        shard->fHead = node->fNext;
     }
     if (node->fNext) {
         node->fNext->fPrev = node->fPrev;
     } else {
-        fTail = node->fPrev;
+        shard->fTail = node->fPrev;
     }
     node->fPrev = node->fNext = nullptr;
 }
@@ -638,20 +797,27 @@ void SkStrikeCache::validateGlyphCacheDataSize() const {
 
 #ifdef SK_DEBUG
 void SkStrikeCache::validate() const {
+    for (const Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        this->validateShard(shard);
+    }
+}
+
+void SkStrikeCache::validateShard(const Shard& shard) const {
     size_t computedBytes = 0;
     int computedCount = 0;
 
-    const Node* node = fHead;
+    const Node* node = shard.fHead;
     while (node != nullptr) {
         computedBytes += node->fStrike.getMemoryUsed();
         computedCount += 1;
         node = node->fNext;
     }
 
-    SkASSERTF(fCacheCount == computedCount, "fCacheCount: %d, computedCount: %d", fCacheCount,
+    SkASSERTF(shard.fCount == computedCount, "fCount: %d, computedCount: %d", shard.fCount,
               computedCount);
-    SkASSERTF(fTotalMemoryUsed == computedBytes, "fTotalMemoryUsed: %d, computedBytes: %d",
-              fTotalMemoryUsed, computedBytes);
+    SkASSERTF(shard.fMemoryUsed == computedBytes, "fMemoryUsed: %zu, computedBytes: %zu",
+              shard.fMemoryUsed, computedBytes);
 }
 #endif
 
@@ -8,6 +8,7 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -39,6 +40,13 @@ public:
     virtual bool canDelete() = 0;
 };
 
+// Fills in new strikes with glyphs made earlier, e.g. by another process (see SkStrikeCacheFile).
+class SkStrikePreloader : public SkRefCnt {
+public:
+    // Called for each strike the cache creates for typeface, before anyone uses it.
+    virtual void preloadStrike(const SkTypeface& typeface, SkStrike* strike) = 0;
+};
+
 class SkStrikeCache final : public SkStrikeCacheInterface {
     class Node;
 
@@ -68,8 +76,37 @@ public:
         Node* fNode;
     };
 
+    // Read-only access to a strike that stays in the cache, so that any number of threads can
+    // look up its already cached glyphs at the same time. The strike can't be purged while a
+    // SharedStrikePtr refers to it, and checking it out exclusively waits for them to go away,
+    // so a thread must not do that while it holds one to the same strike.
+    class SharedStrikePtr {
+    public:
+        explicit SharedStrikePtr(Node*);
+        SharedStrikePtr();
+        SharedStrikePtr(const SharedStrikePtr&) = delete;
+        SharedStrikePtr& operator = (const SharedStrikePtr&) = delete;
+        SharedStrikePtr(SharedStrikePtr&&);
+        SharedStrikePtr& operator = (SharedStrikePtr&&);
+        ~SharedStrikePtr();
+
+        const SkStrike* get() const;
+        const SkStrike* operator -> () const;
+        explicit operator bool () const;
+
+    private:
+        void reset();
+
+        Node* fNode;
+    };
+
     static SkStrikeCache* GlobalStrikeCache();
 
+    // Returns the strike for desc if it is already in the cache, without creating it. Also
+    // returns null while a thread waits to check out a strike from the same shard exclusively.
+    static SharedStrikePtr FindStrikeShared(const SkDescriptor&);
+    SharedStrikePtr findStrikeShared(const SkDescriptor&);
+
     static ExclusiveStrikePtr FindStrikeExclusive(const SkDescriptor&);
     ExclusiveStrikePtr findStrikeExclusive(const SkDescriptor&);
     Node* findAndDetachStrike(const SkDescriptor&);
@@ -154,6 +191,13 @@ public:
 
     void purgeAll(); // does not change budget
 
+    // If set, new strikes are passed to the preloader before they're used. This must be set
+    // before the cache is shared with other threads.
+    void setPreloader(sk_sp<SkStrikePreloader> preloader) { fPreloader = std::move(preloader); }
+
+    // Calls visitor with each strike in the cache (but not those checked out).
+    void forEachStrike(std::function<void(const SkStrike&)> visitor) const;
+
     int getCacheCountLimit() const;
     int setCacheCountLimit(int limit);
     int getCacheCountUsed() const;
@@ -176,30 +220,60 @@ public:
 #endif
 
 private:
+    // Strikes are spread over kShardCount shards by the hash of their descriptors. Each shard has
+    // its own lock and LRU list, so threads using different strikes rarely wait on each other.
+    // The budgets are for the whole cache; fTotalMemoryUsed and fCacheCount sum up the shards.
+    static constexpr int kShardCount = 16;
+
+    struct Shard {
+        mutable SkSpinlock fLock;
+        Node*              fHead{nullptr};
+        Node*              fTail{nullptr};
+        size_t             fMemoryUsed{0};
+        int32_t            fCount{0};
+        // Writers waiting for a strike's readers to finish. New readers are turned away
+        // until they're done, so a steady stream of them can't starve the writers.
+        int32_t            fWritersWaiting{0};
+    };
+
+    static int ShardIndex(const SkDescriptor&);
 
-    // The following methods can only be called when mutex is already held.
-    Node* internalGetHead() const { return fHead; }
-    Node* internalGetTail() const { return fTail; }
-    void internalDetachCache(Node*);
-    void internalAttachToHead(Node*);
+    // The following methods can only be called when the shard's lock is already held.
+    void internalDetachCache(Shard*, Node*);
+    void internalAttachToHead(Shard*, Node*);
+    // Returns the most recently used strike for desc.
+    Node* internalFind(const Shard&, const SkDescriptor&) const;
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
+    // Takes the shard locks one at a time, so must be called without any held.
     // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0);
+    size_t purge(size_t minBytesNeeded = 0);
 
-    void forEachStrike(std::function<void(const SkStrike&)> visitor) const;
+    // Creates a strike for desc, which is not in the cache, and preloads it.
+    Node* createAndPreloadStrike(const SkDescriptor& desc,
+                                 const SkScalerContextEffects& effects,
+                                 const SkTypeface& typeface);
+
+#ifdef SK_DEBUG
+    void validateShard(const Shard&) const;
+#else
+    void validateShard(const Shard&) const {}
+#endif
+
+    sk_sp<SkStrikePreloader> fPreloader;
 
-    mutable SkSpinlock fLock;
-    Node*              fHead{nullptr};
-    Node*              fTail{nullptr};
-    size_t             fTotalMemoryUsed{0};
-    size_t             fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    int32_t            fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t            fCacheCount{0};
-    int32_t            fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+    Shard                fShards[kShardCount];
+    // Only one thread purges at a time; the others wait, then free only what is still over.
+    SkSpinlock           fPurgeLock;
+    std::atomic<size_t>  fTotalMemoryUsed{0};
+    std::atomic<size_t>  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<int32_t> fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+    std::atomic<int32_t> fCacheCount{0};
+    std::atomic<int32_t> fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
 };
 
 using SkExclusiveStrikePtr = SkStrikeCache::ExclusiveStrikePtr;
+using SkSharedStrikePtr = SkStrikeCache::SharedStrikePtr;
 
 #endif  // SkStrikeCache_DEFINED
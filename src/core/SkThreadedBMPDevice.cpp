@@ -0,0 +1,344 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedBMPDevice.h"
+
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkSpecialImage.h"
+#include "SkTaskGroup.h"
+#include "SkVertices.h"
+
+// Matches SkDrawTiler: past this size, SkDraw can't address the device without translating.
+static constexpr int kMaxDim = 8192 - 1;
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& props,
+                                         int tiles, SkExecutor* executor)
+        : INHERITED(bitmap, props, nullptr, nullptr)
+        , fExecutor(executor ? executor : &SkExecutor::GetDefault()) {
+
+    const int w = bitmap.width(),
+              h = bitmap.height();
+
+    // Tiles are horizontal bands so that each one walks contiguous rows of memory.  Devices too
+    // large for SkDraw are also split into columns, and each tile is then drawn translated to its
+    // own origin, just like SkDrawTiler does for SkBitmapDevice.
+    fTranslateTiles = w > kMaxDim || h > kMaxDim;
+    const int bands      = SkTMax(SkTMax(tiles, 1), (h + kMaxDim - 1) / kMaxDim),
+              bandHeight = SkTMax(1, (h + bands - 1) / bands),
+              colWidth   = fTranslateTiles ? kMaxDim : SkTMax(w, 1);
+    for (int top = 0; top < h; top += bandHeight) {
+        for (int left = 0; left < w; left += colWidth) {
+            fTileBounds.push_back(SkIRect::MakeLTRB(left, top,
+                                                    SkTMin(left + colWidth, w),
+                                                    SkTMin(top + bandHeight, h)));
+        }
+    }
+}
+
+bool SkThreadedBMPDevice::snapshot(const SkBitmap& bitmap, SkBitmap* dst) {
+    if (bitmap.isImmutable()) {
+        *dst = bitmap;
+        return true;
+    }
+    if (bitmap.pixelRef() == fBitmap.pixelRef()) {
+        // Our own pixels are only up to date once everything queued so far is drawn.
+        this->flush();
+    }
+    if (!dst->tryAllocPixels(bitmap.info()) || !bitmap.readPixels(dst->pixmap())) {
+        return false;
+    }
+    dst->setImmutable();
+    return true;
+}
+
+void SkThreadedBMPDevice::recordDraw(const SkRect* localBounds, DrawFn fn, bool shareScan) {
+    if (!localBounds) {
+        this->recordDevDraw(nullptr, std::move(fn), shareScan);
+        return;
+    }
+    // Outset by a pixel to cover antialiasing and hairlines that straddle the bounds.
+    SkIRect devBounds = this->ctm().mapRect(*localBounds).roundOut();
+    devBounds.outset(1, 1);
+    this->recordDevDraw(&devBounds, std::move(fn), shareScan);
+}
+
+void SkThreadedBMPDevice::recordDevDraw(const SkIRect* devBounds, DrawFn fn, bool shareScan) {
+    const SkRasterClip& rc = fRCStack.rc();
+    if (rc.isEmpty()) {
+        return;
+    }
+
+    SkIRect bounds = rc.getBounds();
+    if (devBounds && !bounds.intersect(*devBounds)) {
+        return;
+    }
+
+    // Translated tiles clip the geometry itself to each tile, so they can't share a scan.
+    std::unique_ptr<SharedScan> scan;
+    if (shareScan && !fTranslateTiles) {
+        int tiles = 0;
+        for (const SkIRect& tile : fTileBounds) {
+            tiles += SkIRect::Intersects(bounds, tile);
+        }
+        if (tiles > 1) {
+            scan.reset(new SharedScan);
+            scan->fTilesLeft = tiles;
+        }
+    }
+
+    fQueue.push_back({this->ctm(), rc, bounds, std::move(fn), std::move(scan)});
+}
+
+void SkThreadedBMPDevice::drawTile(int tileIndex, const SkPixmap& root) const {
+    const SkIRect& tile = fTileBounds[tileIndex];
+
+    SkDraw   draw;
+    SkMatrix tileMatrix;
+    if (fTranslateTiles) {
+        SkAssertResult(root.extractSubset(&draw.fDst, tile));
+    } else {
+        draw.fDst = root;
+    }
+    draw.fMatrix = &tileMatrix;
+
+    for (const DrawElement& element : fQueue) {
+        if (!SkIRect::Intersects(element.fDevBounds, tile)) {
+            continue;
+        }
+
+        tileMatrix = element.fMatrix;
+        if (fTranslateTiles) {
+            // Translated tiles have to clip geometry to the tile, so the edges of anything that
+            // straddles two tiles may rasterize slightly differently than with SkBitmapDevice.
+            SkRasterClip tileRC(element.fRC);
+            tileMatrix.postTranslate(SkIntToScalar(-tile.fLeft), SkIntToScalar(-tile.fTop));
+            tileRC.translate(-tile.fLeft, -tile.fTop);
+            tileRC.op(SkIRect::MakeWH(tile.width(), tile.height()), SkRegion::kIntersect_Op);
+            if (tileRC.isEmpty()) {
+                continue;
+            }
+            draw.fRC = &tileRC;
+            draw.fBlitClip = nullptr;
+            element.fDraw(draw);
+        } else {
+            // Scan convert against the draw's own clip, so every tile sees exactly the same
+            // edges, and only restrict the blits to the tile.
+            draw.fRC = &element.fRC;
+            draw.fBlitClip = tile.contains(element.fDevBounds) ? nullptr : &tile;
+            if (SharedScan* scan = element.fScan.get()) {
+                // Each tile gets exactly the blits it would have scan converting by itself, less
+                // the ones its fBlitClip would have dropped.
+                {
+                    SkAutoMutexAcquire lock(scan->fMutex);
+                    if (!scan->fRecorded) {
+                        SkDraw recordDraw(draw);
+                        recordDraw.fBlitClip     = nullptr;
+                        recordDraw.fBlitRecorder = &scan->fRecorder;
+                        element.fDraw(recordDraw);
+                        scan->fRecorded = true;
+                    }
+                }
+                scan->fRecorder.replay(draw);
+                if (--scan->fTilesLeft == 0) {
+                    scan->fRecorder.reset();
+                }
+            } else {
+                element.fDraw(draw);
+            }
+        }
+    }
+}
+
+void SkThreadedBMPDevice::flush() {
+    if (fQueue.empty()) {
+        return;
+    }
+
+    SkPixmap root;
+    if (fBitmap.peekPixels(&root)) {
+        SkTaskGroup group(*fExecutor);
+        group.batch(fTileBounds.count(), [this, &root](int i) { this->drawTile(i, root); });
+        group.wait();
+        fBitmap.notifyPixelsChanged();
+    }
+    fQueue.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBMPDevice::drawPaint(const SkPaint& paint) {
+    this->recordDraw(nullptr, [paint](const SkDraw& draw) {
+        draw.drawPaint(paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
+                                     const SkPoint pts[], const SkPaint& paint) {
+    std::vector<SkPoint> points(pts, pts + count);
+    this->recordDraw(nullptr, [mode, points, paint](const SkDraw& draw) {
+        draw.drawPoints(mode, points.size(), points.data(), paint, nullptr);
+    });
+}
+
+void SkThreadedBMPDevice::drawRect(const SkRect& r, const SkPaint& paint) {
+    SkRect storage;
+    const SkRect* bounds = paint.canComputeFastBounds() ? &paint.computeFastBounds(r, &storage)
+                                                        : nullptr;
+    this->recordDraw(bounds, [r, paint](const SkDraw& draw) {
+        draw.drawRect(r, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRects(const SkRect rects[], const SkColor colors[], int count,
+                                    const SkPaint& paint) {
+    // We don't own rects and colors, so queue them up as individual rects.
+    this->SkBaseDevice::drawRects(rects, colors, count, paint);
+}
+
+void SkThreadedBMPDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
+#ifdef SK_IGNORE_BLURRED_RRECT_OPT
+    INHERITED::drawRRect(rrect, paint);
+#else
+    SkRect storage;
+    const SkRect* bounds = paint.canComputeFastBounds()
+                         ? &paint.computeFastBounds(rrect.getBounds(), &storage)
+                         : nullptr;
+    this->recordDraw(bounds, [rrect, paint](const SkDraw& draw) {
+        draw.drawRRect(rrect, paint);
+    }, true/*shareScan*/);
+#endif
+}
+
+void SkThreadedBMPDevice::drawPath(const SkPath& path, const SkPaint& paint, bool) {
+    // The path is replayed concurrently by several tiles, so resolve its lazily computed
+    // state (bounds, convexity) up front while we're still on one thread.
+    path.updateBoundsCache();
+    (void)path.getConvexity();
+
+    SkRect storage;
+    const SkRect* bounds = nullptr;
+    if (!path.isInverseFillType() && paint.canComputeFastBounds()) {
+        bounds = &paint.computeFastBounds(path.getBounds(), &storage);
+    }
+    this->recordDraw(bounds, [path, paint](const SkDraw& draw) {
+        draw.drawPath(path, paint, nullptr, false);
+    }, true/*shareScan*/);
+}
+
+void SkThreadedBMPDevice::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& paint) {
+    SkBitmap src;
+    if (!this->snapshot(bitmap, &src)) {
+        this->flush();
+        INHERITED::drawSprite(bitmap, x, y, paint);
+        return;
+    }
+
+    // Sprites ignore the CTM, so their bounds are already in device space.
+    SkIRect devBounds = SkIRect::MakeXYWH(x, y, src.width(), src.height());
+    const SkIRect* bounds = nullptr;
+    if (paint.canComputeFastBounds()) {
+        SkRect storage;
+        devBounds = paint.computeFastBounds(SkRect::Make(devBounds), &storage).roundOut();
+        devBounds.outset(1, 1);
+        bounds = &devBounds;
+    }
+    this->recordDevDraw(bounds, [src, x, y, paint](const SkDraw& draw) {
+        draw.drawSprite(src, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
+                                     const SkRect* dstOrNull, const SkPaint& paint) {
+    SkBitmap src;
+    if (!this->snapshot(bitmap, &src)) {
+        this->flush();
+        INHERITED::drawBitmap(bitmap, matrix, dstOrNull, paint);
+        return;
+    }
+
+    const SkRect localBounds = dstOrNull ? *dstOrNull
+                                         : matrix.mapRect(SkRect::MakeIWH(src.width(),
+                                                                          src.height()));
+    SkRect storage;
+    const SkRect* bounds = paint.canComputeFastBounds()
+                         ? &paint.computeFastBounds(localBounds, &storage)
+                         : nullptr;
+
+    // Compute the matrix type now; it's cached lazily and every tile reads it.
+    (void)matrix.getType();
+
+    const bool hasDst = dstOrNull != nullptr;
+    const SkRect dst  = hasDst ? *dstOrNull : SkRect::MakeEmpty();
+    this->recordDraw(bounds, [src, matrix, hasDst, dst, paint](const SkDraw& draw) {
+        draw.drawBitmap(src, matrix, hasDst ? &dst : nullptr, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawGlyphRunList(const SkGlyphRunList& glyphRunList) {
+    // Glyph runs point at storage owned by the caller, so draw them right away.
+    this->flush();
+    INHERITED::drawGlyphRunList(glyphRunList);
+}
+
+void SkThreadedBMPDevice::drawVertices(const SkVertices* vertices, const SkVertices::Bone bones[],
+                                       int boneCount, SkBlendMode bmode, const SkPaint& paint) {
+    // Bones move the vertices, so only trust the bounds without them.
+    const SkRect* bounds = boneCount ? nullptr : &vertices->bounds();
+    std::vector<SkVertices::Bone> boneStorage(bones, bones + boneCount);
+    sk_sp<SkVertices> verts = sk_ref_sp(vertices);
+    this->recordDraw(bounds, [verts, boneStorage, bmode, paint](const SkDraw& draw) {
+        draw.drawVertices(verts->mode(), verts->vertexCount(), verts->positions(),
+                          verts->texCoords(), verts->colors(), verts->boneIndices(),
+                          verts->boneWeights(), bmode, verts->indices(), verts->indexCount(),
+                          paint, boneStorage.data(), SkToInt(boneStorage.size()));
+    });
+}
+
+void SkThreadedBMPDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPaint& paint) {
+    // Coverage-tracking layers are drawn directly with an SkDraw; everything else ends up in our
+    // (deferred) drawSprite().
+    if (static_cast<SkBitmapDevice*>(device)->accessCoverage()) {
+        this->flush();
+    }
+    INHERITED::drawDevice(device, x, y, paint);
+}
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
+    this->flush();
+    return INHERITED::snapSpecial();
+}
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapBackImage(const SkIRect& bounds) {
+    this->flush();
+    return INHERITED::snapBackImage(bounds);
+}
+
+bool SkThreadedBMPDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return INHERITED::onReadPixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return INHERITED::onWritePixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onPeekPixels(pmap);
+}
+
+bool SkThreadedBMPDevice::onAccessPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onAccessPixels(pmap);
+}
+
+void SkThreadedBMPDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
+    this->flush();
+    INHERITED::replaceBitmapBackendForRasterSurface(bm);
+}
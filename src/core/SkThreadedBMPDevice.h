@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBMPDevice_DEFINED
+#define SkThreadedBMPDevice_DEFINED
+
+#include "SkBitmapDevice.h"
+#include "SkBlitRecorder.h"
+#include "SkDraw.h"
+#include "SkExecutor.h"
+#include "SkMutex.h"
+#include "SkRasterClip.h"
+#include "SkTArray.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ *  An SkBitmapDevice that records draws instead of rasterizing them immediately. On flush() the
+ *  device is split into tiles, and each tile replays every recorded draw that touches it, clipped
+ *  to the tile, on an SkExecutor. Tiles never share pixels, so they can be rasterized in any
+ *  order (and concurrently) while producing the same pixels as the single-threaded SkBitmapDevice.
+ *  Paths and rrects that span several tiles are scan converted only once, and each tile blits its
+ *  own rows of the result.
+ *
+ *  Draws that need to read back the device (layers with coverage, text, reads of the pixels)
+ *  flush first and then fall back to the SkBitmapDevice implementation.
+ */
+class SkThreadedBMPDevice : public SkBitmapDevice {
+public:
+    // Tiles are drawn on executor, or on SkExecutor::GetDefault() when it's null, so devices
+    // share their threads.  The device is split into (at least) tiles horizontal bands.
+    SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& props,
+                        int tiles, SkExecutor* executor = nullptr);
+    ~SkThreadedBMPDevice() override { this->flush(); }
+
+    void flush() override;
+
+    int tileCount() const { return fTileBounds.count(); }
+
+protected:
+    void drawPaint(const SkPaint& paint) override;
+    void drawPoints(SkCanvas::PointMode mode, size_t count,
+                    const SkPoint[], const SkPaint& paint) override;
+    void drawRect(const SkRect& r, const SkPaint& paint) override;
+    void drawRects(const SkRect rects[], const SkColor colors[], int count,
+                   const SkPaint& paint) override;
+    void drawRRect(const SkRRect& rr, const SkPaint& paint) override;
+    void drawPath(const SkPath&, const SkPaint&, bool pathIsMutable) override;
+    void drawSprite(const SkBitmap&, int x, int y, const SkPaint&) override;
+    void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
+                    const SkPaint&) override;
+
+    void drawGlyphRunList(const SkGlyphRunList& glyphRunList) override;
+    void drawVertices(const SkVertices*, const SkVertices::Bone bones[], int boneCount, SkBlendMode,
+                      const SkPaint& paint) override;
+    void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
+
+    sk_sp<SkSpecialImage> snapSpecial() override;
+    sk_sp<SkSpecialImage> snapBackImage(const SkIRect&) override;
+
+    bool onReadPixels(const SkPixmap&, int x, int y) override;
+    bool onWritePixels(const SkPixmap&, int, int) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+private:
+    using DrawFn = std::function<void(const SkDraw&)>;
+
+    // The blits of a draw that spans several tiles, recorded by the first tile to get to it and
+    // then replayed by each tile, so that the draw is only scan converted once.
+    struct SharedScan {
+        SkMutex          fMutex;
+        bool             fRecorded = false;
+        SkBlitRecorder   fRecorder;
+        std::atomic<int> fTilesLeft;   // the last tile to replay fRecorder resets it
+    };
+
+    // A recorded draw: the matrix and clip at the time it was issued, its conservative device
+    // bounds, a closure that replays it against an SkDraw, and (optionally) its shared scan.
+    struct DrawElement {
+        SkMatrix                    fMatrix;
+        SkRasterClip                fRC;
+        SkIRect                     fDevBounds;
+        DrawFn                      fDraw;
+        std::unique_ptr<SharedScan> fScan;
+    };
+
+    // Records fn to be replayed later on every tile it touches.  localBounds (if not null) is in
+    // local coordinates and is used to skip tiles the draw can't touch.  If shareScan is set, fn
+    // only draws through SkAutoBlitterChoose (see SkBlitRecorder), and so can be shared by tiles.
+    void recordDraw(const SkRect* localBounds, DrawFn fn, bool shareScan = false);
+    void recordDevDraw(const SkIRect* devBounds, DrawFn fn, bool shareScan = false);
+
+    void drawTile(int tileIndex, const SkPixmap& root) const;
+
+    // Tiles read a bitmap's pixels when they're flushed, so this copies any the caller may still
+    // change (a layer, a surface about to copy-on-write...) into dst.  Returns false if it can't.
+    bool snapshot(const SkBitmap& bitmap, SkBitmap* dst);
+
+    void replaceBitmapBackendForRasterSurface(const SkBitmap&) override;
+
+    SkExecutor*              fExecutor;
+    SkTArray<SkIRect>        fTileBounds;
+    bool                     fTranslateTiles;
+    std::vector<DrawElement> fQueue;
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+#endif // SkThreadedBMPDevice_DEFINED
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBigPicture.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkImage_Base.h"
+#include "SkPicturePriv.h"
+#include "SkRTree.h"
+#include "SkRecordDraw.h"
+#include "SkTaskGroup.h"
+#include "SkTiledPictureDraw.h"
+
+namespace {
+
+// Returns the image an op draws, if it draws one.
+struct ImageFinder {
+    template <typename T>
+    const SkImage* operator()(const T&) { return nullptr; }
+
+    const SkImage* operator()(const SkRecords::DrawImage& op)        { return op.image.get(); }
+    const SkImage* operator()(const SkRecords::DrawImageLattice& op) { return op.image.get(); }
+    const SkImage* operator()(const SkRecords::DrawImageNine& op)    { return op.image.get(); }
+    const SkImage* operator()(const SkRecords::DrawImageRect& op)    { return op.image.get(); }
+    const SkImage* operator()(const SkRecords::DrawAtlas& op)        { return op.atlas.get(); }
+};
+
+}  // namespace
+
+SkTiledPictureDraw::SkTiledPictureDraw(sk_sp<SkPicture> picture) : fPicture(std::move(picture)) {
+    SkASSERT(fPicture);
+    const SkBigPicture* bigPicture = SkPicturePriv::AsSkBigPicture(fPicture);
+    if (bigPicture && !bigPicture->bbh()) {
+        const SkRecord& record = *bigPicture->record();
+        SkAutoTMalloc<SkRect> bounds(record.count());
+        SkRecordFillBounds(fPicture->cullRect(), record, bounds);
+        fBBH.reset(new SkRTree);
+        fBBH->insert(bounds, record.count());
+    }
+}
+
+SkTiledPictureDraw::~SkTiledPictureDraw() {}
+
+void SkTiledPictureDraw::add(SkCanvas* canvas, const SkIRect& bounds) {
+    if (nullptr == canvas) {
+        SkDEBUGFAIL("parameters to SkTiledPictureDraw::add should be non-nullptr");
+        return;
+    }
+    Tile& tile = fTiles.push_back();
+    tile.fCanvas = canvas;
+    tile.fBounds = bounds;
+
+    // Other pictures are small enough to play back whole into each tile.
+    const SkBigPicture* bigPicture = SkPicturePriv::AsSkBigPicture(fPicture);
+    if (!bigPicture) {
+        return;
+    }
+
+    // Like SkRecordDraw(), which queries the canvas' local clip bounds, look a device pixel past
+    // the tile for ops antialiased into it.  The canvas' matrix decides how far that is here.
+    SkMatrix ctm = canvas->getTotalMatrix();
+    ctm.preTranslate(SkIntToScalar(-bounds.x()), SkIntToScalar(-bounds.y()));
+    SkMatrix inverse;
+    SkRect query = SkRect::Make(bounds).makeOutset(1, 1);
+    if (ctm.invert(&inverse)) {
+        query = inverse.mapRect(ctm.mapRect(SkRect::Make(bounds)).makeOutset(1, 1));
+    }
+    const SkBBoxHierarchy* bbh = bigPicture->bbh() ? bigPicture->bbh() : fBBH.get();
+    bbh->search(query, &tile.fOps);
+
+    const int tileIndex = fTiles.count() - 1;
+    for (int op : tile.fOps) {
+        if (const SkImage* image = bigPicture->record()->visit(op, ImageFinder())) {
+            ImageTiles* tiles = fImages.find(image);
+            if (!tiles) {
+                tiles = fImages.set(image, ImageTiles{-1, 0});
+            }
+            if (tiles->fLastTile != tileIndex) {
+                tiles->fLastTile = tileIndex;
+                tiles->fTileCount++;
+            }
+        }
+    }
+}
+
+void SkTiledPictureDraw::draw(SkExecutor* executor) {
+    SkExecutor& tileExecutor = executor ? *executor : SkExecutor::GetDefault();
+
+    // Each tile drawing a lazy image would decode it, all at about the same time.  Decode the
+    // ones drawn by several tiles first, so the tiles all find them in the bitmap cache.
+    SkTDArray<const SkImage*> sharedImages;
+    fImages.foreach([&](const SkImage* image, ImageTiles* tiles) {
+        if (tiles->fTileCount > 1 && image->isLazyGenerated()) {
+            sharedImages.push_back(image);
+        }
+    });
+    // Holding onto the decoded bitmaps keeps them alive until all the tiles are drawn.
+    SkAutoTArray<SkBitmap> decoded(sharedImages.count());
+    SkTaskGroup(tileExecutor).batch(sharedImages.count(), [&](int i) {
+        as_IB(sharedImages[i])->getROPixels(&decoded[i]);
+    });
+
+    SkTaskGroup(tileExecutor).batch(fTiles.count(), [&](int i) {
+        this->drawTile(fTiles[i]);
+    });
+}
+
+void SkTiledPictureDraw::drawTile(const Tile& tile) const {
+    SkCanvas* canvas = tile.fCanvas;
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+    canvas->translate(SkIntToScalar(-tile.fBounds.x()), SkIntToScalar(-tile.fBounds.y()));
+    canvas->clipRect(SkRect::Make(tile.fBounds));
+
+    if (const SkBigPicture* bigPicture = SkPicturePriv::AsSkBigPicture(fPicture)) {
+        bigPicture->playbackOps(canvas, tile.fOps.begin(), tile.fOps.count());
+    } else {
+        fPicture->playback(canvas);
+    }
+}
@@ -7,47 +7,81 @@
 
 #include "SkTypefaceCache.h"
 #include "SkMutex.h"
+#include "SkOpts.h"
+#include "SkTArray.h"
 #include <atomic>
 
 #define TYPEFACE_CACHE_LIMIT    1024
 
 SkTypefaceCache::SkTypefaceCache() {}
 
+SkTypefaceCache::~SkTypefaceCache() {}
+
 void SkTypefaceCache::add(sk_sp<SkTypeface> face) {
-    if (fTypefaces.count() >= TYPEFACE_CACHE_LIMIT) {
+    this->add(std::move(face), kNoHash);
+}
+
+void SkTypefaceCache::add(sk_sp<SkTypeface> face, uint32_t hash) {
+    if (fCount.load(std::memory_order_relaxed) >= TYPEFACE_CACHE_LIMIT) {
         this->purge(TYPEFACE_CACHE_LIMIT >> 2);
     }
 
-    fTypefaces.emplace_back(std::move(face));
+    Shard& shard = fShards[hash % kShardCount];
+    SkAutoExclusive lock(shard.fLock);
+    shard.fTypefaces.emplace(hash, std::move(face));
+    fCount++;
+}
+
+sk_sp<SkTypeface> SkTypefaceCache::FindInShard(const Shard& shard, uint32_t hash,
+                                               FindProc proc, void* ctx) {
+    SkAutoSharedMutexShared lock(shard.fLock);
+    auto range = shard.fTypefaces.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (proc(it->second.get(), ctx)) {
+            return it->second;
+        }
+    }
+    return nullptr;
 }
 
 sk_sp<SkTypeface> SkTypefaceCache::findByProcAndRef(FindProc proc, void* ctx) const {
-    for (const sk_sp<SkTypeface>& typeface : fTypefaces) {
-        if (proc(typeface.get(), ctx)) {
-            return typeface;
+    for (const Shard& shard : fShards) {
+        SkAutoSharedMutexShared lock(shard.fLock);
+        for (const auto& entry : shard.fTypefaces) {
+            if (proc(entry.second.get(), ctx)) {
+                return entry.second;
+            }
         }
     }
     return nullptr;
 }
 
-void SkTypefaceCache::purge(int numToPurge) {
-    int count = fTypefaces.count();
-    int i = 0;
-    while (i < count) {
-        if (fTypefaces[i]->unique()) {
-            fTypefaces.removeShuffle(i);
-            --count;
-            if (--numToPurge == 0) {
-                return;
+sk_sp<SkTypeface> SkTypefaceCache::findByProcAndRef(uint32_t hash, FindProc proc,
+                                                    void* ctx) const {
+    return FindInShard(fShards[hash % kShardCount], hash, proc, ctx);
+}
+
+int SkTypefaceCache::purge(int numToPurge) {
+    // The typefaces are released after the locks, since deleting one may take other locks.
+    SkTArray<sk_sp<SkTypeface>> purged;
+    for (Shard& shard : fShards) {
+        SkAutoExclusive lock(shard.fLock);
+        auto it = shard.fTypefaces.begin();
+        while (it != shard.fTypefaces.end() && purged.count() < numToPurge) {
+            if (it->second->unique()) {
+                purged.push_back(std::move(it->second));
+                it = shard.fTypefaces.erase(it);
+                fCount--;
+            } else {
+                ++it;
             }
-        } else {
-            ++i;
         }
     }
+    return purged.count();
 }
 
 void SkTypefaceCache::purgeAll() {
-    this->purge(fTypefaces.count());
+    this->purge(TYPEFACE_CACHE_LIMIT + fCount.load());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -62,20 +96,28 @@ SkFontID SkTypefaceCache::NewFontID() {
     return nextID++;
 }
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
+uint32_t SkTypefaceCache::HashFamilyAndStyle(const char familyName[], const SkFontStyle& style) {
+    uint32_t styleBits = (style.weight() << 16) | (style.width() << 8) | style.slant();
+    return SkOpts::hash(familyName, familyName ? strlen(familyName) : 0, styleBits);
+}
 
 void SkTypefaceCache::Add(sk_sp<SkTypeface> face) {
-    SkAutoMutexAcquire ama(gMutex);
     Get().add(std::move(face));
 }
 
+void SkTypefaceCache::Add(sk_sp<SkTypeface> face, uint32_t hash) {
+    Get().add(std::move(face), hash);
+}
+
 sk_sp<SkTypeface> SkTypefaceCache::FindByProcAndRef(FindProc proc, void* ctx) {
-    SkAutoMutexAcquire ama(gMutex);
     return Get().findByProcAndRef(proc, ctx);
 }
 
+sk_sp<SkTypeface> SkTypefaceCache::FindByProcAndRef(uint32_t hash, FindProc proc, void* ctx) {
+    return Get().findByProcAndRef(hash, proc, ctx);
+}
+
 void SkTypefaceCache::PurgeAll() {
-    SkAutoMutexAcquire ama(gMutex);
     Get().purgeAll();
 }
 
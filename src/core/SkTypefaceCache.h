@@ -11,12 +11,21 @@
 #define SkTypefaceCache_DEFINED
 
 #include "SkRefCnt.h"
+#include "SkSharedMutex.h"
 #include "SkTypeface.h"
-#include "SkTArray.h"
 
+#include <atomic>
+#include <unordered_map>
+
+/**
+ *  The cache is thread safe. Typefaces are spread over shards by a hash their owners choose, such
+ *  as one of their family name and style, and finds with a hash only look at the typefaces added
+ *  with it. Finds only take their shard's lock shared, so they don't wait on each other.
+ */
 class SkTypefaceCache {
 public:
     SkTypefaceCache();
+    ~SkTypefaceCache();
 
     /**
      * Callback for FindByProc. Returns true if the given typeface is a match
@@ -31,6 +40,11 @@ public:
      */
     void add(sk_sp<SkTypeface>);
 
+    /**
+     *  Add a typeface to be found by findByProcAndRef() with the same hash.
+     */
+    void add(sk_sp<SkTypeface>, uint32_t hash);
+
     /**
      *  Iterate through the cache, calling proc(typeface, ctx) for each typeface.
      *  If proc returns true, then return that typeface.
@@ -38,6 +52,11 @@ public:
      */
     sk_sp<SkTypeface> findByProcAndRef(FindProc proc, void* ctx) const;
 
+    /**
+     *  Like findByProcAndRef(proc, ctx), but only calls proc for the typefaces added with hash.
+     */
+    sk_sp<SkTypeface> findByProcAndRef(uint32_t hash, FindProc proc, void* ctx) const;
+
     /**
      *  This will unref all of the typefaces in the cache for which the cache
      *  is the only owner. Normally this is handled automatically as needed.
@@ -52,10 +71,17 @@ public:
      */
     static SkFontID NewFontID();
 
+    /**
+     *  Helper: returns a hash of a family name and style, to add and find typefaces with.
+     */
+    static uint32_t HashFamilyAndStyle(const char familyName[], const SkFontStyle&);
+
     // These are static wrappers around a global instance of a cache.
 
     static void Add(sk_sp<SkTypeface>);
+    static void Add(sk_sp<SkTypeface>, uint32_t hash);
     static sk_sp<SkTypeface> FindByProcAndRef(FindProc proc, void* ctx);
+    static sk_sp<SkTypeface> FindByProcAndRef(uint32_t hash, FindProc proc, void* ctx);
     static void PurgeAll();
 
     /**
@@ -64,11 +90,24 @@ public:
     static void Dump();
 
 private:
+    static constexpr int kShardCount = 16;
+    // Typefaces added without a hash have this one.
+    static constexpr uint32_t kNoHash = 0;
+
+    struct Shard {
+        mutable SkSharedMutex fLock;
+        std::unordered_multimap<uint32_t, sk_sp<SkTypeface>> fTypefaces;
+    };
+
     static SkTypefaceCache& Get();
 
-    void purge(int count);
+    static sk_sp<SkTypeface> FindInShard(const Shard&, uint32_t hash, FindProc proc, void* ctx);
+
+    // Removes up to count typefaces that only the cache owns, and returns how many it removed.
+    int purge(int count);
 
-    SkTArray<sk_sp<SkTypeface>> fTypefaces;
+    Shard            fShards[kShardCount];
+    std::atomic<int> fCount{0};
 };
 
 #endif
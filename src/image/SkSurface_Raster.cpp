@@ -11,6 +11,7 @@
 #include "SkCanvas.h"
 #include "SkDevice.h"
 #include "SkMallocPixelRef.h"
+#include "SkThreadedBMPDevice.h"
 
 class SkSurface_Raster : public SkSurface_Base {
 public:
@@ -19,6 +20,12 @@ public:
                      const SkSurfaceProps*);
     SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef>, const SkSurfaceProps*);
 
+    // Draw through an SkThreadedBMPDevice split into this many tiles, drawn on executor.
+    void setThreaded(int tiles, SkExecutor* executor) {
+        fTiles = tiles;
+        fExecutor = executor;
+    }
+
     SkCanvas* onNewCanvas() override;
     sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
     sk_sp<SkImage> onNewImageSnapshot(const SkIRect* subset) override;
@@ -28,9 +35,18 @@ public:
     void onRestoreBackingMutability() override;
 
 private:
+    // Threaded canvases defer their draws; make sure they've landed in fBitmap.
+    void flushThreadedCanvas() {
+        if (fTiles > 0) {
+            this->getCachedCanvas()->flush();
+        }
+    }
+
     SkBitmap    fBitmap;
     size_t      fRowBytes;
     bool        fWeOwnThePixels;
+    int         fTiles = 0;
+    SkExecutor* fExecutor = nullptr;
 
     typedef SkSurface_Base INHERITED;
 };
@@ -87,7 +103,13 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr
     fWeOwnThePixels = true;
 }
 
-SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
+SkCanvas* SkSurface_Raster::onNewCanvas() {
+    if (fTiles > 0) {
+        return new SkCanvas(sk_make_sp<SkThreadedBMPDevice>(fBitmap, this->props(),
+                                                            fTiles, fExecutor));
+    }
+    return new SkCanvas(fBitmap, this->props());
+}
 
 sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
     return SkSurface::MakeRaster(info, &this->props());
@@ -95,10 +117,12 @@ sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
 
 void SkSurface_Raster::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
                               const SkPaint* paint) {
+    this->flushThreadedCanvas();
     canvas->drawBitmap(fBitmap, x, y, paint);
 }
 
 sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
+    this->flushThreadedCanvas();
     if (subset) {
         SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
         SkBitmap dst;
@@ -125,6 +149,7 @@ sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
 }
 
 void SkSurface_Raster::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->flushThreadedCanvas();
     fBitmap.writePixels(src, x, y);
 }
 
@@ -136,6 +161,7 @@ void SkSurface_Raster::onRestoreBackingMutability() {
 }
 
 void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
+    this->flushThreadedCanvas();
     // are we sharing pixelrefs with the image?
     sk_sp<SkImage> cached(this->refCachedImage());
     SkASSERT(cached);
@@ -199,6 +225,21 @@ sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
     return sk_make_sp<SkSurface_Raster>(info, std::move(pr), props);
 }
 
+sk_sp<SkSurface> SkSurface::MakeRasterThreaded(const SkImageInfo& info, int tiles,
+                                               SkExecutor* executor, const SkSurfaceProps* props) {
+    if (tiles <= 0 || !SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeZeroed(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    auto surface = sk_make_sp<SkSurface_Raster>(info, std::move(pr), props);
+    surface->setThreaded(tiles, executor);
+    return std::move(surface);
+}
+
 sk_sp<SkSurface> SkSurface::MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps) {
     return MakeRaster(SkImageInfo::MakeN32Premul(width, height), surfaceProps);
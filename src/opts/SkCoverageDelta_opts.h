@@ -0,0 +1,104 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCoverageDelta_opts_DEFINED
+#define SkCoverageDelta_opts_DEFINED
+
+#include "SkCoverageDelta.h"
+#include "SkNx.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#endif
+
+namespace SK_OPTS_NS {
+
+    // A coverage is the running sum of the deltas to its left, so each chunk of coverages is the
+    // prefix sum of its deltas plus the last coverage of the previous chunk.  We compute the
+    // prefix sums in registers with log2(N) shift-and-adds instead of one add per delta.
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    static SK_ALWAYS_INLINE __m256i coverage_to_alpha(__m256i c, bool isEvenOdd, bool isInverse,
+                                                      bool isConvex) {
+        __m256i a;
+        if (isConvex) {
+            a = _mm256_srai_epi32(_mm256_abs_epi32(c), 8);
+            a = _mm256_sub_epi32(a, _mm256_srai_epi32(a, 8));   // 256 to 255
+        } else {
+            if (isEvenOdd) {
+                __m256i mod17 = _mm256_and_si256(c, _mm256_set1_epi32(0x1ffff)),
+                        mod16 = _mm256_and_si256(c, _mm256_set1_epi32(0xffff));
+                c = _mm256_sub_epi32(_mm256_slli_epi32(mod16, 1), mod17);
+            }
+            a = _mm256_srai_epi32(_mm256_abs_epi32(c), 8);
+            a = _mm256_max_epi32(_mm256_min_epi32(a, _mm256_set1_epi32(255)),
+                                 _mm256_setzero_si256());
+        }
+        return isInverse ? _mm256_sub_epi32(_mm256_set1_epi32(255), a) : a;
+    }
+
+    /*not static*/ inline void coverage_deltas_to_alpha(const SkFixed deltas[], SkAlpha alphas[],
+                                                        int count, bool isEvenOdd, bool isInverse,
+                                                        bool isConvex) {
+        SkASSERT(count % 8 == 0);
+        const __m256i lowTotal = _mm256_setr_epi32(0,0,0,0, 3,3,3,3),
+                      allLast  = _mm256_set1_epi32(7);
+        __m256i carry = _mm256_setzero_si256();
+        for (int i = 0; i < count; i += 8) {
+            __m256i c = _mm256_loadu_si256((const __m256i*)(deltas + i));
+            // Prefix sums within each 128-bit half, then add the low half's total to the high.
+            c = _mm256_add_epi32(c, _mm256_slli_si256(c, 4));
+            c = _mm256_add_epi32(c, _mm256_slli_si256(c, 8));
+            c = _mm256_add_epi32(c, _mm256_blend_epi32(_mm256_setzero_si256(),
+                                                       _mm256_permutevar8x32_epi32(c, lowTotal),
+                                                       0xf0));
+            c = _mm256_add_epi32(c, carry);
+            carry = _mm256_permutevar8x32_epi32(c, allLast);
+
+            // The alphas are in [0,255], so saturating packs are exact.  Packing works within
+            // 128-bit halves, leaving alphas 0-3 in the low half and 4-7 in the high half.
+            __m256i a = coverage_to_alpha(c, isEvenOdd, isInverse, isConvex);
+            a = _mm256_packus_epi32(a, a);
+            a = _mm256_packus_epi16(a, a);
+            __m128i a8 = _mm_unpacklo_epi32(_mm256_castsi256_si128(a),
+                                            _mm256_extracti128_si256(a, 1));
+            _mm_storel_epi64((__m128i*)(alphas + i), a8);
+        }
+    }
+#else
+    static SK_ALWAYS_INLINE Sk4i prefix_sum(const Sk4i& v) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        __m128i s = _mm_add_epi32(v.fVec, _mm_slli_si128(v.fVec, 4));
+        return _mm_add_epi32(s, _mm_slli_si128(s, 8));
+    #elif defined(SK_ARM_HAS_NEON)
+        const int32x4_t zero = vdupq_n_s32(0);
+        int32x4_t s = vaddq_s32(v.fVec, vextq_s32(zero, v.fVec, 3));
+        return vaddq_s32(s, vextq_s32(zero, s, 2));
+    #else
+        return Sk4i(v[0], v[0] + v[1], v[0] + v[1] + v[2], v[0] + v[1] + v[2] + v[3]);
+    #endif
+    }
+
+    /*not static*/ inline void coverage_deltas_to_alpha(const SkFixed deltas[], SkAlpha alphas[],
+                                                        int count, bool isEvenOdd, bool isInverse,
+                                                        bool isConvex) {
+        SkASSERT(count % 4 == 0);
+        Sk4i carry(0);
+        for (int i = 0; i < count; i += 4) {
+            Sk4i c = prefix_sum(Sk4i::Load(deltas + i)) + carry;
+            carry = Sk4i(c[3]);
+
+            Sk4i a = isConvex ? ConvexCoverageToAlpha(c, isInverse)
+                              : CoverageToAlpha(c, isEvenOdd, isInverse);
+            SkNx_cast<uint8_t>(a).store(alphas + i);
+        }
+    }
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkCoverageDelta_opts_DEFINED
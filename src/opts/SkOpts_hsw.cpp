@@ -8,11 +8,14 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS hsw
+#include "SkCoverageDelta_opts.h"
 #include "SkRasterPipeline_opts.h"
 #include "SkUtils_opts.h"
 
 namespace SkOpts {
     void Init_hsw() {
+        coverage_deltas_to_alpha = hsw::coverage_deltas_to_alpha;
+
     #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_highp = (StageFn)SK_OPTS_NS::just_return;
@@ -83,8 +83,10 @@ struct Ctx {
     #define JUMPER_IS_SCALAR
 #elif defined(SK_ARM_HAS_NEON)
     #define JUMPER_IS_NEON
-#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX512
-    #define JUMPER_IS_AVX512
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX512 && defined(__AVX512BW__) \
+                                                  && defined(__AVX512DQ__) \
+                                                  && defined(__AVX512VL__)
+    #define JUMPER_IS_SKX
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
     #define JUMPER_IS_HSW
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
@@ -289,7 +291,136 @@ namespace SK_OPTS_NS {
         }
     }
 
-#elif defined(JUMPER_IS_AVX) || defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#elif defined(JUMPER_IS_SKX)
+    // These are __m512 and __m512i, but friendlier and strongly-typed.
+    template <typename T> using V = T __attribute__((ext_vector_type(16)));
+    using F   = V<float   >;
+    using I32 = V< int32_t>;
+    using U64 = V<uint64_t>;
+    using U32 = V<uint32_t>;
+    using U16 = V<uint16_t>;
+    using U8  = V<uint8_t >;
+
+    SI F   mad(F f, F m, F a)   { return _mm512_fmadd_ps(f,m,a); }
+    SI F   min(F a, F b)        { return _mm512_min_ps(a,b);     }
+    SI F   max(F a, F b)        { return _mm512_max_ps(a,b);     }
+    SI F   abs_  (F v)          { return _mm512_abs_ps(v);       }
+    SI F   floor_(F v)          { return _mm512_floor_ps(v);     }
+    SI F   rcp   (F v)          { return _mm512_rcp14_ps  (v);   }
+    SI F   rsqrt (F v)          { return _mm512_rsqrt14_ps(v);   }
+    SI F    sqrt_(F v)          { return _mm512_sqrt_ps (v);     }
+    SI U32 round (F v, F scale) { return _mm512_cvtps_epi32(v*scale); }
+
+    // Clamp negative lanes to zero first so these saturate just like _mm_packus_epi{32,16}.
+    SI U16 pack(U32 v) {
+        return _mm512_cvtusepi32_epi16(_mm512_max_epi32(v, _mm512_setzero_si512()));
+    }
+    SI U8 pack(U16 v) {
+        return _mm256_cvtusepi16_epi8(_mm256_max_epi16(v, _mm256_setzero_si256()));
+    }
+
+    SI F if_then_else(I32 c, F t, F e) {
+        return _mm512_mask_blend_ps(_mm512_movepi32_mask(c), e,t);
+    }
+
+    template <typename T>
+    SI V<T> gather(const T* p, U32 ix) {
+        return { p[ix[ 0]], p[ix[ 1]], p[ix[ 2]], p[ix[ 3]],
+                 p[ix[ 4]], p[ix[ 5]], p[ix[ 6]], p[ix[ 7]],
+                 p[ix[ 8]], p[ix[ 9]], p[ix[10]], p[ix[11]],
+                 p[ix[12]], p[ix[13]], p[ix[14]], p[ix[15]], };
+    }
+    SI F   gather(const float*    p, U32 ix) { return _mm512_i32gather_ps   (ix, p, 4); }
+    SI U32 gather(const uint32_t* p, U32 ix) { return _mm512_i32gather_epi32(ix, p, 4); }
+    SI U64 gather(const uint64_t* p, U32 ix) {
+        __m512i parts[] = {
+            _mm512_i32gather_epi64(_mm512_castsi512_si256    (ix   ), p, 8),
+            _mm512_i32gather_epi64(_mm512_extracti64x4_epi64(ix, 1), p, 8),
+        };
+        return bit_cast<U64>(parts);
+    }
+
+    // With 16 lanes the tails get long, so instead of a switch we load and store them with byte
+    // masks, 16 bytes at a time.  Masked-off bytes are never touched, so this can't fault.
+    SI __mmask16 byte_mask(size_t bytes) {
+        return bytes >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << bytes) - 1);
+    }
+    template <typename T>
+    SI T load_masked(const void* src, size_t bytes) {
+        T v;
+        for (size_t i = 0; i < sizeof(T); i += 16) {
+            __m128i chunk = _mm_maskz_loadu_epi8(byte_mask(bytes > i ? bytes - i : 0),
+                                                 (const char*)src + i);
+            memcpy((char*)&v + i, &chunk, 16);
+        }
+        return v;
+    }
+    template <typename T>
+    SI void store_masked(void* dst, const T& v, size_t bytes) {
+        for (size_t i = 0; i < sizeof(T) && i < bytes; i += 16) {
+            __m128i chunk;
+            memcpy(&chunk, (const char*)&v + i, 16);
+            _mm_mask_storeu_epi8((char*)dst + i, byte_mask(bytes - i), chunk);
+        }
+    }
+
+    // The interlaced loads and stores below work a pixel per lane with masked gathers and
+    // scatters, where a tail of 0 means all 16 lanes are active.
+    SI __mmask16 tail_mask(size_t tail) {
+        return tail ? (__mmask16)((1u << tail) - 1) : (__mmask16)0xffff;
+    }
+    SI I32 lane_index() {
+        return I32{0,1,2,3, 4,5,6,7, 8,9,10,11, 12,13,14,15};
+    }
+
+    SI void load3(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b) {
+        // Each pixel is 6 bytes: gather r,g from byte 6i, then g,b from byte 6i+2.
+        const I32       ix = lane_index() * 6;
+        const __mmask16 m  = tail_mask(tail);
+        U32 rg = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), m, ix, ptr + 0, 1),
+            gb = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), m, ix, ptr + 1, 1);
+        *r = __builtin_convertvector(rg      , U16);
+        *g = __builtin_convertvector(rg >> 16, U16);
+        *b = __builtin_convertvector(gb >> 16, U16);
+    }
+    SI void load4(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b, U16* a) {
+        U64 px = __builtin_expect(tail,0) ? load_masked<U64>(ptr, tail*8)
+                                          : unaligned_load<U64>(ptr);
+        *r = __builtin_convertvector(px      , U16);
+        *g = __builtin_convertvector(px >> 16, U16);
+        *b = __builtin_convertvector(px >> 32, U16);
+        *a = __builtin_convertvector(px >> 48, U16);
+    }
+    SI void store4(uint16_t* ptr, size_t tail, U16 r, U16 g, U16 b, U16 a) {
+        U64 px = __builtin_convertvector(r, U64) <<  0
+               | __builtin_convertvector(g, U64) << 16
+               | __builtin_convertvector(b, U64) << 32
+               | __builtin_convertvector(a, U64) << 48;
+        if (__builtin_expect(tail,0)) {
+            store_masked(ptr, px, tail*8);
+        } else {
+            unaligned_store(ptr, px);
+        }
+    }
+
+    SI void load4(const float* ptr, size_t tail, F* r, F* g, F* b, F* a) {
+        const I32       ix = lane_index() * 4;
+        const __mmask16 m  = tail_mask(tail);
+        *r = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, ix, ptr + 0, 4);
+        *g = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, ix, ptr + 1, 4);
+        *b = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, ix, ptr + 2, 4);
+        *a = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, ix, ptr + 3, 4);
+    }
+    SI void store4(float* ptr, size_t tail, F r, F g, F b, F a) {
+        const I32       ix = lane_index() * 4;
+        const __mmask16 m  = tail_mask(tail);
+        _mm512_mask_i32scatter_ps(ptr + 0, m, ix, r, 4);
+        _mm512_mask_i32scatter_ps(ptr + 1, m, ix, g, 4);
+        _mm512_mask_i32scatter_ps(ptr + 2, m, ix, b, 4);
+        _mm512_mask_i32scatter_ps(ptr + 3, m, ix, a, 4);
+    }
+
+#elif defined(JUMPER_IS_AVX) || defined(JUMPER_IS_HSW)
     // These are __m256 and __m256i, but friendlier and strongly-typed.
     template <typename T> using V = T __attribute__((ext_vector_type(8)));
     using F   = V<float   >;
@@ -300,7 +431,7 @@ namespace SK_OPTS_NS {
     using U8  = V<uint8_t >;
 
     SI F mad(F f, F m, F a)  {
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+    #if defined(JUMPER_IS_HSW)
         return _mm256_fmadd_ps(f,m,a);
     #else
         return f*m+a;
@@ -332,7 +463,7 @@ namespace SK_OPTS_NS {
         return { p[ix[0]], p[ix[1]], p[ix[2]], p[ix[3]],
                  p[ix[4]], p[ix[5]], p[ix[6]], p[ix[7]], };
     }
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+    #if defined(JUMPER_IS_HSW)
         SI F   gather(const float*    p, U32 ix) { return _mm256_i32gather_ps   (p, ix, 4); }
         SI U32 gather(const uint32_t* p, U32 ix) { return _mm256_i32gather_epi32(p, ix, 4); }
         SI U64 gather(const uint64_t* p, U32 ix) {
@@ -732,7 +863,10 @@ SI F from_half(U16 h) {
 #if defined(SK_CPU_ARM64) && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f32_f16(h);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtph_ps(h);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtph_ps(h);
 
 #else
@@ -752,7 +886,10 @@ SI U16 to_half(F f) {
 #if defined(SK_CPU_ARM64) && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f16_f32(f);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
 
 #else
@@ -887,7 +1024,11 @@ static void start_pipeline(size_t dx, size_t dy, size_t xlimit, size_t ylimit, v
 
 template <typename V, typename T>
 SI V load(const T* src, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_SKX)
+    if (__builtin_expect(tail, 0)) {
+        return load_masked<V>(src, tail*sizeof(T));  // Any inactive lanes are zeroed.
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         V v{};  // Any inactive lanes are zeroed.
@@ -908,7 +1049,12 @@ SI V load(const T* src, size_t tail) {
 
 template <typename V, typename T>
 SI void store(T* dst, V v, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_SKX)
+    if (__builtin_expect(tail, 0)) {
+        store_masked(dst, v, tail*sizeof(T));
+        return;
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         switch (tail) {
@@ -1011,7 +1157,7 @@ STAGE(seed_shader, Ctx::None) {
 
 STAGE(dither, const float* rate) {
     // Get [(dx,dy), (dx+1,dy), (dx+2,dy), ...] loaded up in integer vectors.
-    uint32_t iota[] = {0,1,2,3,4,5,6,7};
+    uint32_t iota[] = {0,1,2,3,4,5,6,7, 8,9,10,11,12,13,14,15};
     U32 X = dx + unaligned_load<U32>(iota),
         Y = dy;
 
@@ -1590,7 +1736,7 @@ STAGE(to_srgb, Ctx::None) {
         U32 sign;
         l = strip_sign(l, &sign);
         // We tweak c and d for each instruction set to make sure fn(1) is exactly 1.
-    #if defined(JUMPER_IS_AVX512)
+    #if defined(JUMPER_IS_SKX)
         const float c = 1.130026340485f,
                     d = 0.141387879848f;
     #elif defined(JUMPER_IS_SSE2) || defined(JUMPER_IS_SSE41) || \
@@ -1712,6 +1858,30 @@ STAGE(store_8888, const SkRasterPipeline_MemoryCtx* ctx) {
     store(ptr, px, tail);
 }
 
+// These fuse 8888 loads and stores with swap_rb (see SkRasterPipeline::unchecked_append()).
+STAGE(load_bgra, const SkRasterPipeline_MemoryCtx* ctx) {
+    auto ptr = ptr_at_xy<const uint32_t>(ctx, dx,dy);
+    from_8888(load<U32>(ptr, tail), &b,&g,&r,&a);
+}
+STAGE(load_bgra_dst, const SkRasterPipeline_MemoryCtx* ctx) {
+    auto ptr = ptr_at_xy<const uint32_t>(ctx, dx,dy);
+    from_8888(load<U32>(ptr, tail), &db,&dg,&dr,&da);
+}
+STAGE(gather_bgra, const SkRasterPipeline_GatherCtx* ctx) {
+    const uint32_t* ptr;
+    U32 ix = ix_and_ptr(&ptr, ctx, r,g);
+    from_8888(gather(ptr, ix), &b,&g,&r,&a);
+}
+STAGE(store_bgra, const SkRasterPipeline_MemoryCtx* ctx) {
+    auto ptr = ptr_at_xy<uint32_t>(ctx, dx,dy);
+
+    U32 px = to_unorm(b, 255)
+           | to_unorm(g, 255) <<  8
+           | to_unorm(r, 255) << 16
+           | to_unorm(a, 255) << 24;
+    store(ptr, px, tail);
+}
+
 STAGE(load_1010102, const SkRasterPipeline_MemoryCtx* ctx) {
     auto ptr = ptr_at_xy<const uint32_t>(ctx, dx,dy);
     from_1010102(load<U32>(ptr, tail), &r,&g,&b,&a);
@@ -1933,7 +2103,19 @@ STAGE(matrix_perspective, const float* m) {
 SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         F* r, F* g, F* b, F* a) {
     F fr, br, fg, bg, fb, bb, fa, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <=8) {
+        // The stops are padded to at least 8, and idx never points past them.
+        fr = _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(c->fs[0])));
+        br = _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(c->bs[0])));
+        fg = _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(c->fs[1])));
+        bg = _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(c->bs[1])));
+        fb = _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(c->fs[2])));
+        bb = _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(c->bs[2])));
+        fa = _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(c->fs[3])));
+        ba = _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(c->bs[3])));
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         fr = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->fs[0]), idx);
         br = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->bs[0]), idx);
@@ -2270,7 +2452,7 @@ namespace lowp {
 
 #else  // We are compiling vector code with Clang... let's make some lowp stages!
 
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     using U8  = uint8_t  __attribute__((ext_vector_type(16)));
     using U16 = uint16_t __attribute__((ext_vector_type(16)));
     using I16 =  int16_t __attribute__((ext_vector_type(16)));
@@ -2504,7 +2686,7 @@ SI F mad(F f, F m, F a) { return f*m+a; }
 SI U32 trunc_(F x) { return (U32)cast<I32>(x); }
 
 SI F rcp(F x) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_rcp_ps(lo), _mm256_rcp_ps(hi));
@@ -2525,7 +2707,7 @@ SI F rcp(F x) {
 #endif
 }
 SI F sqrt_(F x) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_sqrt_ps(lo), _mm256_sqrt_ps(hi));
@@ -2560,7 +2742,7 @@ SI F floor_(F x) {
     float32x4_t lo,hi;
     split(x, &lo,&hi);
     return join<F>(vrndmq_f32(lo), vrndmq_f32(hi));
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_floor_ps(lo), _mm256_floor_ps(hi));
@@ -2760,10 +2942,15 @@ SI U32 ix_and_ptr(T** ptr, const SkRasterPipeline_GatherCtx* ctx, F x, F y) {
 
 template <typename V, typename T>
 SI V load(const T* ptr, size_t tail) {
+#if defined(JUMPER_IS_SKX)
+    if (tail & (N-1)) {
+        return load_masked<V>(ptr, (tail & (N-1))*sizeof(T));
+    }
+#endif
     V v = 0;
     switch (tail & (N-1)) {
         case  0: memcpy(&v, ptr, sizeof(v)); break;
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
         case 15: v[14] = ptr[14];
         case 14: v[13] = ptr[13];
         case 13: v[12] = ptr[12];
@@ -2785,9 +2972,15 @@ SI V load(const T* ptr, size_t tail) {
 }
 template <typename V, typename T>
 SI void store(T* ptr, size_t tail, V v) {
+#if defined(JUMPER_IS_SKX)
+    if (tail & (N-1)) {
+        store_masked(ptr, v, (tail & (N-1))*sizeof(T));
+        return;
+    }
+#endif
     switch (tail & (N-1)) {
         case  0: memcpy(ptr, &v, sizeof(v)); break;
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
         case 15: ptr[14] = v[14];
         case 14: ptr[13] = v[13];
         case 13: ptr[12] = v[12];
@@ -2807,7 +3000,7 @@ SI void store(T* ptr, size_t tail, V v) {
     }
 }
 
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     template <typename V, typename T>
     SI V gather(const T* ptr, U32 ix) {
         return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
@@ -2845,7 +3038,7 @@ SI void store(T* ptr, size_t tail, V v) {
 // ~~~~~~ 32-bit memory loads and stores ~~~~~~ //
 
 SI void from_8888(U32 rgba, U16* r, U16* g, U16* b, U16* a) {
-#if 1 && defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if 1 && defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     // Swap the middle 128-bit lanes to make _mm256_packus_epi32() in cast_U16() work out nicely.
     __m256i _01,_23;
     split(rgba, &_01, &_23);
@@ -2929,6 +3122,21 @@ STAGE_GP(gather_8888, const SkRasterPipeline_GatherCtx* ctx) {
     from_8888(gather<U32>(ptr, ix), &r, &g, &b, &a);
 }
 
+STAGE_PP(load_bgra, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_8888_(ptr_at_xy<const uint32_t>(ctx, dx,dy), tail, &b,&g,&r,&a);
+}
+STAGE_PP(load_bgra_dst, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_8888_(ptr_at_xy<const uint32_t>(ctx, dx,dy), tail, &db,&dg,&dr,&da);
+}
+STAGE_PP(store_bgra, const SkRasterPipeline_MemoryCtx* ctx) {
+    store_8888_(ptr_at_xy<uint32_t>(ctx, dx,dy), tail, b,g,r,a);
+}
+STAGE_GP(gather_bgra, const SkRasterPipeline_GatherCtx* ctx) {
+    const uint32_t* ptr;
+    U32 ix = ix_and_ptr(&ptr, ctx, x,y);
+    from_8888(gather<U32>(ptr, ix), &b, &g, &r, &a);
+}
+
 // ~~~~~~ 16-bit memory loads and stores ~~~~~~ //
 
 SI void from_565(U16 rgb, U16* r, U16* g, U16* b) {
@@ -3180,7 +3388,7 @@ SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         U16* r, U16* g, U16* b, U16* a) {
 
     F fr, fg, fb, fa, br, bg, bb, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     if (c->stopCount <=8) {
         __m256i lo, hi;
         split(idx, &lo, &hi);
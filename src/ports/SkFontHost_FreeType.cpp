@@ -27,6 +27,7 @@
 #include "SkScalerContext.h"
 #include "SkStream.h"
 #include "SkString.h"
+#include "SkTLazy.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 
@@ -502,8 +503,10 @@ protected:
     bool generateAdvance(SkGlyph* glyph) override;
     void generateMetrics(SkGlyph* glyph) override;
     void generateImage(const SkGlyph& glyph) override;
+    void generateImages(SkSpan<const SkGlyph* const> glyphs) override;
     bool generatePath(SkGlyphID glyphID, SkPath* path) override;
     void generateFontMetrics(SkFontMetrics*) override;
+    uint32_t generateRasterizerVersion() const override;
 
 private:
     using UnrefFTFace = SkFunctionWrapper<void, SkFaceRec, unref_ft_face>;
@@ -528,6 +531,8 @@ private:
     bool      fLCDIsVert;
 
     FT_Error setupSize();
+    // Caller must lock gFTMutex and call setupSize() before calling this function.
+    void generateImageWithSizeSetUp(const SkGlyph& glyph);
     void getBBoxForCurrentGlyph(const SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
     bool getCBoxForLetter(char letter, FT_BBox* bbox);
@@ -1309,6 +1314,26 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
         clear_glyph_image(glyph);
         return;
     }
+    this->generateImageWithSizeSetUp(glyph);
+}
+
+void SkScalerContext_FreeType::generateImages(SkSpan<const SkGlyph* const> glyphs) {
+    // Take the lock and set the size and transform once for the whole batch.
+    SkAutoMutexAcquire  ac(gFTMutex);
+
+    if (this->setupSize()) {
+        for (const SkGlyph* glyph : glyphs) {
+            clear_glyph_image(*glyph);
+        }
+        return;
+    }
+    for (const SkGlyph* glyph : glyphs) {
+        this->generateImageWithSizeSetUp(*glyph);
+    }
+}
+
+void SkScalerContext_FreeType::generateImageWithSizeSetUp(const SkGlyph& glyph) {
+    gFTMutex.assertHeld();
 
     FT_Error err = FT_Load_Glyph(fFace, glyph.getGlyphID(), fLoadGlyphFlags);
     if (err != 0) {
@@ -1509,6 +1534,15 @@ void SkScalerContext_FreeType::generateFontMetrics(SkFontMetrics* metrics) {
     metrics->fStrikeoutPosition = strikeoutPosition * fScale.y();
 }
 
+uint32_t SkScalerContext_FreeType::generateRasterizerVersion() const {
+    if (!fFace) {
+        return 0;
+    }
+    FT_Int major, minor, patch;
+    FT_Library_Version(fFace->glyph->library, &major, &minor, &patch);
+    return SkSetFourByteTag('F', major, minor, patch);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // hand-tuned value to reduce outline embolden strength
@@ -1576,23 +1610,93 @@ static EncodingProc find_encoding_proc(SkTypeface::Encoding enc) {
     return gProcs[enc];
 }
 
-int SkTypeface_FreeType::onCharsToGlyphs(const void* chars, Encoding encoding,
-                                         uint16_t glyphs[], int glyphCount) const
-{
-    AutoFTAccess fta(this);
-    FT_Face face = fta.face();
-    if (!face) {
-        if (glyphs) {
-            sk_bzero(glyphs, glyphCount * sizeof(glyphs[0]));
+// The glyphs of the BMP, in pages of 256 code points. A page is looked up from the cmap all at
+// once, the first time one of its code points is mapped, and never changes after that, so text
+// in pages that are already there is mapped without taking FreeType's lock.
+struct SkTypeface_FreeType::BMPGlyphs {
+    static constexpr int kPageBits = 8;
+    static constexpr int kPageCount = 0x10000 >> kPageBits;
+    static constexpr int kPageSize = 1 << kPageBits;
+
+    BMPGlyphs() {
+        for (auto& page : fPages) {
+            page.store(nullptr, std::memory_order_relaxed);
         }
-        return 0;
     }
+    ~BMPGlyphs() {
+        for (auto& page : fPages) {
+            delete[] page.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint16_t*> fPages[kPageCount];
+};
+
+SkTypeface_FreeType::~SkTypeface_FreeType() {
+    delete fBMPGlyphs.load(std::memory_order_relaxed);
+}
+
+const uint16_t* SkTypeface_FreeType::findBMPGlyphPage(SkUnichar uni) const {
+    SkASSERT(0 <= uni && uni < 0x10000);
+    BMPGlyphs* bmp = fBMPGlyphs.load(std::memory_order_acquire);
+    return bmp ? bmp->fPages[uni >> BMPGlyphs::kPageBits].load(std::memory_order_acquire)
+               : nullptr;
+}
+
+// Pages are only made under AutoFTAccess, which holds gFTMutex, so one thread makes them at a
+// time.
+const uint16_t* SkTypeface_FreeType::makeBMPGlyphPage(FT_Face face, SkUnichar uni) const {
+    SkASSERT(0 <= uni && uni < 0x10000);
+    gFTMutex.assertHeld();
+    BMPGlyphs* bmp = fBMPGlyphs.load(std::memory_order_relaxed);
+    if (!bmp) {
+        bmp = new BMPGlyphs;
+        fBMPGlyphs.store(bmp, std::memory_order_release);
+    }
+    std::atomic<uint16_t*>& slot = bmp->fPages[uni >> BMPGlyphs::kPageBits];
+    uint16_t* page = slot.load(std::memory_order_relaxed);
+    if (!page) {
+        page = new uint16_t[BMPGlyphs::kPageSize];
+        SkUnichar first = uni & ~(BMPGlyphs::kPageSize - 1);
+        for (int i = 0; i < BMPGlyphs::kPageSize; ++i) {
+            page[i] = SkToU16(FT_Get_Char_Index(face, first + i));
+        }
+        slot.store(page, std::memory_order_release);
+    }
+    return page;
+}
 
+int SkTypeface_FreeType::onCharsToGlyphs(const void* chars, Encoding encoding,
+                                         uint16_t glyphs[], int glyphCount) const
+{
     EncodingProc next_uni_proc = find_encoding_proc(encoding);
 
+    // FreeType is only needed for code points beyond the BMP, or in pages of it that haven't
+    // been looked up yet.
+    SkTLazy<AutoFTAccess> fta;
+    FT_Face face = nullptr;
+    auto glyph_for = [&](SkUnichar uni) -> unsigned {
+        bool inBMP = (unsigned)uni < 0x10000;
+        if (inBMP) {
+            if (const uint16_t* page = this->findBMPGlyphPage(uni)) {
+                return page[uni & (BMPGlyphs::kPageSize - 1)];
+            }
+        }
+        if (!fta.isValid()) {
+            face = fta.init(this)->face();
+        }
+        if (!face) {
+            return 0;
+        }
+        if (inBMP) {
+            return this->makeBMPGlyphPage(face, uni)[uni & (BMPGlyphs::kPageSize - 1)];
+        }
+        return FT_Get_Char_Index(face, uni);
+    };
+
     if (nullptr == glyphs) {
         for (int i = 0; i < glyphCount; ++i) {
-            if (0 == FT_Get_Char_Index(face, next_uni_proc(&chars))) {
+            if (0 == glyph_for(next_uni_proc(&chars))) {
                 return i;
             }
         }
@@ -1600,7 +1704,7 @@ int SkTypeface_FreeType::onCharsToGlyphs(const void* chars, Encoding encoding,
     } else {
         int first = glyphCount;
         for (int i = 0; i < glyphCount; ++i) {
-            unsigned id = FT_Get_Char_Index(face, next_uni_proc(&chars));
+            unsigned id = glyph_for(next_uni_proc(&chars));
             glyphs[i] = SkToU16(id);
             if (0 == id && i < first) {
                 first = i;
@@ -17,6 +17,8 @@
 
 #include "SkFontMgr.h"
 
+#include <atomic>
+
 // These are forward declared to avoid pimpl but also hide the FreeType implementation.
 typedef struct FT_LibraryRec_* FT_Library;
 typedef struct FT_FaceRec_* FT_Face;
@@ -91,6 +93,7 @@ protected:
     SkTypeface_FreeType(const SkFontStyle& style, bool isFixedPitch)
         : INHERITED(style, isFixedPitch)
     {}
+    ~SkTypeface_FreeType() override;
 
     std::unique_ptr<SkFontData> cloneFontData(const SkFontArguments&) const;
     virtual SkScalerContext* onCreateScalerContext(const SkScalerContextEffects&,
@@ -117,6 +120,13 @@ protected:
                           size_t length, void* data) const override;
 
 private:
+    struct BMPGlyphs;
+    const uint16_t* findBMPGlyphPage(SkUnichar uni) const;
+    const uint16_t* makeBMPGlyphPage(FT_Face face, SkUnichar uni) const;
+
+    // The glyphs of the BMP's code points, looked up from the cmap as they are first needed.
+    mutable std::atomic<BMPGlyphs*> fBMPGlyphs{nullptr};
+
     typedef SkTypeface INHERITED;
 };
 
@@ -766,8 +766,10 @@ static sk_sp<SkTypeface> create_from_CTFontRef(SkUniqueCFRef<CTFontRef> font,
                                                bool isLocalStream) {
     SkASSERT(font);
 
+    // CFEqual fonts have the same CFHash.
+    uint32_t hash = SkToU32(CFHash(font.get()));
     if (!isLocalStream) {
-        sk_sp<SkTypeface> face = SkTypefaceCache::FindByProcAndRef(find_by_CTFontRef,
+        sk_sp<SkTypeface> face = SkTypefaceCache::FindByProcAndRef(hash, find_by_CTFontRef,
                                                                    (void*)font.get());
         if (face) {
             return face;
@@ -782,7 +784,7 @@ static sk_sp<SkTypeface> create_from_CTFontRef(SkUniqueCFRef<CTFontRef> font,
     sk_sp<SkTypeface> face(new SkTypeface_Mac(std::move(font), std::move(resource),
                                               style, isFixedPitch, isLocalStream));
     if (!isLocalStream) {
-        SkTypefaceCache::Add(face);
+        SkTypefaceCache::Add(face, hash);
     }
     return face;
 }
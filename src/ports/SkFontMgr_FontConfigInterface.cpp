@@ -205,11 +205,12 @@ protected:
         }
 
         // Check if a typeface with this FontIdentity is already in the FontIdentity cache.
-        sk_sp<SkTypeface> face = fTFCache.findByProcAndRef(find_by_FontIdentity, &identity);
+        uint32_t hash = SkTypefaceCache::HashFamilyAndStyle(outFamilyName.c_str(), outStyle);
+        sk_sp<SkTypeface> face = fTFCache.findByProcAndRef(hash, find_by_FontIdentity, &identity);
         if (!face) {
             face.reset(SkTypeface_FCI::Create(fFCI, identity, std::move(outFamilyName), outStyle));
             // Add this FontIdentity to the FontIdentity cache.
-            fTFCache.add(face);
+            fTFCache.add(face, hash);
         }
         return face.release();
     }
@@ -314,11 +315,12 @@ protected:
         }
 
         // Check if a typeface with this FontIdentity is already in the FontIdentity cache.
-        face = fTFCache.findByProcAndRef(find_by_FontIdentity, &identity);
+        uint32_t hash = SkTypefaceCache::HashFamilyAndStyle(outFamilyName.c_str(), outStyle);
+        face = fTFCache.findByProcAndRef(hash, find_by_FontIdentity, &identity);
         if (!face) {
             face.reset(SkTypeface_FCI::Create(fFCI, identity, std::move(outFamilyName), outStyle));
             // Add this FontIdentity to the FontIdentity cache.
-            fTFCache.add(face);
+            fTFCache.add(face, hash);
         }
         // Add this request to the request cache.
         fCache.add(face, request.release());
@@ -686,14 +686,15 @@ class SkFontMgr_fontconfig : public SkFontMgr {
     sk_sp<SkTypeface> createTypefaceFromFcPattern(FcPattern* pattern) const {
         FCLocker::AssertHeld();
         SkAutoMutexAcquire ama(fTFCacheMutex);
-        sk_sp<SkTypeface> face = fTFCache.findByProcAndRef(FindByFcPattern, pattern);
+        uint32_t hash = FcPatternHash(pattern);
+        sk_sp<SkTypeface> face = fTFCache.findByProcAndRef(hash, FindByFcPattern, pattern);
         if (!face) {
             FcPatternReference(pattern);
             face = SkTypeface_fontconfig::Make(SkAutoFcPattern(pattern));
             if (face) {
                 // Cannot hold the lock when calling add; an evicted typeface may need to lock.
                 FCLocker::Suspend suspend;
-                fTFCache.add(face);
+                fTFCache.add(face, hash);
             }
         }
         return face;
@@ -4,6 +4,7 @@
 #include "SkUTF.h"
 
 #include <climits>
+#include <cstring>
 
 static constexpr inline int32_t left_shift(int32_t value, int32_t shift) {
     return (int32_t) ((uint32_t) value << shift);
@@ -42,6 +43,15 @@ static bool utf8_type_is_valid_leading_byte(int type) { return type > 0; }
 
 static bool utf8_byte_is_continuation(uint8_t c) { return utf8_byte_type(c) == 0; }
 
+// Runs of ASCII are checked eight bytes at a time: they are ASCII if no byte has its high bit set.
+static constexpr size_t kASCIIBlockSize = 8;
+
+static inline bool utf8_block_is_ascii(const char* utf8) {
+    uint64_t block;
+    memcpy(&block, utf8, sizeof(block));
+    return 0 == (block & 0x8080808080808080ULL);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 int SkUTF::CountUTF8(const char* utf8, size_t byteLength) {
@@ -51,6 +61,11 @@ int SkUTF::CountUTF8(const char* utf8, size_t byteLength) {
     int count = 0;
     const char* stop = utf8 + byteLength;
     while (utf8 < stop) {
+        if ((size_t)(stop - utf8) >= kASCIIBlockSize && utf8_block_is_ascii(utf8)) {
+            utf8 += kASCIIBlockSize;
+            count += kASCIIBlockSize;
+            continue;
+        }
         int type = utf8_byte_type(*(const uint8_t*)utf8);
         if (!utf8_type_is_valid_leading_byte(type) || utf8 + type > stop) {
             return -1;  // Sequence extends beyond end.
@@ -151,6 +166,35 @@ SkUnichar SkUTF::NextUTF8(const char** ptr, const char* end) {
     return c;
 }
 
+int SkUTF::UTF8ToUTF32(const char* utf8, size_t byteLength, SkUnichar dst[], int dstCount) {
+    if (!utf8 || !dst) {
+        return -1;
+    }
+    int count = 0;
+    const char* stop = utf8 + byteLength;
+    while (utf8 < stop) {
+        if ((size_t)(stop - utf8) >= kASCIIBlockSize && utf8_block_is_ascii(utf8)) {
+            if (count > dstCount - (int)kASCIIBlockSize) {
+                return -1;
+            }
+            for (size_t i = 0; i < kASCIIBlockSize; ++i) {
+                dst[count++] = (uint8_t)utf8[i];
+            }
+            utf8 += kASCIIBlockSize;
+            continue;
+        }
+        if (count == dstCount) {
+            return -1;
+        }
+        SkUnichar c = NextUTF8(&utf8, stop);
+        if (c < 0) {
+            return -1;
+        }
+        dst[count++] = c;
+    }
+    return count;
+}
+
 SkUnichar SkUTF::NextUTF16(const uint16_t** ptr, const uint16_t* end) {
     if (!ptr || !end ) {
         return -1;
@@ -33,6 +33,12 @@ int CountUTF32(const int32_t* utf32, size_t byteLength);
 */
 SkUnichar NextUTF8(const char** ptr, const char* end);
 
+/** Given a sequence of UTF-8 bytes, place its unicode codepoints in dst, and
+    return the number of them.  If the sequence is invalid UTF-8, or has more
+    than dstCount codepoints, return -1.
+*/
+int UTF8ToUTF32(const char* utf8, size_t byteLength, SkUnichar dst[], int dstCount);
+
 /** Given a sequence of aligned UTF-16 characters in machine-endian form,
     return the first unicode codepoint.  The pointer will be incremented to
     point at the next codepoint's start.  If invalid UTF-16 is encountered,
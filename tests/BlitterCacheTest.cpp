@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBlitterCache.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkPaint.h"
+#include "Test.h"
+
+#include <functional>
+
+static constexpr int kSize = 64;
+
+// Runs draw(canvas, i) for i in [0, count), once on a single canvas (so its device can reuse
+// blitters) and once with a new canvas for each draw (so nothing is reused), and checks that
+// both produce the same pixels.
+static void check_same_pixels(skiatest::Reporter* r, const char* name, int count,
+                              const std::function<void(SkCanvas*, int)>& draw) {
+    SkBitmap reused, fresh;
+    reused.allocN32Pixels(kSize, kSize);
+    fresh .allocN32Pixels(kSize, kSize);
+    reused.eraseColor(SK_ColorWHITE);
+    fresh .eraseColor(SK_ColorWHITE);
+
+    SkCanvas canvas(reused);
+    for (int i = 0; i < count; ++i) {
+        draw(&canvas, i);
+        SkCanvas freshCanvas(fresh);
+        draw(&freshCanvas, i);
+    }
+
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            if (*reused.getAddr32(x, y) != *fresh.getAddr32(x, y)) {
+                ERRORF(r, "%s: pixel (%d, %d) is %08x, expected %08x", name, x, y,
+                       *reused.getAddr32(x, y), *fresh.getAddr32(x, y));
+                return;
+            }
+        }
+    }
+}
+
+DEF_TEST(BlitterCache_ReusesForSamePaint, r) {
+    SkBlitterCache::Stats before = SkBlitterCache::GetStats();
+
+    SkPaint paint;
+    paint.setColor(0x80FF4020);
+    check_same_pixels(r, "same paint", 20, [&](SkCanvas* canvas, int i) {
+        canvas->drawRect(SkRect::MakeXYWH(i * 3, (i * 7) % kSize, 8, 8), paint);
+    });
+
+    // Other tests may be drawing at the same time, so the stats can only give us a lower bound:
+    // the shared canvas should have reused its first blitter for its other 19 draws.
+    SkBlitterCache::Stats after = SkBlitterCache::GetStats();
+    REPORTER_ASSERT(r, after.fReused - before.fReused >= 19,
+                    "reused %d blitters", after.fReused - before.fReused);
+}
+
+DEF_TEST(BlitterCache_PaintChanges, r) {
+    const SkColor colors[] = { SK_ColorRED, 0x8000FF00, SK_ColorBLUE };
+    const SkPoint pts[] = { {0, 0}, {kSize, kSize} };
+    sk_sp<SkShader> shader = SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                          SkShader::kClamp_TileMode);
+
+    // Every draw changes something the blitter depends on.
+    check_same_pixels(r, "paint changes", 12, [&](SkCanvas* canvas, int i) {
+        SkPaint paint;
+        paint.setColor(colors[i % 3]);
+        paint.setAntiAlias(i & 1);
+        if (i % 4 == 2) {
+            paint.setBlendMode(SkBlendMode::kMultiply);
+        }
+        if (i % 6 >= 3) {
+            paint.setShader(shader);
+        }
+        canvas->drawCircle(kSize / 2, kSize / 2, kSize / 2 - i, paint);
+    });
+
+    // With a shader, the matrix matters too.
+    SkPaint paint;
+    paint.setShader(shader);
+    check_same_pixels(r, "matrix changes", 8, [&](SkCanvas* canvas, int i) {
+        canvas->save();
+        canvas->translate(i * 4, 0);
+        canvas->rotate(i * 10);
+        canvas->drawRect(SkRect::MakeXYWH(0, i * 6, kSize, 6), paint);
+        canvas->restore();
+    });
+}
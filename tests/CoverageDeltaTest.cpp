@@ -0,0 +1,71 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCoverageDelta.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// SkOpts::coverage_deltas_to_alpha() must match accumulating the deltas one at a time and
+// converting each coverage with the scalar CoverageToAlpha() or ConvexCoverageToAlpha().
+static void check_row(skiatest::Reporter* r, const SkFixed deltas[], int count,
+                      bool isEvenOdd, bool isInverse, bool isConvex) {
+    SkAlpha alphas[64];
+    SkASSERT(count <= (int)SK_ARRAY_COUNT(alphas));
+    SkOpts::coverage_deltas_to_alpha(deltas, alphas, count, isEvenOdd, isInverse, isConvex);
+
+    SkFixed coverage = 0;
+    for (int i = 0; i < count; i++) {
+        coverage += deltas[i];
+        SkAlpha expected = isConvex ? ConvexCoverageToAlpha(coverage, isInverse)
+                                    : CoverageToAlpha(coverage, isEvenOdd, isInverse);
+        if (alphas[i] != expected) {
+            ERRORF(r, "evenOdd %d inverse %d convex %d: alpha %d at %d of %d, expected %d",
+                   isEvenOdd, isInverse, isConvex, alphas[i], i, count, expected);
+            return;
+        }
+    }
+}
+
+static SkFixed random_coverage(SkRandom* rand, int maxWinding) {
+    return (SkFixed)rand->nextRangeU(0, 2 * maxWinding * SK_Fixed1) - maxWinding * SK_Fixed1;
+}
+
+DEF_TEST(CoverageDelta_ToAlpha, r) {
+    SkRandom rand;
+    SkFixed deltas[64];
+    for (int iteration = 0; iteration < 1000; iteration++) {
+        // Rows are a multiple of 8 wide, like SkCoverageDeltaMask's.
+        const int count = 8 * rand.nextRangeU(1, SK_ARRAY_COUNT(deltas) / 8);
+
+        // Convex paths keep their coverages within [-1, 1].  Others may wind several times,
+        // which even-odd wraps and non-zero clamps.
+        SkFixed coverage = 0;
+        for (int i = 0; i < count; i++) {
+            SkFixed next = random_coverage(&rand, 1);
+            deltas[i] = next - coverage;
+            coverage = next;
+        }
+        for (bool isInverse : {false, true}) {
+            check_row(r, deltas, count, false, isInverse, true);
+        }
+
+        coverage = 0;
+        for (int i = 0; i < count; i++) {
+            // Whole windings too, where even-odd and non-zero differ most.
+            SkFixed next = rand.nextBool() ? random_coverage(&rand, 4)
+                                           : ((int)rand.nextRangeU(0, 4) - 2) * SK_Fixed1;
+            deltas[i] = next - coverage;
+            coverage = next;
+        }
+        for (bool isEvenOdd : {false, true}) {
+            for (bool isInverse : {false, true}) {
+                check_row(r, deltas, count, isEvenOdd, isInverse, false);
+            }
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkColorSpace.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static constexpr int kW = 128,
+                     kH = 96,
+                     kCount = 500;
+
+struct RectBatch {
+    SkRect  fRects[kCount];
+    SkColor fColors[kCount];
+
+    RectBatch() {
+        SkRandom rand;
+        for (int i = 0; i < kCount; ++i) {
+            SkScalar x = rand.nextRangeScalar(-10, kW),
+                     y = rand.nextRangeScalar(-10, kH),
+                     w = rand.nextRangeScalar(-8, 24),     // some rects aren't sorted
+                     h = rand.nextRangeScalar(-8, 24);
+            if (i % 3 == 0) {
+                // Many rects are pixel aligned.
+                x = SkScalarRoundToScalar(x);
+                y = SkScalarRoundToScalar(y);
+                w = SkScalarRoundToScalar(w);
+                h = SkScalarRoundToScalar(h);
+            }
+            fRects[i] = SkRect::MakeXYWH(x, y, w, h);
+            // Runs of the same color, mostly opaque, some translucent or transparent.
+            fColors[i] = (i % 4) ? fColors[i - 1] : rand.nextU();
+            if (i % 8 < 5) {
+                fColors[i] |= 0xFF000000;
+            }
+        }
+    }
+};
+
+typedef void (*SetupProc)(SkCanvas*, SkPaint*);
+
+static void check_batch_matches_rects(skiatest::Reporter* r, const char* name, SetupProc setup,
+                                      sk_sp<SkColorSpace> cs = nullptr) {
+    static const RectBatch batch;
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH, std::move(cs));
+
+    for (bool perRectColors : { true, false }) {
+        auto expected = SkSurface::MakeRaster(info),
+             actual   = SkSurface::MakeRaster(info);
+        for (auto& surface : { expected, actual }) {
+            surface->getCanvas()->clear(0xFF336699);
+        }
+
+        SkPaint paint;
+        paint.setColor(0x80FF8040);
+        setup(expected->getCanvas(), &paint);
+        setup(actual  ->getCanvas(), &paint);
+
+        SkPaint rectPaint(paint);
+        for (int i = 0; i < kCount; ++i) {
+            if (perRectColors) {
+                rectPaint.setColor(batch.fColors[i]);
+            }
+            expected->getCanvas()->drawRect(batch.fRects[i], rectPaint);
+        }
+        actual->getCanvas()->experimental_DrawRectsV1(batch.fRects,
+                                                      perRectColors ? batch.fColors : nullptr,
+                                                      kCount, paint);
+
+        SkBitmap e, a;
+        e.allocPixels(info);
+        a.allocPixels(info);
+        expected->readPixels(e, 0, 0);
+        actual  ->readPixels(a, 0, 0);
+        REPORTER_ASSERT(r, 0 == memcmp(e.getPixels(), a.getPixels(), e.computeByteSize()),
+                        "%s, %s colors", name, perRectColors ? "per-rect" : "paint");
+    }
+}
+
+DEF_TEST(DrawRects_MatchesDrawRect, r) {
+    check_batch_matches_rects(r, "bw", [](SkCanvas*, SkPaint*) {});
+    check_batch_matches_rects(r, "aa", [](SkCanvas*, SkPaint* p) { p->setAntiAlias(true); });
+    check_batch_matches_rects(r, "scaled", [](SkCanvas* c, SkPaint* p) {
+        p->setAntiAlias(true);
+        c->translate(3.5f, -2);
+        c->scale(1.5f, 0.75f);
+    });
+    check_batch_matches_rects(r, "rect clip", [](SkCanvas* c, SkPaint* p) {
+        p->setAntiAlias(true);
+        c->clipRect(SkRect::MakeLTRB(10, 12, 100, 80));
+    });
+    check_batch_matches_rects(r, "region clip", [](SkCanvas* c, SkPaint*) {
+        c->clipPath(SkPath().addCircle(64, 48, 40));
+    });
+    check_batch_matches_rects(r, "aa clip", [](SkCanvas* c, SkPaint*) {
+        c->clipPath(SkPath().addCircle(64, 48, 40), true);
+    });
+    check_batch_matches_rects(r, "src mode", [](SkCanvas*, SkPaint* p) {
+        p->setBlendMode(SkBlendMode::kSrc);
+    });
+    check_batch_matches_rects(r, "stroked", [](SkCanvas*, SkPaint* p) {
+        p->setStyle(SkPaint::kStroke_Style);
+        p->setStrokeWidth(3);
+    });
+    check_batch_matches_rects(r, "rotated", [](SkCanvas* c, SkPaint* p) {
+        p->setAntiAlias(true);
+        c->rotate(10);
+    });
+    check_batch_matches_rects(r, "srgb", [](SkCanvas*, SkPaint* p) { p->setAntiAlias(true); },
+                              SkColorSpace::MakeSRGB());
+    check_batch_matches_rects(r, "p3", [](SkCanvas*, SkPaint*) {},
+                              SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDCIP3));
+}
+
+DEF_TEST(DrawRects_Recorded, r) {
+    // Recording canvases see the batch as individual rects.
+    const SkRect  rects[]  = { {0, 0, 10, 10}, {20, 20, 5, 5}, {1, 2, 3, 4} };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(kW, kH));
+    canvas->experimental_DrawRectsV1(rects, colors, SK_ARRAY_COUNT(rects), SkPaint());
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, picture->approximateOpCount() == (int)SK_ARRAY_COUNT(rects));
+
+    SkBitmap bm;
+    bm.allocN32Pixels(kW, kH);
+    SkCanvas(bm).drawPicture(picture);
+    REPORTER_ASSERT(r, *bm.getAddr32( 4,  1) == SkPreMultiplyColor(SK_ColorRED));
+    REPORTER_ASSERT(r, *bm.getAddr32(10, 10) == SkPreMultiplyColor(SK_ColorGREEN));
+    REPORTER_ASSERT(r, *bm.getAddr32( 2,  3) == SkPreMultiplyColor(SK_ColorBLUE));
+}
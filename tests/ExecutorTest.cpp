@@ -0,0 +1,45 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+#include <atomic>
+
+DEF_TEST(Executor_WorkStealing, r) {
+    auto executor = SkExecutor::MakeWorkStealingThreadPool(4);
+
+    // Work added from outside the pool.
+    std::atomic<int> count{0};
+    SkTaskGroup group(*executor);
+    group.batch(10000, [&](int) { count.fetch_add(1, std::memory_order_relaxed); });
+    group.wait();
+    REPORTER_ASSERT(r, count.load() == 10000);
+
+    // Work added from inside the pool, waited on by tasks that are themselves in the pool.
+    count = 0;
+    group.batch(64, [&](int) {
+        SkTaskGroup inner(*executor);
+        inner.batch(100, [&](int) { count.fetch_add(1, std::memory_order_relaxed); });
+        inner.wait();
+    });
+    group.wait();
+    REPORTER_ASSERT(r, count.load() == 6400);
+}
+
+DEF_TEST(Executor_WorkStealing_Destroy, r) {
+    // Destroying the pool finishes any work still queued.
+    std::atomic<int> count{0};
+    {
+        auto executor = SkExecutor::MakeWorkStealingThreadPool(2);
+        for (int i = 0; i < 100; i++) {
+            executor->add([&] { count.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    REPORTER_ASSERT(r, count.load() == 100);
+}
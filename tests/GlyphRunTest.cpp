@@ -7,6 +7,13 @@
 
 #include "SkGlyphRun.h"
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkGlyphAtlas.h"
+#include "SkGlyphRunPainter.h"
+#include "SkGraphics.h"
+#include "SkStrikeCache.h"
 #include "SkTextBlob.h"
 #include "Test.h"
 
@@ -41,6 +48,111 @@ DEF_TEST(GlyphRunGlyphIDSetBasic, reporter) {
     }
 }
 
+DEF_TEST(GlyphRunPrerasterize, reporter) {
+    constexpr int kSize = 256;
+    SkFont font(SkTypeface::MakeDefault(), 13);
+    font.setSubpixel(true);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    int glyphCount = SkTMin(400, font.getTypefaceOrDefault()->countGlyphs());
+
+    // Lots of distinct glyphs at fractional positions, in two sizes.
+    SkTextBlobBuilder blobBuilder;
+    for (int size : {13, 21}) {
+        font.setSize(size);
+        const auto& runBuffer = blobBuilder.allocRunPos(font, glyphCount);
+        for (int i = 0; i < glyphCount; i++) {
+            runBuffer.glyphs[i] = i;
+            runBuffer.points()[i] = {(i % 20) * 12.3f, (i / 20) * 12.7f + size};
+        }
+    }
+    sk_sp<SkTextBlob> blob = blobBuilder.make();
+
+    auto draw = [&](bool prerasterize) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        bitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        SkGraphics::PurgeFontCache();
+        if (prerasterize) {
+            // The painter SkCanvas(bitmap)'s device uses.
+            SkGlyphRunListPainter painter(SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType),
+                                          kN32_SkColorType, nullptr,
+                                          SkStrikeCache::GlobalStrikeCache());
+            std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+            const SkTextBlob* blobs[] = { blob.get() };
+            const SkPoint origins[] = { {1.5f, 0} };
+            painter.prerasterizeForBitmapDevice(SkSpan<const SkTextBlob* const>{blobs, 1},
+                                                origins, paint, SkMatrix::I(), executor.get());
+        }
+        canvas.drawTextBlob(blob, 1.5f, 0, paint);
+        return bitmap;
+    };
+
+    SkBitmap expected = draw(false),
+             actual   = draw(true);
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            if (*actual.getAddr32(x, y) != *expected.getAddr32(x, y)) {
+                ERRORF(reporter, "pixel (%d, %d) is %08x, expected %08x", x, y,
+                       *actual.getAddr32(x, y), *expected.getAddr32(x, y));
+                return;
+            }
+        }
+    }
+}
+
+DEF_TEST(GlyphRunRasterAtlas, reporter) {
+    constexpr int kSize = 256;
+    sk_sp<SkTypeface> typeface = SkTypeface::MakeDefault();
+    int glyphCount = SkTMin(600, typeface->countGlyphs());
+
+    // Enough small glyphs to fill several atlas pages, and some too big for the atlas.
+    auto draw = [&](SkFont::Edging edging, bool useAtlas) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        bitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setColor(0xFF204080);
+
+        bool wasUsingAtlas = gSkUseRasterGlyphAtlas;
+        gSkUseRasterGlyphAtlas = useAtlas;
+        for (SkScalar size : {9, 14, 40}) {
+            SkFont font(typeface, size);
+            font.setEdging(edging);
+            font.setSubpixel(true);
+            SkTextBlobBuilder builder;
+            const auto& run = builder.allocRunPos(font, glyphCount);
+            for (int i = 0; i < glyphCount; i++) {
+                run.glyphs[i] = i;
+                run.points()[i] = {(i % 30) * 8.6f, (i / 30) * 12.2f + size};
+            }
+            // Draw twice, so the second draw blits glyphs already in the atlas.
+            sk_sp<SkTextBlob> blob = builder.make();
+            canvas.drawTextBlob(blob, 0, 0, paint);
+            canvas.drawTextBlob(blob, 0, 0, paint);
+            SkGraphics::PurgeFontCache();
+        }
+        gSkUseRasterGlyphAtlas = wasUsingAtlas;
+        return bitmap;
+    };
+
+    for (SkFont::Edging edging : {SkFont::Edging::kAntiAlias, SkFont::Edging::kSubpixelAntiAlias}) {
+        SkBitmap expected = draw(edging, false),
+                 actual   = draw(edging, true);
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                if (*actual.getAddr32(x, y) != *expected.getAddr32(x, y)) {
+                    ERRORF(reporter, "edging %d: pixel (%d, %d) is %08x, expected %08x",
+                           (int)edging, x, y, *actual.getAddr32(x, y), *expected.getAddr32(x, y));
+                    return;
+                }
+            }
+        }
+    }
+}
+
 #if 0   // should we revitalize this by consing up a device for drawTextBlob() ?
 DEF_TEST(GlyphRunBlob, reporter) {
     constexpr uint16_t count = 5;
@@ -15,6 +15,7 @@
 #include "SkColor.h"
 #include "SkData.h"
 #include "SkFontStyle.h"
+#include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkMatrix.h"
 #include "SkMiniRecorder.h"
@@ -28,8 +29,10 @@
 #include "SkRectPriv.h"
 #include "SkRefCnt.h"
 #include "SkScalar.h"
+#include "SkSerialProcs.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkTemplates.h"
 #include "SkTypeface.h"
 #include "SkTypes.h"
 #include "Test.h"
@@ -879,3 +882,170 @@ DEF_TEST(Picture_empty_serial, reporter) {
     REPORTER_ASSERT(reporter, pic2);
 }
 
+
+static SkBitmap draw_picture(const SkPicture* pic) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.drawPicture(pic);
+    return bitmap;
+}
+
+DEF_TEST(Picture_MappedData, reporter) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorBLUE);
+    bitmap.erase(SK_ColorRED, SkIRect::MakeWH(8, 8));
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorGREEN);
+    SkPath path;
+    path.addCircle(50, 50, 30);
+    canvas->drawPath(path, paint);
+    canvas->save();
+    canvas->translate(10, 10);
+    canvas->drawImage(image, 0, 0);
+    canvas->restore();
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawRect(SkRect::MakeXYWH(60, 60, 20, 20), paint);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    // Store the image as its pixels, so we can see where they're read from.
+    SkSerialProcs serialProcs;
+    serialProcs.fImageProc = [](SkImage* image, void*) -> sk_sp<SkData> {
+        SkPixmap pixmap;
+        return image->peekPixels(&pixmap)
+                ? SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize()) : nullptr;
+    };
+    sk_sp<SkData> data = picture->serialize(&serialProcs);
+
+    struct ImageContext {
+        const SkData* fData;
+        bool          fInPlace;
+    } context = {data.get(), false};
+    SkDeserialProcs procs;
+    procs.fImageCtx = &context;
+    procs.fImageProc = [](const void* pixels, size_t size, void* ctx) -> sk_sp<SkImage> {
+        ImageContext* context = (ImageContext*)ctx;
+        const char* begin = (const char*)context->fData->data();
+        context->fInPlace = pixels >= begin && pixels < begin + context->fData->size();
+        return SkImage::MakeRasterCopy(SkPixmap(SkImageInfo::MakeN32Premul(16, 16), pixels, 64));
+    };
+
+    sk_sp<SkPicture> copied = SkPicture::MakeFromData(data.get(), &procs);
+    REPORTER_ASSERT(reporter, copied && data->unique() && !context.fInPlace);
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromMappedData(data, &procs);
+    // The mapped picture plays back from data, so it keeps it alive.
+    REPORTER_ASSERT(reporter, mapped && !data->unique() && context.fInPlace);
+    if (!copied || !mapped) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, mapped->cullRect() == picture->cullRect());
+    REPORTER_ASSERT(reporter, mapped->approximateOpCount() >= picture->approximateOpCount(),
+                    "%d ops", mapped->approximateOpCount());
+
+    SkBitmap expected = draw_picture(copied.get()),
+             actual   = draw_picture(mapped.get());
+    REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                      expected.computeByteSize()));
+
+    // Mapped pictures serialize like any other.
+    sk_sp<SkData> reserialized = mapped->serialize(&serialProcs);
+    sk_sp<SkPicture> roundTripped = SkPicture::MakeFromData(reserialized.get(), &procs);
+    REPORTER_ASSERT(reporter, roundTripped);
+    if (roundTripped) {
+        actual = draw_picture(roundTripped.get());
+        REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.computeByteSize()));
+    }
+
+    // Data that isn't aligned, or is cut short, is read as MakeFromData() would.
+    mapped = nullptr;
+    SkAutoTMalloc<char> storage(data->size() + 1);
+    memcpy(storage.get() + 1, data->data(), data->size());
+    sk_sp<SkData> misaligned = SkData::MakeWithoutCopy(storage.get() + 1, data->size());
+    context.fData = misaligned.get();
+    mapped = SkPicture::MakeFromMappedData(misaligned, &procs);
+    REPORTER_ASSERT(reporter, mapped && misaligned->unique() && !context.fInPlace);
+    if (mapped) {
+        actual = draw_picture(mapped.get());
+        REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.computeByteSize()));
+    }
+    for (size_t size = 0; size < data->size(); size += 37) {
+        REPORTER_ASSERT(reporter,
+                        !SkPicture::MakeFromMappedData(SkData::MakeSubset(data.get(), 0, size)));
+    }
+}
+
+static SkBitmap draw_picture_tile(const SkPicture* pic, const SkIRect& tile) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(tile.width(), tile.height());
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.translate(-tile.x(), -tile.y());
+    canvas.clipRect(SkRect::Make(tile));
+    canvas.drawPicture(pic);
+    return bitmap;
+}
+
+DEF_TEST(Picture_MakeFromStreamCulled, reporter) {
+    for (bool useBBH : {true, false}) {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1000, 1000, useBBH ? &factory : nullptr);
+        SkRandom rand;
+        SkPaint paint;
+        for (int y = 0; y < 1000; y += 50) {
+            for (int x = 0; x < 1000; x += 50) {
+                paint.setColor(rand.nextU() | 0xFF000000);
+                canvas->save();
+                canvas->translate(x, y);
+                canvas->clipRect(SkRect::MakeWH(40, 40));
+                canvas->drawRect(SkRect::MakeWH(60, 60), paint);
+                canvas->restore();
+                canvas->drawCircle(x, y, 8, paint);
+            }
+        }
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+        sk_sp<SkData> data = picture->serialize();
+
+        for (SkIRect tile : {SkIRect::MakeXYWH(0, 0, 100, 100), SkIRect::MakeXYWH(333, 517, 90, 70),
+                             SkIRect::MakeXYWH(900, 900, 200, 200)}) {
+            SkMemoryStream stream(data);
+            sk_sp<SkPicture> culled = SkPicture::MakeFromStream(&stream, SkRect::Make(tile));
+            REPORTER_ASSERT(reporter, culled);
+            if (!culled) {
+                continue;
+            }
+            SkRect expectedCull = SkRect::Make(tile);
+            SkAssertResult(expectedCull.intersect(picture->cullRect()));
+            REPORTER_ASSERT(reporter, culled->cullRect() == expectedCull);
+            // With a BBH, only the ops near the tile are read.
+            REPORTER_ASSERT(reporter,
+                            useBBH == (culled->approximateOpCount() * 10 <
+                                       picture->approximateOpCount()),
+                            "%d of %d ops", culled->approximateOpCount(),
+                            picture->approximateOpCount());
+
+            SkBitmap expected = draw_picture_tile(picture.get(), tile),
+                     actual   = draw_picture_tile(culled.get(), tile);
+            REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                              expected.computeByteSize()));
+
+            // Pictures read in place use their BBH for playback, too.
+            sk_sp<SkPicture> mapped = SkPicture::MakeFromMappedData(data);
+            REPORTER_ASSERT(reporter, mapped);
+            if (mapped) {
+                actual = draw_picture_tile(mapped.get(), tile);
+                REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                                  expected.computeByteSize()));
+            }
+        }
+    }
+}
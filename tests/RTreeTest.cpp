@@ -5,8 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkAutoMalloc.h"
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
+#include "SkReadBuffer.h"
+#include "SkWriteBuffer.h"
 #include "Test.h"
 
 static const int NUM_RECTS = 200;
@@ -44,7 +48,7 @@ static bool verify_query(SkRect query, SkRect rects[], SkTDArray<int>& found) {
 }
 
 static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
-                        const SkRTree& tree) {
+                        const SkBBoxHierarchy& tree) {
     for (size_t i = 0; i < NUM_QUERIES; ++i) {
         SkTDArray<int> hits;
         SkRect query = random_rect(rand);
@@ -89,3 +93,103 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+// Writes a root at level 1 (node 1) with rootChildren branches, all to a leaf (node 0) holding ops
+// 0 and 1, like SkRTree::flatten() would, and reads it back with two ops.
+static bool read_two_level_tree(int count, int root, int rootChildren) {
+    const SkRect bounds = SkRect::MakeWH(10, 10);
+    SkBinaryWriteBuffer writer;
+    writer.writeInt(count);
+    writer.writeScalar(1);
+    writer.writeInt(2);
+    writer.writeRect(bounds);
+    writer.writeInt(root);
+    writer.writeUInt(0);
+    writer.writeUInt(2);
+    for (int op : {0, 1}) {
+        writer.writeRect(bounds);
+        writer.writeInt(op);
+    }
+    writer.writeUInt(1);
+    writer.writeUInt(rootChildren);
+    for (int i = 0; i < rootChildren; i++) {
+        writer.writeRect(bounds);
+        writer.writeInt(0);
+    }
+    SkAutoMalloc storage(writer.bytesWritten());
+    writer.writeToMemory(storage.get());
+
+    SkReadBuffer reader(storage.get(), writer.bytesWritten());
+    return SkRTree::MakeFromBuffer(reader, 2) != nullptr;
+}
+
+DEF_TEST(RTree_Flatten, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (int count : {0, 1, NUM_RECTS}) {
+        for (int j = 0; j < count; j++) {
+            rects[j] = random_rect(rand);
+        }
+        SkRTree rtree;
+        rtree.insert(rects.get(), count);
+
+        SkBinaryWriteBuffer writer;
+        rtree.flatten(writer);
+        SkAutoMalloc storage(writer.bytesWritten());
+        writer.writeToMemory(storage.get());
+
+        SkReadBuffer reader(storage.get(), writer.bytesWritten());
+        std::unique_ptr<SkRTree> read = SkRTree::MakeFromBuffer(reader, count);
+        REPORTER_ASSERT(reporter, read && reader.isValid() && reader.eof());
+        if (!read) {
+            continue;
+        }
+        REPORTER_ASSERT(reporter, read->getCount() == rtree.getCount());
+        REPORTER_ASSERT(reporter, read->getDepth() == rtree.getDepth());
+        REPORTER_ASSERT(reporter, read->getRootBound() == rtree.getRootBound());
+        if (count == NUM_RECTS) {
+            run_queries(reporter, rand, rects, *read);
+        }
+
+        // Op indices must be in range, and the tree can't be cut short.
+        if (count > 0) {
+            SkReadBuffer fewerOps(storage.get(), writer.bytesWritten());
+            REPORTER_ASSERT(reporter, !SkRTree::MakeFromBuffer(fewerOps, count - 1));
+            SkReadBuffer truncated(storage.get(), writer.bytesWritten() - 4);
+            REPORTER_ASSERT(reporter, !SkRTree::MakeFromBuffer(truncated, count));
+        }
+    }
+
+    // Malformed trees: a subtree shared by two branches (which searches would visit twice per
+    // level), a root below the top level, and a count that doesn't match the leaves.
+    REPORTER_ASSERT(reporter,  read_two_level_tree(2, 1, 1));
+    REPORTER_ASSERT(reporter, !read_two_level_tree(2, 1, 2));
+    REPORTER_ASSERT(reporter, !read_two_level_tree(2, 0, 1));
+    REPORTER_ASSERT(reporter, !read_two_level_tree(3, 1, 1));
+    REPORTER_ASSERT(reporter, !read_two_level_tree(1, 1, 1));
+}
+
+DEF_TEST(PackedRTree, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        for (int count : {0, 1, SkPackedRTree::kFanout, NUM_RECTS}) {
+            for (int j = 0; j < NUM_RECTS; j++) {
+                rects[j] = j < count ? random_rect(rand) : SkRect::MakeEmpty();
+            }
+
+            SkPackedRTree tree;
+            tree.insert(rects.get(), NUM_RECTS);
+
+            // Empty bounds are never returned, like SkRTree.
+            run_queries(reporter, rand, rects, tree);
+            REPORTER_ASSERT(reporter, count == tree.getCount());
+
+            SkRect bound = SkRect::MakeEmpty();
+            for (int j = 0; j < count; j++) {
+                bound.join(rects[j]);
+            }
+            REPORTER_ASSERT(reporter, bound == tree.getRootBound());
+        }
+    }
+}
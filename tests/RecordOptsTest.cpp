@@ -8,15 +8,19 @@
 #include "Test.h"
 #include "RecordTestUtils.h"
 
+#include "SkBitmap.h"
 #include "SkBlurImageFilter.h"
 #include "SkColorFilter.h"
+#include "SkImage.h"
 #include "SkRecord.h"
+#include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
 #include "SkRecorder.h"
 #include "SkRecords.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureImageFilter.h"
 #include "SkSurface.h"
+#include "sk_tool_utils.h"
 
 static const int W = 1920, H = 1080;
 
@@ -360,6 +364,202 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     index += 4;
 }
 
+// Plays back record into a small bitmap, to check that optimizing it doesn't change what it draws.
+static SkBitmap draw_record(const SkRecord& record) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bitmap);
+    SkRecordDraw(record, &canvas, nullptr, nullptr, 0, nullptr, nullptr);
+    return bitmap;
+}
+
+DEF_TEST(RecordOpts_MergeMatrices, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+    const SkRect rect = SkRect::MakeWH(10, 10);
+
+    recorder.translate(1, 2);
+    recorder.translate(3, 4);
+    recorder.drawRect(rect, SkPaint());
+
+    // These cancel out.
+    recorder.translate(5, 0);
+    recorder.translate(-5, 0);
+    recorder.drawRect(rect, SkPaint());
+
+    recorder.scale(2, 3);
+    recorder.rotate(30);
+    recorder.drawRect(rect, SkPaint());
+
+    recorder.scale(4, 4);
+    recorder.setMatrix(SkMatrix::I());
+    recorder.drawRect(rect, SkPaint());
+
+    // Draws in between use the first matrix.
+    recorder.scale(2, 2);
+    recorder.drawRect(rect, SkPaint());
+    recorder.scale(2, 2);
+
+    SkBitmap expected = draw_record(record);
+    REPORTER_ASSERT(r, 5 == SkRecordMergeMatrices(&record));
+    REPORTER_ASSERT(r, sk_tool_utils::equal_pixels(expected, draw_record(record)));
+
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    const SkRecords::Translate* translate = assert_type<SkRecords::Translate>(r, record, 1);
+    REPORTER_ASSERT(r, translate && 4 == translate->dx && 6 == translate->dy);
+    assert_type<SkRecords::NoOp>(r, record, 3);
+    assert_type<SkRecords::NoOp>(r, record, 4);
+    assert_type<SkRecords::NoOp>(r, record, 6);
+    const SkRecords::Concat* concat = assert_type<SkRecords::Concat>(r, record, 7);
+    SkMatrix matrix;
+    matrix.setScale(2, 3);
+    matrix.preRotate(30);
+    REPORTER_ASSERT(r, concat && concat->matrix == matrix);
+    assert_type<SkRecords::NoOp>(r, record, 9);
+    assert_type<SkRecords::SetMatrix>(r, record, 10);
+    assert_type<SkRecords::Concat>(r, record, 12);
+    assert_type<SkRecords::Concat>(r, record, 14);
+}
+
+DEF_TEST(RecordOpts_NoopRedundantClips, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.save();
+        recorder.clipRect(SkRect::MakeLTRB(10, 10, 40, 40));
+        recorder.drawRect(SkRect::MakeLTRB(0, 0, 50, 50), SkPaint());
+        // Contains the clip, so can't shrink it.  Neither can the one after it.
+        recorder.clipRect(SkRect::MakeLTRB(5, 5, 45, 45));
+        recorder.clipRect(SkRect::MakeLTRB(0, 0, 50, 50));
+        recorder.drawRect(SkRect::MakeLTRB(0, 0, 50, 50), SkPaint());
+        // Shrinks the clip.
+        recorder.clipRect(SkRect::MakeLTRB(20, 20, 60, 60));
+        // Antialiased clips do too, at their edges.
+        recorder.clipRect(SkRect::MakeLTRB(0, 0, 60, 60), true);
+    recorder.restore();
+
+    recorder.save();
+        recorder.clipRect(SkRect::MakeLTRB(10, 10, 40, 40));
+        // The matrix changes between them.
+        recorder.scale(0.5f, 0.5f);
+        recorder.clipRect(SkRect::MakeLTRB(10, 10, 40, 40));
+        recorder.drawRect(SkRect::MakeLTRB(0, 0, 50, 50), SkPaint());
+    recorder.restore();
+
+    SkBitmap expected = draw_record(record);
+    REPORTER_ASSERT(r, 2 == SkRecordNoopRedundantClips(&record));
+    REPORTER_ASSERT(r, sk_tool_utils::equal_pixels(expected, draw_record(record)));
+
+    assert_type<SkRecords::ClipRect>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 3);
+    assert_type<SkRecords::NoOp>(r, record, 4);
+    assert_type<SkRecords::ClipRect>(r, record, 6);
+    assert_type<SkRecords::ClipRect>(r, record, 7);
+    assert_type<SkRecords::ClipRect>(r, record, 12);
+}
+
+DEF_TEST(RecordOpts_NoopCoveredDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, translucent, antialiased;
+    red.setColor(SK_ColorRED);
+    translucent.setColor(0x8000FF00);
+    antialiased.setAntiAlias(true);
+    antialiased.setColor(SK_ColorBLUE);
+
+    // A hard-edged opaque rect hides hard-edged rects inside it, of any color.
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), translucent);     // 0, hidden
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 30, 30), antialiased);     // 1
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 60, 10), red);               // 2
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 40, 40), red);               // 3
+
+    // Only opaque draws hide anything.
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), red);             // 4
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 40, 40), translucent);       // 5
+
+    // Nor can a draw hide another across a change of matrix...
+    recorder.translate(1, 1);                                             // 6
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 40, 40), red);               // 7, hidden
+
+    // ... though an opaque DrawPaint hides everything since then.
+    recorder.drawPaint(red);                                              // 8, hidden
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), translucent);     // 9, hidden
+    recorder.drawCircle(30, 30, 10, antialiased);                         // 10, hidden
+    recorder.drawPaint(red);                                              // 11
+
+    // Draws under antialiased clips blend in at the clip's edges.
+    recorder.save();                                                      // 12
+        recorder.clipRect(SkRect::MakeLTRB(5.5f, 5.5f, 50, 50), true);    // 13
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), translucent); // 14
+        recorder.drawPaint(red);                                          // 15
+    recorder.restore();                                                   // 16
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), translucent);     // 17, hidden
+    recorder.drawPaint(red);                                              // 18
+
+    SkBitmap expected = draw_record(record);
+    REPORTER_ASSERT(r, 6 == SkRecordNoopCoveredDraws(&record));
+    REPORTER_ASSERT(r, sk_tool_utils::equal_pixels(expected, draw_record(record)));
+
+    for (int i : {0, 7, 8, 9, 10, 17}) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    for (int i : {1, 2, 3, 4, 5, 14}) {
+        assert_type<SkRecords::DrawRect>(r, record, i);
+    }
+}
+
+DEF_TEST(RecordOpts_MergeDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 4; i++) {
+        paint.setColor(0xFF000000 | (i * 0x3F3F3F));
+        recorder.drawRect(SkRect::MakeXYWH(i * 10.5f, i * 8.0f, 20, 12), paint);
+    }
+    // The style is different.
+    paint.setStyle(SkPaint::kStroke_Style);
+    recorder.drawRect(SkRect::MakeXYWH(5, 5, 40, 40), paint);
+    recorder.drawRect(SkRect::MakeXYWH(6, 6, 40, 40), paint);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorMAGENTA);
+    *bitmap.getAddr32(3, 3) = SK_ColorBLACK;
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap),
+                   other = SkImage::MakeFromBitmap(bitmap);
+    SkPaint alpha;
+    alpha.setAlpha(0x80);
+    recorder.drawImageRect(image, SkRect::MakeWH(4, 4), SkRect::MakeXYWH(0, 40, 8, 8), &alpha,
+                           SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(4, 4, 4, 4), SkRect::MakeXYWH(8, 40, 8, 8),
+                           nullptr, SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(40, 40, 20, 20), nullptr);
+    // A different image.
+    recorder.drawImageRect(other, SkRect::MakeXYWH(50, 50, 10, 10), nullptr);
+    // Sets don't keep to a strict src rect inside the image.
+    recorder.drawImageRect(other, SkRect::MakeWH(4, 4), SkRect::MakeXYWH(40, 0, 8, 8), nullptr,
+                           SkCanvas::kStrict_SrcRectConstraint);
+
+    SkBitmap expected = draw_record(record);
+    REPORTER_ASSERT(r, 6 == SkRecordMergeDraws(&record));
+    REPORTER_ASSERT(r, sk_tool_utils::equal_pixels(expected, draw_record(record)));
+
+    const SkRecords::DrawRects* rects = assert_type<SkRecords::DrawRects>(r, record, 0);
+    REPORTER_ASSERT(r, rects && 4 == rects->count && rects->colors);
+    REPORTER_ASSERT(r, rects && rects->colors[3] == (0xFF000000 | (3 * 0x3F3F3F)));
+    const SkRecords::DrawRects* strokes = assert_type<SkRecords::DrawRects>(r, record, 4);
+    REPORTER_ASSERT(r, strokes && 2 == strokes->count && !strokes->colors);
+    const SkRecords::DrawImageSet* set = assert_type<SkRecords::DrawImageSet>(r, record, 6);
+    REPORTER_ASSERT(r, set && 3 == set->count && 0.5f < set->set[0].fAlpha
+                                              && 1 == set->set[1].fAlpha);
+    assert_type<SkRecords::DrawImageRect>(r, record, 9);
+    assert_type<SkRecords::DrawImageRect>(r, record, 10);
+}
+
 static void do_draw(SkCanvas* canvas, SkColor color, bool doLayer) {
     canvas->drawColor(SK_ColorWHITE);
 
@@ -202,3 +202,45 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_FusedStages, r) {
+    // Fused BGRA loads, stores, and gathers must match the stages they replace, tails included.
+    uint32_t src[19], fused[19], unfused[19];
+    for (int i = 0; i < 19; i++) {
+        src[i] = 0x80402010 * (i+1);
+    }
+
+    SkRasterPipeline_GatherCtx gather = { src, 19, 19, 1 };
+    auto draw = [&](bool fuse, uint32_t* dst) {
+        for (int i = 0; i < 19; i++) {
+            dst[i] = 0xff102030 + i;
+        }
+        SkRasterPipeline_MemoryCtx load  = { src, 0 },
+                                   store = { dst, 0 };
+
+        const bool wasFusing = gSkFuseRasterPipelineStages.exchange(fuse);
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::load_8888, &load);          // load_bgra
+        p.append(SkRasterPipeline::swap_rb);
+        p.append(SkRasterPipeline::load_8888_dst, &store);     // load_bgra_dst
+        p.append(SkRasterPipeline::swap_rb_dst);
+        p.append(SkRasterPipeline::srcover);
+        p.append(SkRasterPipeline::swap_rb);                   // store_bgra
+        p.append(SkRasterPipeline::store_8888, &store);
+        p.append(SkRasterPipeline::seed_shader);
+        p.append(SkRasterPipeline::gather_8888, &gather);      // gather_bgra
+        p.append(SkRasterPipeline::swap_rb);
+        p.append(SkRasterPipeline::load_8888_dst, &store);
+        p.append(SkRasterPipeline::srcover);
+        p.append(SkRasterPipeline::store_8888, &store);
+        gSkFuseRasterPipelineStages = wasFusing;
+
+        p.run(0,0,19,1);
+    };
+    draw(true,  fused);
+    draw(false, unfused);
+
+    for (int i = 0; i < 19; i++) {
+        REPORTER_ASSERT(r, fused[i] == unfused[i], "%d: %08x vs %08x", i, fused[i], unfused[i]);
+    }
+}
@@ -846,3 +846,99 @@ DEF_TEST(SkRemoteGlyphCache_ReWriteGlyph, reporter) {
     // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
     discardableManager->unlockAndDeleteAll();
 }
+
+DEF_TEST(SkRemoteGlyphCache_CompressedStrikeData, reporter) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    SkFont font;
+    font.setSize(30);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    SkScalerContextFlags flags = SkScalerContextFlags::kFakeGammaAndBoostContrast;
+
+    // Send the same glyph images and paths to one client in the original format, and to another
+    // compressed, in frames that are read as they arrive.
+    SkStrikeCache strikeCaches[2];
+    sk_sp<SkTypeface> clientTfs[2];
+    for (bool compressed : {false, true}) {
+        SkStrikeServer server(discardableManager.get());
+        SkStrikeClient client(discardableManager, false, &strikeCaches[compressed]);
+        auto tfData = server.serializeTypeface(serverTf.get());
+        clientTfs[compressed] = client.deserializeTypeface(tfData->data(), tfData->size());
+        REPORTER_ASSERT(reporter, clientTfs[compressed]);
+
+        SkScalerContextEffects effects;
+        font.setTypeface(serverTf);
+        auto* cacheState = server.getOrCreateCache(
+                SkPaint(), font, SkSurfacePropsCopyOrDefault(nullptr), SkMatrix::I(), flags,
+                &effects);
+        for (SkGlyphID id = 0; id < 100; id++) {
+            cacheState->addGlyph(SkPackedGlyphID(id), false);
+            if (id % 3 == 0) cacheState->addGlyph(SkPackedGlyphID(id), true);
+        }
+
+        std::vector<uint8_t> serverStrikeData;
+        if (!compressed) {
+            server.writeStrikeData(&serverStrikeData);
+            REPORTER_ASSERT(reporter, client.readStrikeData(serverStrikeData.data(),
+                                                            serverStrikeData.size()));
+            continue;
+        }
+
+        server.writeCompressedStrikeData(&serverStrikeData, 1024);
+        size_t bytesRead = 0u;
+        int reads = 0;
+        for (size_t bytesArrived = 0u; bytesArrived < serverStrikeData.size();) {
+            bytesArrived = SkTMin(bytesArrived + 100u, serverStrikeData.size());
+            const uint8_t* unread = serverStrikeData.data() + bytesRead;
+            size_t frames = SkStrikeClient::CompleteFramesSize(unread, bytesArrived - bytesRead);
+            if (frames > 0u) {
+                REPORTER_ASSERT(reporter, client.readCompressedStrikeData(unread, frames));
+                bytesRead += frames;
+                reads++;
+            }
+        }
+        REPORTER_ASSERT(reporter, bytesRead == serverStrikeData.size());
+        REPORTER_ASSERT(reporter, reads > 1, "%d reads", reads);
+    }
+
+    SkExclusiveStrikePtr strikes[2];
+    for (int i = 0; i < 2; i++) {
+        SkAutoDescriptor ad;
+        SkScalerContextEffects effects;
+        font.setTypeface(clientTfs[i]);
+        auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+                font, SkPaint(), SkSurfacePropsCopyOrDefault(nullptr), flags, SkMatrix::I(), &ad,
+                &effects);
+        strikes[i] = strikeCaches[i].findStrikeExclusive(*desc);
+        REPORTER_ASSERT(reporter, strikes[i]);
+        if (!strikes[i]) return;
+    }
+
+    for (SkGlyphID id = 0; id < 100; id++) {
+        const SkGlyph* expected = strikes[0]->getCachedGlyph(SkPackedGlyphID(id));
+        const SkGlyph* glyph = strikes[1]->getCachedGlyph(SkPackedGlyphID(id));
+        if (!expected || !glyph) {
+            ERRORF(reporter, "glyph %d was not sent", id);
+            continue;
+        }
+        REPORTER_ASSERT(reporter, glyph->fAdvanceX == expected->fAdvanceX &&
+                                  glyph->fAdvanceY == expected->fAdvanceY &&
+                                  glyph->fWidth == expected->fWidth &&
+                                  glyph->fHeight == expected->fHeight &&
+                                  glyph->fTop == expected->fTop &&
+                                  glyph->fLeft == expected->fLeft &&
+                                  glyph->fMaskFormat == expected->fMaskFormat, "glyph %d", id);
+        REPORTER_ASSERT(reporter, (glyph->fImage != nullptr) == (expected->fImage != nullptr));
+        if (glyph->fImage && expected->fImage) {
+            REPORTER_ASSERT(reporter, !memcmp(glyph->fImage, expected->fImage,
+                                              expected->computeImageSize()), "glyph %d", id);
+        }
+        REPORTER_ASSERT(reporter, (glyph->path() != nullptr) == (expected->path() != nullptr));
+        if (glyph->path() && expected->path()) {
+            REPORTER_ASSERT(reporter, *glyph->path() == *expected->path(), "glyph %d", id);
+        }
+    }
+
+    // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
+    discardableManager->unlockAndDeleteAll();
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if defined(SK_USING_SKSHAPER)
+
+#include "SkFont.h"
+#include "SkShaperCache.h"
+#include "SkTypeface.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// Records everything a shaper tells it, with the text spans as offsets into the text.
+class RecordingRunHandler final : public SkShaper::RunHandler {
+public:
+    explicit RecordingRunHandler(const char* text) : fText(text) {}
+
+    Buffer newRunBuffer(const RunInfo& info, const SkFont& font, int glyphCount,
+                        SkSpan<const char> utf8) override {
+        fRuns.push_back({info.fAdvance, font.getSize(), glyphCount, utf8.data() - fText,
+                         utf8.size(), 0});
+        fGlyphs.resize(fGlyphs.size() + glyphCount);
+        fPositions.resize(fPositions.size() + glyphCount);
+        fClusters.resize(fClusters.size() + glyphCount);
+        return { fGlyphs.data() + fGlyphs.size() - glyphCount,
+                 fPositions.data() + fPositions.size() - glyphCount,
+                 fClusters.data() + fClusters.size() - glyphCount };
+    }
+    void commitRun() override { fCommittedRuns++; }
+    void commitLine() override {
+        if (!fRuns.empty()) {
+            fRuns.back().fLines++;
+        }
+    }
+
+    struct Run {
+        SkVector  fAdvance;
+        SkScalar  fSize;
+        int       fGlyphCount;
+        ptrdiff_t fUtf8Offset;
+        size_t    fUtf8Size;
+        int       fLines;
+    };
+
+    const char* fText;
+    std::vector<Run> fRuns;
+    std::vector<SkGlyphID> fGlyphs;
+    std::vector<SkPoint> fPositions;
+    std::vector<uint32_t> fClusters;
+    int fCommittedRuns = 0;
+};
+
+}  // namespace
+
+static void check_same_runs(skiatest::Reporter* r, const RecordingRunHandler& expected,
+                            const RecordingRunHandler& actual, SkVector offset) {
+    REPORTER_ASSERT(r, expected.fRuns.size() == actual.fRuns.size());
+    REPORTER_ASSERT(r, expected.fCommittedRuns == actual.fCommittedRuns);
+    REPORTER_ASSERT(r, expected.fGlyphs == actual.fGlyphs);
+    REPORTER_ASSERT(r, expected.fClusters == actual.fClusters);
+    for (size_t i = 0; i < SkTMin(expected.fRuns.size(), actual.fRuns.size()); ++i) {
+        const auto &e = expected.fRuns[i], &a = actual.fRuns[i];
+        REPORTER_ASSERT(r, e.fAdvance == a.fAdvance && e.fSize == a.fSize &&
+                           e.fGlyphCount == a.fGlyphCount && e.fUtf8Offset == a.fUtf8Offset &&
+                           e.fUtf8Size == a.fUtf8Size && e.fLines == a.fLines, "run %d", (int)i);
+    }
+    for (size_t i = 0; i < SkTMin(expected.fPositions.size(), actual.fPositions.size()); ++i) {
+        REPORTER_ASSERT(r, expected.fPositions[i] + offset == actual.fPositions[i],
+                        "glyph %d", (int)i);
+    }
+}
+
+DEF_TEST(SkShaperCache, r) {
+    std::unique_ptr<SkShaper> shaper = SkShaper::Make();
+    std::unique_ptr<SkShaperCache> cache = SkShaperCache::Make(SkShaper::Make());
+    SkFont font(SkTypeface::MakeDefault(), 16);
+    const char text[] = "The quick brown fox jumps over the lazy dog.";
+    const SkPoint origin = {10, 20};
+
+    RecordingRunHandler expected(text);
+    SkPoint expectedEnd = shaper->shape(&expected, font, text, strlen(text), true, origin, 120);
+
+    // The first shaping is a miss, and later ones replay it, moved to where they are shaped.
+    // The text is copied, to check that the runs point into the text they are shaped for.
+    for (SkPoint point : {origin, origin, SkPoint{-3.5f, 40}}) {
+        std::string copy(text);
+        RecordingRunHandler actual(copy.c_str());
+        SkPoint end = cache->shape(&actual, font, copy.c_str(), copy.size(), true, point, 120);
+        REPORTER_ASSERT(r, end == expectedEnd + (point - origin));
+        check_same_runs(r, expected, actual, point - origin);
+    }
+    SkShaperCache::Stats stats = cache->stats();
+    REPORTER_ASSERT(r, stats.fHits == 2 && stats.fMisses == 1 && stats.fEntries == 1,
+                    "%d hits, %d misses, %d entries", stats.fHits, stats.fMisses, stats.fEntries);
+
+    // Any change to the key is a miss.
+    RecordingRunHandler other(text);
+    cache->shape(&other, font, text, strlen(text), true, origin, 200);
+    cache->shape(&other, font, text, strlen(text) - 1, true, origin, 120);
+    cache->shape(&other, SkFont(SkTypeface::MakeDefault(), 17), text, strlen(text), true, origin,
+                 120);
+    stats = cache->stats();
+    REPORTER_ASSERT(r, stats.fHits == 2 && stats.fMisses == 4 && stats.fEntries == 4);
+
+    cache->purgeAll();
+    stats = cache->stats();
+    REPORTER_ASSERT(r, stats.fEntries == 0 && stats.fBytesUsed == 0);
+}
+
+DEF_TEST(SkShaperCache_Budget, r) {
+    SkFont font(SkTypeface::MakeDefault(), 16);
+    const char* labels[] = { "Cancel", "OK", "Save As...", "Open Recent" };
+    auto shape_label = [&](SkShaperCache* cache, int i) {
+        RecordingRunHandler handler(labels[i]);
+        cache->shape(&handler, font, labels[i], strlen(labels[i]), true, {0, 0}, 1000);
+    };
+
+    // Find how many bytes it takes to hold three of the labels.
+    std::unique_ptr<SkShaperCache> cache = SkShaperCache::Make(SkShaper::Make());
+    for (int i = 0; i < 3; ++i) {
+        shape_label(cache.get(), i);
+    }
+    size_t budget = cache->stats().fBytesUsed;
+
+    // Using a label keeps it over ones that were shaped after it.
+    cache = SkShaperCache::Make(SkShaper::Make(), budget);
+    shape_label(cache.get(), 0);
+    shape_label(cache.get(), 1);
+    shape_label(cache.get(), 2);
+    shape_label(cache.get(), 0);
+    shape_label(cache.get(), 3);
+    SkShaperCache::Stats stats = cache->stats();
+    REPORTER_ASSERT(r, stats.fBytesUsed <= budget);
+    REPORTER_ASSERT(r, stats.fHits == 1 && stats.fMisses == 4);
+    shape_label(cache.get(), 0);
+    REPORTER_ASSERT(r, cache->stats().fHits == 2);
+    shape_label(cache.get(), 1);
+    REPORTER_ASSERT(r, cache->stats().fMisses == 5);
+
+    // Nothing is kept without a budget, but shaping still works.
+    cache = SkShaperCache::Make(SkShaper::Make(), 0);
+    RecordingRunHandler expected(labels[2]), actual(labels[2]);
+    SkShaper::Make()->shape(&expected, font, labels[2], strlen(labels[2]), true, {0, 0}, 1000);
+    cache->shape(&actual, font, labels[2], strlen(labels[2]), true, {0, 0}, 1000);
+    check_same_runs(r, expected, actual, {0, 0});
+    stats = cache->stats();
+    REPORTER_ASSERT(r, stats.fEntries == 0 && stats.fBytesUsed == 0);
+}
+
+#endif
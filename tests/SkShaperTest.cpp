@@ -0,0 +1,63 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if defined(SK_USING_SKSHAPER)
+
+#include "SkData.h"
+#include "SkExecutor.h"
+#include "SkSerialProcs.h"
+#include "SkShaper.h"
+#include "SkString.h"
+#include "SkTextBlob.h"
+
+#include <vector>
+
+DEF_TEST(SkShaper_ShapeParagraphs, r) {
+    const char* words[] = { "Lorem", "ipsum", "dolor", "sit", "amet,", "consectetur" };
+    std::vector<SkString> texts;
+    for (int i = 0; i < 50; ++i) {
+        SkString text;
+        for (int j = 0; j <= i; ++j) {
+            text.appendf("%s ", words[(i + j) % SK_ARRAY_COUNT(words)]);
+        }
+        texts.push_back(text);
+    }
+    SkFont font(SkTypeface::MakeDefault(), 14);
+
+    // Shape each text on its own, and then all of them in parallel, and compare the blobs.
+    std::unique_ptr<SkShaper> shaper = SkShaper::Make();
+    std::vector<sk_sp<SkData>> expected;
+    std::vector<SkPoint> expectedEnds;
+    for (const SkString& text : texts) {
+        SkTextBlobBuilderRunHandler handler(text.c_str());
+        expectedEnds.push_back(shaper->shape(&handler, font, text.c_str(), text.size(), true,
+                                             {5, 5}, 300));
+        expected.push_back(handler.makeBlob()->serialize(SkSerialProcs()));
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* e : {executor.get(), (SkExecutor*)nullptr}) {
+        std::vector<std::unique_ptr<SkTextBlobBuilderRunHandler>> handlers;
+        std::vector<SkShaper::Paragraph> paragraphs;
+        for (size_t i = 0; i < texts.size(); ++i) {
+            handlers.emplace_back(new SkTextBlobBuilderRunHandler(texts[i].c_str()));
+            paragraphs.push_back({handlers[i].get(), font, texts[i].c_str(), texts[i].size(), true,
+                                  {5, 5}, 300, {0, 0}});
+        }
+        SkShaper::ShapeParagraphs(SkSpan<SkShaper::Paragraph>(paragraphs), e, 4);
+
+        for (size_t i = 0; i < texts.size(); ++i) {
+            REPORTER_ASSERT(r, paragraphs[i].fEnd == expectedEnds[i], "paragraph %d", (int)i);
+            sk_sp<SkData> blob = handlers[i]->makeBlob()->serialize(SkSerialProcs());
+            REPORTER_ASSERT(r, blob->equals(expected[i].get()), "paragraph %d", (int)i);
+        }
+    }
+}
+
+#endif
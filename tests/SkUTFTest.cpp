@@ -4,6 +4,9 @@
 #include "SkUTF.h"
 #include "Test.h"
 
+#include <string>
+#include <vector>
+
 DEF_TEST(SkUTF_UTF16, reporter) {
     // Test non-basic-multilingual-plane unicode.
     static const SkUnichar gUni[] = {
@@ -134,6 +137,45 @@ DEF_TEST(SkUTF_NextUTF8_ToUTF8, r) {
         REPORTER_ASSERT(r, 0 == strcmp(str, buff));
     }
 }
+
+DEF_TEST(SkUTF_UTF8ToUTF32, r) {
+    // Long enough for runs of ASCII to be taken a block at a time, with multibyte sequences
+    // at every offset into a block.
+    std::string text;
+    for (int i = 0; i < 40; ++i) {
+        text += std::string(i % 11, 'a' + i % 26) + LEADING_THREE_BYTE CONTINUATION_BYTE
+                CONTINUATION_BYTE + LEADING_FOUR_BYTE "\x90\x8C\xB0" LEADING_TWO_BYTE
+                CONTINUATION_BYTE;
+    }
+    for (size_t length : { (size_t)0, (size_t)3, (size_t)9, (size_t)19, text.size() }) {
+        int count = SkUTF::CountUTF8(text.data(), length);
+        std::vector<SkUnichar> expected;
+        const char* ptr = text.data();
+        while (ptr < text.data() + length) {
+            expected.push_back(SkUTF::NextUTF8(&ptr, text.data() + length));
+        }
+        REPORTER_ASSERT(r, count == (int)expected.size());
+
+        std::vector<SkUnichar> unichars(count + 1);
+        REPORTER_ASSERT(r, count == SkUTF::UTF8ToUTF32(text.data(), length, unichars.data(),
+                                                       count + 1));
+        unichars.resize(count);
+        REPORTER_ASSERT(r, unichars == expected);
+        if (count > 0) {
+            REPORTER_ASSERT(r, -1 == SkUTF::UTF8ToUTF32(text.data(), length, unichars.data(),
+                                                        count - 1));
+        }
+    }
+
+    // Invalid bytes after a run of ASCII are still found, as are truncated sequences.
+    std::string invalid = std::string(16, 'x') + INVALID_BYTE + std::string(16, 'x');
+    SkUnichar unichars[64];
+    REPORTER_ASSERT(r, -1 == SkUTF::CountUTF8(invalid.data(), invalid.size()));
+    REPORTER_ASSERT(r, -1 == SkUTF::UTF8ToUTF32(invalid.data(), invalid.size(), unichars, 64));
+    REPORTER_ASSERT(r, -1 == SkUTF::CountUTF8(text.data(), 5));
+    REPORTER_ASSERT(r, -1 == SkUTF::UTF8ToUTF32(text.data(), 5, unichars, 64));
+}
+
 #undef ASCII_BYTE
 #undef CONTINUATION_BYTE
 #undef LEADING_TWO_BYTE
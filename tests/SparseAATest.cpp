@@ -0,0 +1,140 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
+#include "SkBlitter.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkRasterClip.h"
+#include "SkScan.h"
+#include "Test.h"
+
+static constexpr int kSize = 256;
+
+// Draws path into a fresh A8 bitmap, so each pixel holds the path's coverage.
+static SkBitmap draw_coverage(const SkPath& path, const SkIRect& clip, bool sparse) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    SkPixmap pm;
+    SkAssertResult(bm.peekPixels(&pm));
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkArenaAlloc alloc(0);
+    SkBlitter* blitter = SkBlitter::Choose(pm, SkMatrix::I(), paint, &alloc);
+    if (sparse) {
+        SkScan::SparseFillPath(path, blitter, path.getBounds().roundOut(), clip);
+    } else {
+        SkScan::AntiFillPath(path, SkRasterClip(clip), blitter);
+    }
+    return bm;
+}
+
+// Returns the mean difference of a and b, counting the pixels that differ by more than 96.
+static float compare(const SkBitmap& a, const SkBitmap& b, int* farOff) {
+    int sum = 0;
+    *farOff = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            int diff = SkAbs32(*a.getAddr8(x, y) - *b.getAddr8(x, y));
+            sum += diff;
+            *farOff += diff > 96;
+        }
+    }
+    return (float)sum / (kSize * kSize);
+}
+
+DEF_TEST(SparseAA_ExactRectCoverage, reporter) {
+    const SkRect rect = SkRect::MakeLTRB(10.25f, 20.5f, 200.75f, 180.125f);
+    SkBitmap bm = draw_coverage(SkPath().addRect(rect), SkIRect::MakeWH(kSize, kSize), true);
+
+    // Interior tiles are blitted as rects and spans, so check every pixel's area coverage.
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            SkRect pixel = SkRect::MakeXYWH(x, y, 1, 1);
+            float area = pixel.intersect(rect) ? pixel.width() * pixel.height() : 0;
+            int expected = (int)(area * 255 + 0.5f);
+            if (SkAbs32(*bm.getAddr8(x, y) - expected) > 1) {
+                ERRORF(reporter, "pixel (%d, %d) is %d, expected %d",
+                       x, y, *bm.getAddr8(x, y), expected);
+                return;
+            }
+        }
+    }
+}
+
+DEF_TEST(SparseAA_FillTypes, reporter) {
+    // Two overlapping squares wound the same way: their overlap is in or out by the fill type.
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(16, 16, 144, 144));
+    path.addRect(SkRect::MakeLTRB(80, 80, 208, 208));
+    const SkIRect clip = SkIRect::MakeWH(kSize, kSize);
+
+    SkBitmap winding = draw_coverage(path, clip, true);
+    REPORTER_ASSERT(reporter, *winding.getAddr8(112, 112) == 0xFF);
+    REPORTER_ASSERT(reporter, *winding.getAddr8( 40,  40) == 0xFF);
+    REPORTER_ASSERT(reporter, *winding.getAddr8(200,  40) == 0x00);
+
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    SkBitmap evenOdd = draw_coverage(path, clip, true);
+    REPORTER_ASSERT(reporter, *evenOdd.getAddr8(112, 112) == 0x00);
+    REPORTER_ASSERT(reporter, *evenOdd.getAddr8( 40,  40) == 0xFF);
+    REPORTER_ASSERT(reporter, *evenOdd.getAddr8(180, 180) == 0xFF);
+}
+
+DEF_TEST(SparseAA_MatchesAnalyticAA, reporter) {
+    SkRandom rand;
+    const SkIRect full = SkIRect::MakeWH(kSize, kSize),
+                  clip = SkIRect::MakeLTRB(37, 21, 219, 230);
+
+    for (int i = 0; i < 20; ++i) {
+        SkPath path;
+        path.moveTo(rand.nextRangeF(-20, kSize + 20), rand.nextRangeF(-20, kSize + 20));
+        for (int j = 0; j < 12; ++j) {
+            SkPoint p[3];
+            for (SkPoint& pt : p) {
+                pt.set(rand.nextRangeF(-20, kSize + 20), rand.nextRangeF(-20, kSize + 20));
+            }
+            switch (j % 4) {
+                case 0: path.lineTo(p[0]);                    break;
+                case 1: path.quadTo(p[0], p[1]);              break;
+                case 2: path.conicTo(p[0], p[1], 0.7f);       break;
+                case 3: path.cubicTo(p[0], p[1], p[2]);       break;
+            }
+        }
+        path.close();
+        if (i & 1) {
+            path.setFillType(SkPath::kEvenOdd_FillType);
+        }
+
+        // Sparse AA computes exact areas, and the other scan converters approximate them where
+        // edges cross, so a few pixels may be far off; a bad backdrop would be off for whole rows.
+        SkBitmap sparse    = draw_coverage(path, full, true),
+                 reference = draw_coverage(path, full, false);
+        int farOff;
+        float meanDiff = compare(sparse, reference, &farOff);
+        REPORTER_ASSERT(reporter, meanDiff < 2 && farOff < 128,
+                        "path %d: mean difference %g, %d pixels far off", i, meanDiff, farOff);
+
+        // Clipping moves edges onto the clip's left edge and drops them past its right edge;
+        // inside the clip, that must not change the coverage.
+        SkBitmap clipped = draw_coverage(path, clip, true);
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                int expected = clip.contains(x, y) ? *sparse.getAddr8(x, y) : 0;
+                if (SkAbs32(*clipped.getAddr8(x, y) - expected) > 1) {
+                    ERRORF(reporter, "path %d: pixel (%d, %d) is %d clipped, %d unclipped",
+                           i, x, y, *clipped.getAddr8(x, y), expected);
+                    return;
+                }
+            }
+        }
+    }
+}
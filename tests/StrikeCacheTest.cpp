@@ -0,0 +1,271 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkExecutor.h"
+#include "SkFont.h"
+#include "SkGraphics.h"
+#include "SkOSPath.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRemoteGlyphCache.h"
+#include "SkScalerContext.h"
+#include "SkStrike.h"
+#include "SkStrikeCache.h"
+#include "SkStream.h"
+#include "SkSurfaceProps.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static SkExclusiveStrikePtr find_or_create(SkStrikeCache* cache, SkScalar size) {
+    SkFont font(SkTypeface::MakeDefault(), size);
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, SkPaint(), SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    return cache->findOrCreateStrikeExclusive(*desc, effects, *font.getTypefaceOrDefault());
+}
+
+DEF_TEST(StrikeCache_Shared, reporter) {
+    SkStrikeCache cache;
+
+    SkAutoDescriptor desc;
+    {
+        auto strike = find_or_create(&cache, 12);
+        desc.reset(strike->getDescriptor());
+        strike->getGlyphIDAdvance(1);
+    }
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 1);
+
+    const SkStrike* shared;
+    std::atomic<const SkStrike*> checkedOut{nullptr};
+    std::thread writer;
+    {
+        // Any number of readers can share a strike, and it stays in the cache...
+        SkSharedStrikePtr a = cache.findStrikeShared(*desc.getDesc()),
+                          b = cache.findStrikeShared(*desc.getDesc());
+        REPORTER_ASSERT(reporter, a && b && a.get() == b.get());
+        REPORTER_ASSERT(reporter, a->getCachedGlyph(SkPackedGlyphID(1)) != nullptr);
+        REPORTER_ASSERT(reporter, a->getCachedGlyph(SkPackedGlyphID(2)) == nullptr);
+        REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 1);
+        shared = a.get();
+
+        // ... and can't be purged while they read it.
+        cache.purgeAll();
+        REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 1);
+
+        // Checking it out waits for the readers, instead of creating a second strike.
+        writer = std::thread([&] {
+            auto strike = find_or_create(&cache, 12);
+            strike->getGlyphIDAdvance(2);
+            checkedOut = strike.get();
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REPORTER_ASSERT(reporter, checkedOut == nullptr);
+
+        // New readers are turned away while it waits, so they can't starve it.
+        REPORTER_ASSERT(reporter, !cache.findStrikeShared(*desc.getDesc()));
+    }
+    writer.join();
+    REPORTER_ASSERT(reporter, checkedOut == shared);
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 1);
+    {
+        SkSharedStrikePtr a = cache.findStrikeShared(*desc.getDesc());
+        REPORTER_ASSERT(reporter, a && a->getCachedGlyph(SkPackedGlyphID(2)) != nullptr);
+    }
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(reporter, !cache.findStrikeShared(*desc.getDesc()));
+}
+
+DEF_TEST(StrikeCache_GlobalBudget, reporter) {
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(20);
+
+    // These strikes spread over the shards, but the count limit is for the whole cache.
+    for (int size = 8; size < 108; ++size) {
+        find_or_create(&cache, size)->getGlyphIDAdvance(1);
+        REPORTER_ASSERT(reporter, cache.getCacheCountUsed() <= 20,
+                        "%d strikes", cache.getCacheCountUsed());
+    }
+    // Purges free at least a quarter of the cache, so the most recent strikes survive.
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() >= 10);
+    cache.validate();
+
+    cache.setCacheCountLimit(5);
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() <= 5);
+    cache.validate();
+}
+
+DEF_TEST(StrikeCache_ThreadedMeasure, reporter) {
+    SkFont font(SkTypeface::MakeDefault(), 17);
+    const char text[] = "The quick brown fox jumps over the lazy dog.";
+    const SkScalar expected = font.measureText(text, strlen(text), kUTF8_SkTextEncoding);
+
+    // Once the strike is cached, the threads share it; before, they check it out.
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<std::thread> threads;
+        std::atomic<int> mismatches{0};
+        for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&] {
+                for (int j = 0; j < 100; ++j) {
+                    if (font.measureText(text, strlen(text), kUTF8_SkTextEncoding) != expected) {
+                        mismatches++;
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        REPORTER_ASSERT(reporter, mismatches == 0);
+        SkGraphics::PurgeFontCache();
+    }
+}
+
+DEF_TEST(StrikeCache_File, reporter) {
+    int ttcIndex;
+    if (!SkTypeface::MakeDefault()->openStream(&ttcIndex)) {
+        return;  // Without font data, there's nothing to key the strikes by.
+    }
+
+    SkStrikeCache cache;
+    {
+        auto strike = find_or_create(&cache, 24);
+        for (SkGlyphID id = 1; id < 20; ++id) {
+            const SkGlyph& glyph = strike->getGlyphIDMetrics(id);
+            strike->findImage(glyph);
+            if (id % 2) {
+                strike->findPath(glyph);
+            }
+        }
+        strike->getGlyphIDAdvance(20);
+    }
+    sk_sp<SkData> data = SkStrikeCacheFile::Serialize(cache);
+
+    // Write() saves the same data to a file, which is opened again below.
+    SkString path, tmpDir = skiatest::GetTmpDir();
+    if (!tmpDir.isEmpty()) {
+        path = SkOSPath::Join(tmpDir.c_str(), "strike_cache_test");
+        REPORTER_ASSERT(reporter, SkStrikeCacheFile::Write(cache, path.c_str()));
+        sk_sp<SkData> written = SkData::MakeFromFileName(path.c_str());
+        REPORTER_ASSERT(reporter, written && written->equals(data.get()));
+    }
+
+    sk_sp<SkStrikeCacheFile> file = SkStrikeCacheFile::Make(data);
+    REPORTER_ASSERT(reporter, file && file->strikeCount() == 1);
+    if (!file) {
+        return;
+    }
+
+    // A new cache, as in a new process, gets the glyphs from the file instead of making them.
+    SkStrikeCache newCache;
+    newCache.setPreloader(file);
+    auto saved  = find_or_create(&cache,    24),
+         loaded = find_or_create(&newCache, 24);
+    REPORTER_ASSERT(reporter, loaded->countCachedGlyphs() == 20);
+    for (SkGlyphID id = 1; id <= 20; ++id) {
+        const SkGlyph* expected = saved->getCachedGlyph(SkPackedGlyphID(id));
+        const SkGlyph* glyph = loaded->getCachedGlyph(SkPackedGlyphID(id));
+        if (!glyph) {
+            ERRORF(reporter, "glyph %d was not loaded", id);
+            continue;
+        }
+        REPORTER_ASSERT(reporter, glyph->fAdvanceX == expected->fAdvanceX &&
+                                  glyph->fWidth    == expected->fWidth    &&
+                                  glyph->fHeight   == expected->fHeight   &&
+                                  glyph->fMaskFormat == expected->fMaskFormat);
+        REPORTER_ASSERT(reporter, (glyph->fImage != nullptr) == (expected->fImage != nullptr));
+        if (glyph->fImage && expected->fImage) {
+            REPORTER_ASSERT(reporter, !memcmp(glyph->fImage, expected->fImage,
+                                              expected->computeImageSize()));
+        }
+        bool expectPath = expected->fPathData && expected->fPathData->fHasPath;
+        REPORTER_ASSERT(reporter, expectPath == (glyph->fPathData && glyph->fPathData->fHasPath));
+        if (expectPath) {
+            REPORTER_ASSERT(reporter, glyph->fPathData->fPath == expected->fPathData->fPath);
+        }
+    }
+
+    // Other strikes aren't in the file.
+    REPORTER_ASSERT(reporter, find_or_create(&newCache, 25)->countCachedGlyphs() == 0);
+
+    // Opened again from the file written earlier, it has the same strikes and glyphs.
+    if (!path.isEmpty()) {
+        sk_sp<SkStrikeCacheFile> opened = SkStrikeCacheFile::Open(path.c_str());
+        REPORTER_ASSERT(reporter, opened && opened->strikeCount() == 1);
+        if (opened) {
+            SkStrikeCache openedCache;
+            openedCache.setPreloader(opened);
+            auto reopened = find_or_create(&openedCache, 24);
+            REPORTER_ASSERT(reporter, reopened->countCachedGlyphs() == 20);
+            for (SkGlyphID id = 1; id <= 20; ++id) {
+                const SkGlyph* expected = loaded->getCachedGlyph(SkPackedGlyphID(id));
+                const SkGlyph* glyph = reopened->getCachedGlyph(SkPackedGlyphID(id));
+                REPORTER_ASSERT(reporter, glyph && expected &&
+                                          glyph->fAdvanceX == expected->fAdvanceX &&
+                                          glyph->fWidth    == expected->fWidth    &&
+                                          glyph->fHeight   == expected->fHeight);
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, !SkStrikeCacheFile::Open("/this/file/does/not/exist"));
+
+    // Damaged files are rejected, or at worst load fewer glyphs.
+    REPORTER_ASSERT(reporter, !SkStrikeCacheFile::Make(SkData::MakeWithCString("not a file")));
+    {
+        // So are files from other Skia milestones, which come after the magic and version.
+        sk_sp<SkData> otherMilestone = SkData::MakeWithCopy(data->data(), data->size());
+        static_cast<uint32_t*>(otherMilestone->writable_data())[2] += 1;
+        REPORTER_ASSERT(reporter, !SkStrikeCacheFile::Make(otherMilestone));
+    }
+    for (size_t size = 0; size < data->size(); size += 7) {
+        sk_sp<SkStrikeCacheFile> truncated =
+                SkStrikeCacheFile::Make(SkData::MakeSubset(data.get(), 0, size));
+        REPORTER_ASSERT(reporter, !truncated);
+    }
+}
+
+DEF_TEST(StrikeCache_PrepareImages, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Make the images of one strike in batches, in parallel or on this thread, and of another
+    // lazily, and compare them.
+    for (SkExecutor* preparer : {executor.get(), (SkExecutor*)nullptr}) {
+        SkStrikeCache preparedCache, lazyCache;
+        auto prepared = find_or_create(&preparedCache, 30),
+             lazy     = find_or_create(&lazyCache,     30);
+        int glyphCount = SkTMin(300, (int)prepared->getGlyphCount());
+        std::vector<const SkGlyph*> glyphs;
+        for (SkGlyphID id = 0; id < glyphCount; ++id) {
+            glyphs.push_back(&prepared->getGlyphIDMetrics(id));
+            glyphs.push_back(&prepared->getGlyphIDMetrics(id));  // Repeats only get one image.
+        }
+        prepared->prepareImages(SkSpan<const SkGlyph* const>{glyphs.data(), glyphs.size()},
+                                preparer);
+
+        for (SkGlyphID id = 0; id < glyphCount; ++id) {
+            const SkGlyph* glyph = prepared->getCachedGlyph(SkPackedGlyphID(id));
+            const SkGlyph& expected = lazy->getGlyphIDMetrics(id);
+            const void* expectedImage = lazy->findImage(expected);
+            REPORTER_ASSERT(reporter, (glyph->fImage != nullptr) == (expectedImage != nullptr),
+                            "glyph %d", id);
+            if (glyph->fImage && expectedImage) {
+                REPORTER_ASSERT(reporter, !memcmp(glyph->fImage, expectedImage,
+                                                  expected.computeImageSize()), "glyph %d", id);
+            }
+        }
+        REPORTER_ASSERT(reporter, prepared->getMemoryUsed() == lazy->getMemoryUsed());
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkGradientShader.h"
+#include "SkImage.h"
+#include "SkMaskFilter.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+#include "Test.h"
+#include "sk_tool_utils.h"
+
+static void draw_scene(SkCanvas* canvas) {
+    SkRandom rand;
+    canvas->clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    for (int i = 0; i < 40; i++) {
+        paint.setColor(rand.nextU() | 0x80000000);
+        paint.setAntiAlias(rand.nextBool());
+        paint.setStyle(rand.nextBool() ? SkPaint::kFill_Style : SkPaint::kStroke_Style);
+        paint.setStrokeWidth(rand.nextRangeF(0, 6));
+
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeF(-20, 200), rand.nextRangeF(-20, 200),
+                                    rand.nextRangeF(1, 80), rand.nextRangeF(1, 80));
+        switch (i % 4) {
+            case 0: canvas->drawRect(r, paint);                                     break;
+            case 1: canvas->drawOval(r, paint);                                     break;
+            case 2: canvas->drawRRect(SkRRect::MakeRectXY(r, 7, 5), paint);         break;
+            case 3: canvas->drawLine(r.fLeft, r.fTop, r.fRight, r.fBottom, paint); break;
+        }
+    }
+
+    // A shader, a rotated clip, and a layer, all of which straddle tile boundaries.
+    const SkPoint pts[] = {{0, 0}, {256, 256}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    paint.reset();
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kMirror_TileMode));
+    paint.setDither(true);
+
+    canvas->save();
+    canvas->rotate(17, 128, 128);
+    canvas->clipRect(SkRect::MakeLTRB(30, 30, 220, 220), true);
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(300, 10, -40, 250, 240, 240);
+    path.close();
+    canvas->drawPath(path, paint);
+    canvas->restore();
+
+    // A blur and an inverse fill, each scan converted once and shared by the tiles they touch.
+    paint.reset();
+    paint.setColor(0xC0204080);
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 4));
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(40, 60, 200, 190), 20, 20), paint);
+    paint.reset();
+    paint.setColor(0x40808000);
+    paint.setAntiAlias(true);
+    path.reset();
+    path.addCircle(100, 150, 70);
+    path.setFillType(SkPath::kInverseEvenOdd_FillType);
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(10, 20, 230, 250));
+    canvas->drawPath(path, paint);
+    canvas->restore();
+
+    canvas->saveLayerAlpha(nullptr, 0x80);
+    paint.reset();
+    paint.setColor(SK_ColorGREEN);
+    paint.setAntiAlias(true);
+    canvas->drawCircle(128, 128, 90, paint);
+    canvas->restore();
+}
+
+DEF_TEST(ThreadedBMPDevice_MatchesBitmapDevice, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(256, 256);
+
+    auto expected = SkSurface::MakeRaster(info);
+    draw_scene(expected->getCanvas());
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int tiles : {1, 3, 7, 256}) {
+        auto threaded = SkSurface::MakeRasterThreaded(info, tiles, executor.get());
+        REPORTER_ASSERT(reporter, threaded);
+        draw_scene(threaded->getCanvas());
+
+        SkBitmap a, b;
+        a.allocPixels(info);
+        b.allocPixels(info);
+        REPORTER_ASSERT(reporter, expected->readPixels(a, 0, 0));
+        REPORTER_ASSERT(reporter, threaded->readPixels(b, 0, 0));
+        REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(a, b), "tiles %d", tiles);
+    }
+}
+
+DEF_TEST(ThreadedBMPDevice_SnapshotFlushes, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    auto surface = SkSurface::MakeRasterThreaded(SkImageInfo::MakeN32Premul(16, 16), 4,
+                                                 executor.get());
+    surface->getCanvas()->clear(SK_ColorRED);
+
+    sk_sp<SkImage> image = surface->makeImageSnapshot();
+    SkPixmap pm;
+    REPORTER_ASSERT(reporter, image->peekPixels(&pm));
+    REPORTER_ASSERT(reporter, *pm.addr32(15, 15) == SkPreMultiplyColor(SK_ColorRED));
+
+    // Drawing after the snapshot must not change it.
+    surface->getCanvas()->clear(SK_ColorBLUE);
+    surface->getCanvas()->flush();
+    REPORTER_ASSERT(reporter, *pm.addr32(0, 0) == SkPreMultiplyColor(SK_ColorRED));
+}
+
+DEF_TEST(ThreadedBMPDevice_MutableBitmap, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    auto surface = SkSurface::MakeRasterThreaded(SkImageInfo::MakeN32Premul(16, 16), 4,
+                                                 executor.get());
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorRED);
+    surface->getCanvas()->drawBitmap(bitmap, 0, 0);
+    bitmap.eraseColor(SK_ColorGREEN);
+    surface->getCanvas()->drawBitmapRect(bitmap, SkRect::MakeXYWH(0, 8, 16, 8), nullptr);
+
+    // The draws are queued, but must still see the bitmap as it was when each was issued.
+    bitmap.eraseColor(SK_ColorBLUE);
+    SkPixmap pm;
+    REPORTER_ASSERT(reporter, surface->peekPixels(&pm));
+    REPORTER_ASSERT(reporter, *pm.addr32(15, 0)  == SkPreMultiplyColor(SK_ColorRED));
+    REPORTER_ASSERT(reporter, *pm.addr32(15, 15) == SkPreMultiplyColor(SK_ColorGREEN));
+}
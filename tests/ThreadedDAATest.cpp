@@ -0,0 +1,83 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
+#include "SkBlitter.h"
+#include "SkCoverageDelta.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkRasterClip.h"
+#include "SkScan.h"
+#include "Test.h"
+
+#if !defined(SK_DISABLE_DAA)
+
+// Scan converts path with DAA (a record forces DAA) into a fresh bitmap.
+static SkBitmap draw_with_daa(const SkPath& path, bool threaded) {
+    SkBitmap bm;
+    bm.allocN32Pixels(512, 512);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    SkPixmap pm;
+    SkAssertResult(bm.peekPixels(&pm));
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkArenaAlloc alloc(0);
+    SkBlitter* blitter = SkBlitter::Choose(pm, SkMatrix::I(), paint, &alloc);
+    SkRasterClip rc(SkIRect::MakeWH(500, 500));    // a clip smaller than the bitmap
+
+    const bool wasThreaded = gSkUseThreadedDAA.exchange(threaded);
+    SkDAARecord record(&alloc);
+    SkScan::AntiFillPath(path, rc, blitter, &record);   // compute the deltas
+    SkScan::AntiFillPath(path, rc, blitter, &record);   // blit them
+    gSkUseThreadedDAA = wasThreaded;
+    return bm;
+}
+
+static void check_same_pixels(skiatest::Reporter* reporter, const SkPath& path) {
+    SkBitmap serial   = draw_with_daa(path, false),
+             threaded = draw_with_daa(path, true);
+    REPORTER_ASSERT(reporter, 0 == memcmp(serial.getPixels(), threaded.getPixels(),
+                                          serial.computeByteSize()));
+}
+
+DEF_TEST(ThreadedDAA_MatchesSerial, reporter) {
+    SkRandom rand;
+
+    // A chart-like polyline with thousands of edges, most of them spanning many rows.
+    SkPath chart;
+    chart.moveTo(0, 256);
+    for (int i = 0; i < 4000; i++) {
+        chart.lineTo(i * (510.0f / 4000), rand.nextRangeF(-20, 530));
+    }
+    chart.close();
+    check_same_pixels(reporter, chart);
+
+    chart.setFillType(SkPath::kEvenOdd_FillType);
+    check_same_pixels(reporter, chart);
+
+    // Curves are walked as several segments, and cubics aren't chopped at their y extrema.
+    SkPath curves;
+    curves.moveTo(256, 0);
+    for (int i = 0; i < 1500; i++) {
+        SkPoint p[3];
+        for (SkPoint& pt : p) {
+            pt.set(rand.nextRangeF(-10, 520), rand.nextRangeF(-10, 520));
+        }
+        if (i & 1) {
+            curves.cubicTo(p[0], p[1], p[2]);
+        } else {
+            curves.quadTo(p[0], p[1]);
+        }
+    }
+    curves.close();
+    check_same_pixels(reporter, curves);
+}
+
+#endif
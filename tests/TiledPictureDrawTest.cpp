@@ -0,0 +1,186 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkGraphics.h"
+#include "SkImage.h"
+#include "SkImageGenerator.h"
+#include "SkMakeUnique.h"
+#include "SkPictureRecorder.h"
+#include "SkTiledPictureDraw.h"
+#include "Test.h"
+#include "sk_tool_utils.h"
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+// A checkerboard that counts how many times it's decoded.
+class CountingGenerator : public SkImageGenerator {
+public:
+    CountingGenerator(std::atomic<int>* decodes)
+        : INHERITED(SkImageInfo::MakeN32Premul(16, 16)), fDecodes(decodes) {}
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        if (info.colorType() != kN32_SkColorType) {
+            return false;
+        }
+        (*fDecodes)++;
+        for (int y = 0; y < info.height(); y++) {
+            SkPMColor* row = (SkPMColor*)((char*)pixels + y * rowBytes);
+            for (int x = 0; x < info.width(); x++) {
+                row[x] = ((x ^ y) & 4) ? SkPreMultiplyColor(SK_ColorMAGENTA)
+                                       : SkPreMultiplyColor(SK_ColorCYAN);
+            }
+        }
+        return true;
+    }
+
+private:
+    std::atomic<int>* fDecodes;
+
+    typedef SkImageGenerator INHERITED;
+};
+
+}  // namespace
+
+static sk_sp<SkPicture> make_picture(SkBBHFactory* factory, sk_sp<SkImage> image) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(200, 150, factory);
+    canvas->clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 20; i++) {
+        paint.setColor(0xFF000000 | (i * 0x0C1F37));
+        canvas->drawCircle(10.0f * i, 7.5f * i, 5.0f + i, paint);
+    }
+
+    canvas->save();
+        canvas->clipRect(SkRect::MakeLTRB(30, 20, 170, 130));
+        canvas->rotate(15);
+        paint.setColor(0x8000FF00);
+        canvas->drawRect(SkRect::MakeLTRB(40, 10, 160, 90), paint);
+    canvas->restore();
+
+    // Spans every tile.
+    canvas->drawImageRect(image, SkRect::MakeLTRB(5, 5, 195, 145), nullptr);
+
+    canvas->saveLayer(nullptr, nullptr);
+        paint.setColor(0xFF0000FF);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(3);
+        canvas->drawLine(0, 150, 200, 0, paint);
+    canvas->restore();
+    return recorder.finishRecordingAsPicture();
+}
+
+// Draws picture into dst a tile at a time, either with SkTiledPictureDraw or by drawing the
+// picture into each tile in turn.
+static void draw_tiled(sk_sp<SkPicture> picture, SkBitmap* dst, int tileSize,
+                       bool useTiledPictureDraw, SkExecutor* executor) {
+    dst->allocN32Pixels(200, 150);
+    dst->eraseColor(SK_ColorTRANSPARENT);
+
+    SkTiledPictureDraw tiled(picture);
+    std::vector<std::unique_ptr<SkCanvas>> canvases;
+    for (int y = 0; y < dst->height(); y += tileSize) {
+        for (int x = 0; x < dst->width(); x += tileSize) {
+            SkIRect bounds = SkIRect::MakeXYWH(x, y, tileSize, tileSize);
+            SkAssertResult(bounds.intersect(dst->bounds()));
+            SkBitmap tile;
+            SkAssertResult(dst->extractSubset(&tile, bounds));
+            canvases.emplace_back(new SkCanvas(tile));
+            if (useTiledPictureDraw) {
+                tiled.add(canvases.back().get(), bounds);
+            } else {
+                canvases.back()->clipRect(SkRect::MakeWH(bounds.width(), bounds.height()));
+                canvases.back()->translate(-bounds.x(), -bounds.y());
+                canvases.back()->drawPicture(picture);
+            }
+        }
+    }
+    if (useTiledPictureDraw) {
+        // Drawing more than once replays the same tiles.
+        tiled.draw(executor);
+        tiled.draw(executor);
+    }
+}
+
+DEF_TEST(TiledPictureDraw, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    SkRTreeFactory rtreeFactory;
+    SkPackedRTreeFactory packedRTreeFactory;
+    for (SkBBHFactory* factory : { (SkBBHFactory*)nullptr,
+                                   (SkBBHFactory*)&rtreeFactory,
+                                   (SkBBHFactory*)&packedRTreeFactory }) {
+        std::atomic<int> decodes{0};
+        sk_sp<SkImage> image = SkImage::MakeFromGenerator(
+                skstd::make_unique<CountingGenerator>(&decodes));
+        sk_sp<SkPicture> picture = make_picture(factory, image);
+
+        // Antialiased edges can come out a little differently with the clip of a tile, so
+        // compare with drawing the picture into the same tiles one at a time.
+        SkGraphics::PurgeResourceCache();
+        for (int tileSize : {37, 64, 256}) {
+            SkBitmap expected;
+            draw_tiled(picture, &expected, tileSize, false, nullptr);
+            for (SkExecutor* tileExecutor : {(SkExecutor*)nullptr, executor.get()}) {
+                SkBitmap actual;
+                draw_tiled(picture, &actual, tileSize, true, tileExecutor);
+                REPORTER_ASSERT(r, sk_tool_utils::equal_pixels(expected, actual),
+                                "tile size %d, %s", tileSize, tileExecutor ? "threaded" : "serial");
+            }
+        }
+        REPORTER_ASSERT(r, 1 == decodes, "%d decodes", decodes.load());
+
+        // Every tile draws the image, but it's decoded once up front for all of them.
+        SkGraphics::PurgeResourceCache();
+        SkBitmap actual;
+        draw_tiled(picture, &actual, 37, true, executor.get());
+        REPORTER_ASSERT(r, 2 == decodes, "%d decodes", decodes.load());
+    }
+
+    // Pictures of a single op aren't SkBigPictures; they're played back whole into each tile.
+    SkPictureRecorder recorder;
+    recorder.beginRecording(200, 150)->drawRect(SkRect::MakeLTRB(50, 50, 150, 100), SkPaint());
+    sk_sp<SkPicture> mini = recorder.finishRecordingAsPicture();
+    SkBitmap expected, actual;
+    draw_tiled(mini, &expected, 64, false, nullptr);
+    draw_tiled(mini, &actual, 64, true, executor.get());
+    REPORTER_ASSERT(r, sk_tool_utils::equal_pixels(expected, actual));
+
+    // A tile drawn through a canvas that scales down looks further into the picture for ops
+    // antialiased into its last pixels.
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkCanvas* canvas = recorder.beginRecording(200, 150, &rtreeFactory);
+    canvas->drawRect(SkRect::MakeLTRB(20, 20, 60, 60), paint);
+    canvas->drawRect(SkRect::MakeLTRB(103.5f, 0, 140, 150), paint);
+    sk_sp<SkPicture> edge = recorder.finishRecordingAsPicture();
+    const SkIRect bounds = SkIRect::MakeWH(102, 150);
+    for (SkBitmap* bitmap : {&expected, &actual}) {
+        bitmap->allocN32Pixels(26, 38);
+        bitmap->eraseColor(SK_ColorTRANSPARENT);
+    }
+    SkCanvas expectedCanvas(expected), actualCanvas(actual);
+    expectedCanvas.scale(0.25f, 0.25f);
+    expectedCanvas.clipRect(SkRect::Make(bounds));
+    expectedCanvas.drawPicture(edge);
+    actualCanvas.scale(0.25f, 0.25f);
+    SkTiledPictureDraw tiled(edge);
+    tiled.add(&actualCanvas, bounds);
+    tiled.draw(executor.get());
+    REPORTER_ASSERT(r, sk_tool_utils::equal_pixels(expected, actual));
+}
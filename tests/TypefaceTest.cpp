@@ -8,8 +8,10 @@
 #include "SkAdvancedTypefaceMetrics.h"
 #include "SkData.h"
 #include "SkFixed.h"
+#include "SkFont.h"
 #include "SkFontDescriptor.h"
 #include "SkFontMgr.h"
+#include "SkFontPriv.h"
 #include "SkMakeUnique.h"
 #include "SkOTTable_OS_2.h"
 #include "SkSFNTHeader.h"
@@ -18,10 +20,14 @@
 #include "SkTestEmptyTypeface.h"
 #include "SkTypeface.h"
 #include "SkTypefaceCache.h"
+#include "SkUTF.h"
 #include "Resources.h"
 #include "Test.h"
 
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 static void TypefaceStyle_test(skiatest::Reporter* reporter,
                                uint16_t weight, uint16_t width, SkData* data)
@@ -297,6 +303,60 @@ DEF_TEST(TypefaceCache, reporter) {
     REPORTER_ASSERT(reporter, t1->unique());
 }
 
+static bool match_id_proc(SkTypeface* face, void* ctx) {
+    return face->uniqueID() == *static_cast<SkFontID*>(ctx);
+}
+
+DEF_TEST(TypefaceCache_Hashed, reporter) {
+    REPORTER_ASSERT(reporter, SkTypefaceCache::HashFamilyAndStyle("Sans", SkFontStyle()) ==
+                              SkTypefaceCache::HashFamilyAndStyle("Sans", SkFontStyle()));
+    REPORTER_ASSERT(reporter, SkTypefaceCache::HashFamilyAndStyle("Sans", SkFontStyle()) !=
+                              SkTypefaceCache::HashFamilyAndStyle("Sans", SkFontStyle::Bold()));
+
+    SkTypefaceCache cache;
+    std::vector<sk_sp<SkTypeface>> typefaces;
+    for (uint32_t hash = 0; hash < 100; hash++) {
+        typefaces.push_back(SkTestEmptyTypeface::Make());
+        cache.add(typefaces.back(), hash);
+    }
+
+    // Finds with a hash only see the typefaces added with it; finds without one see them all.
+    for (uint32_t hash = 0; hash < 100; hash++) {
+        SkFontID id = typefaces[hash]->uniqueID();
+        REPORTER_ASSERT(reporter, cache.findByProcAndRef(hash, match_id_proc, &id) ==
+                                  typefaces[hash]);
+        REPORTER_ASSERT(reporter, !cache.findByProcAndRef(hash + 16, match_id_proc, &id));
+        REPORTER_ASSERT(reporter, cache.findByProcAndRef(match_id_proc, &id) == typefaces[hash]);
+    }
+
+    // Typefaces in use survive adds that purge the cache while other threads find them.
+    std::vector<std::thread> threads;
+    std::atomic<int> misses{0};
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 1000; j++) {
+                uint32_t hash = (i * 1000 + j) % 100;
+                SkFontID id = typefaces[hash]->uniqueID();
+                if (cache.findByProcAndRef(hash, match_id_proc, &id) != typefaces[hash]) {
+                    misses++;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 3000; i++) {
+        cache.add(SkTestEmptyTypeface::Make(), 100 + i);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    REPORTER_ASSERT(reporter, misses == 0);
+    REPORTER_ASSERT(reporter, count(reporter, cache) <= 1024, "%d", count(reporter, cache));
+
+    typefaces.clear();
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, count(reporter, cache) == 0);
+}
+
 static void check_serialize_behaviors(sk_sp<SkTypeface> tf, bool isLocalData,
                                       skiatest::Reporter* reporter) {
     if (!tf) {
@@ -323,3 +383,44 @@ DEF_TEST(Typeface_serialize, reporter) {
 
 }
 
+
+DEF_TEST(Typeface_CharsToGlyphs, reporter) {
+    SkFont font(SkTypeface::MakeDefault());
+    int glyphCount = font.getTypefaceOrDefault()->countGlyphs();
+
+    // Each glyph's first character, from the cmap, maps back to it.
+    std::vector<SkGlyphID> glyphs(glyphCount);
+    std::vector<SkUnichar> unichars(glyphCount);
+    for (int i = 0; i < glyphCount; ++i) {
+        glyphs[i] = SkToU16(i);
+    }
+    SkFontPriv::GlyphsToUnichars(font, glyphs.data(), glyphCount, unichars.data());
+    for (int i = 0; i < glyphCount; ++i) {
+        SkGlyphID glyph;
+        if (unichars[i] != 0 &&
+            font.textToGlyphs(&unichars[i], sizeof(SkUnichar), kUTF32_SkTextEncoding,
+                              &glyph, 1) == 1) {
+            REPORTER_ASSERT(reporter, glyph == i, "U+%04X: %d, not %d", unichars[i], glyph, i);
+        }
+    }
+
+    // The encodings agree, on text in and out of the BMP.
+    const SkUnichar text[] = { 'H', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd', 0x0416,
+                               0x4E2D, 0x10330, 0x1F600, 0xFFFD, 0x20, 0x41 };
+    std::string utf8;
+    std::vector<uint16_t> utf16;
+    for (SkUnichar c : text) {
+        char bytes[SkUTF::kMaxBytesInUTF8Sequence];
+        utf8.append(bytes, SkUTF::ToUTF8(c, bytes));
+        uint16_t units[2];
+        utf16.insert(utf16.end(), units, units + SkUTF::ToUTF16(c, units));
+    }
+    const int count = SK_ARRAY_COUNT(text);
+    SkGlyphID glyphs32[count], glyphs16[count], glyphs8[count];
+    font.textToGlyphs(text, sizeof(text), kUTF32_SkTextEncoding, glyphs32, count);
+    font.textToGlyphs(utf16.data(), utf16.size() * sizeof(uint16_t), kUTF16_SkTextEncoding,
+                      glyphs16, count);
+    font.textToGlyphs(utf8.data(), utf8.size(), kUTF8_SkTextEncoding, glyphs8, count);
+    REPORTER_ASSERT(reporter, !memcmp(glyphs32, glyphs16, sizeof(glyphs32)));
+    REPORTER_ASSERT(reporter, !memcmp(glyphs32, glyphs8, sizeof(glyphs32)));
+}
@@ -21,6 +21,7 @@ DEFINE_string2(skps, r, "", ".SKPs to dump.");
 DEFINE_string(match, "", "The usual filters on file names to dump.");
 DEFINE_bool2(optimize, O, false, "Run SkRecordOptimize before dumping.");
 DEFINE_bool(optimize2, false, "Run SkRecordOptimize2 before dumping.");
+DEFINE_bool(hardClip, false, "Let --optimize2 assume the picture is drawn under a hard clip.");
 DEFINE_int32(tile, 1000000000, "Simulated tile size.");
 DEFINE_bool(timeWithCommand, false, "If true, print time next to command, else in first column.");
 DEFINE_string2(write, w, "", "Write the (optimized) picture to the named file.");
@@ -66,7 +67,10 @@ int main(int argc, char** argv) {
             SkRecordOptimize(&record);
         }
         if (FLAGS_optimize2) {
-            SkRecordOptimize2(&record);
+            SkRecordOptStats stats;
+            SkRecordOptimize2(&record, &stats, FLAGS_hardClip);
+            printf("optimize2: %d matrices, %d clips, %d covered draws, %d merged draws\n",
+                   stats.fMatrices, stats.fClips, stats.fCoveredDraws, stats.fMergedDraws);
         }
 
         dump(FLAGS_skps[i], w, h, record);
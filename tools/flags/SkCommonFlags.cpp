@@ -96,6 +96,11 @@ DEFINE_bool(forceAnalyticAA, false, "Force analytic anti-aliasing even if the pa
 DEFINE_bool(deltaAA, false,
             "If true, use delta anti-aliasing in suitable cases (it overrides forceAnalyticAA.");
 DEFINE_bool(forceDeltaAA, false, "Force delta anti-aliasing for all paths.");
+DEFINE_bool(threadedDAA, false, "If true, delta anti-aliasing splits huge paths into bands that "
+                                "are scan converted in parallel.");
+DEFINE_bool(sparseAA, false, "If true, use sparse tile anti-aliasing for large paths.");
+DEFINE_bool(forceSparseAA, false, "Force sparse tile anti-aliasing for all non-inverse paths.");
+DEFINE_bool(rasterGlyphAtlas, false, "If true, raster text blits small glyphs out of glyph atlases.");
 
 DEFINE_int32(backendTiles, 3, "Number of tiles in the experimental threaded backend.");
 DEFINE_int32(backendThreads, 2, "Number of threads in the experimental threaded backend.");
@@ -40,6 +40,10 @@ DECLARE_bool(analyticAA);
 DECLARE_bool(forceAnalyticAA);
 DECLARE_bool(deltaAA);
 DECLARE_bool(forceDeltaAA);
+DECLARE_bool(threadedDAA);
+DECLARE_bool(sparseAA);
+DECLARE_bool(forceSparseAA);
+DECLARE_bool(rasterGlyphAtlas);
 DECLARE_string(key);
 DECLARE_string(properties);
 DECLARE_int32(backendTiles);
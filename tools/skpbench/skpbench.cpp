@@ -15,6 +15,7 @@
 #include "SkCommonFlags.h"
 #include "SkCommonFlagsGpu.h"
 #include "SkDeferredDisplayList.h"
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkGr.h"
 #include "SkOSFile.h"
@@ -26,6 +27,7 @@
 #include "SkSurface.h"
 #include "SkSurfaceProps.h"
 #include "SkTaskGroup.h"
+#include "SkTiledPictureDraw.h"
 #include "flags/SkCommandLineFlags.h"
 #include "flags/SkCommonFlagsConfig.h"
 #include "sk_tool_utils.h"
@@ -48,10 +50,11 @@
  * directly. Limiting the entire process to a single config/skp pair helps to keep the results
  * repeatable.
  *
- * No tiling, looping, or other fanciness is used; it just draws the skp whole into a size-matched
- * render target and syncs the GPU after each draw.
+ * On GPU configs, no tiling, looping, or other fanciness is used; it just draws the skp whole into
+ * a size-matched render target and syncs the GPU after each draw.
  *
- * Currently, only GPU configs are supported.
+ * The 8888 config draws the skp on the CPU instead, in tiles that are played back concurrently on
+ * --rasterThreads threads, to measure how raster playback scales with threads.
  */
 
 DEFINE_bool(ddl, false, "record the skp into DDLs before rendering");
@@ -59,6 +62,9 @@ DEFINE_int32(ddlNumAdditionalThreads, 0, "number of DDL recording threads in add
 DEFINE_int32(ddlTilingWidthHeight, 0, "number of tiles along one edge when in DDL mode");
 DEFINE_bool(ddlRecordTime, false, "report just the cpu time spent recording DDLs");
 
+DEFINE_int32(rasterThreads, 1, "number of threads, including the main one, to draw 8888 tiles on");
+DEFINE_int32(rasterTileSize, 256, "width and height of the tiles 8888 is drawn in");
+
 DEFINE_int32(duration, 5000, "number of milliseconds to run the benchmark");
 DEFINE_int32(sampleMs, 50, "minimum duration of a sample");
 DEFINE_bool(gpuClock, false, "time on the gpu clock (gpu work only)");
@@ -113,6 +119,9 @@ enum class ExitErr {
 };
 
 static void draw_skp_and_flush(SkSurface*, const SkPicture*);
+static void run_raster(const SkCommandLineConfig*, sk_sp<SkPicture>, int width, int height,
+                       const SkString& srcname);
+static void save_png(const SkBitmap&);
 static sk_sp<SkPicture> create_warmup_skp();
 static sk_sp<SkPicture> create_skp_from_svg(SkStream*, const char* filename);
 static bool mkdir_p(const SkString& name);
@@ -338,9 +347,12 @@ int main(int argc, char** argv) {
     const SkCommandLineConfigGpu* config = nullptr; // Initialize for spurious warning.
     SkCommandLineConfigArray configs;
     ParseConfigs(FLAGS_config, &configs);
-    if (configs.count() != 1 || !(config = configs[0]->asConfigGpu())) {
-        exitf(ExitErr::kUsage, "invalid config '%s': must specify one (and only one) GPU config",
-                               join(FLAGS_config).c_str());
+    const bool raster = configs.count() == 1 && configs[0]->getBackend().equals("8888") &&
+                        configs[0]->getViaParts().empty();
+    if (configs.count() != 1 || !(raster || (config = configs[0]->asConfigGpu()))) {
+        exitf(ExitErr::kUsage,
+              "invalid config '%s': must specify one (and only one) GPU config, or 8888",
+              join(FLAGS_config).c_str());
     }
 
     // Parse the skp.
@@ -382,6 +394,10 @@ int main(int argc, char** argv) {
                         SkScalarCeilToInt(skp->cullRect().height()), width, height);
     }
 
+    if (raster) {
+        run_raster(configs[0].get(), std::move(skp), width, height, srcname);
+    }
+
     if (config->getSurfType() != SkCommandLineConfigGpu::SurfType::kDefault) {
         exitf(ExitErr::kUnavailable, "This tool only supports the default surface type. (%s)",
               config->getTag().c_str());
@@ -469,14 +485,90 @@ int main(int argc, char** argv) {
         if (!surface->getCanvas()->readPixels(bmp, 0, 0)) {
             exitf(ExitErr::kUnavailable, "failed to read canvas pixels for png");
         }
-        if (!mkdir_p(SkOSPath::Dirname(FLAGS_png[0]))) {
-            exitf(ExitErr::kIO, "failed to create directory for png \"%s\"", FLAGS_png[0]);
-        }
-        if (!sk_tool_utils::EncodeImageToFile(FLAGS_png[0], bmp, SkEncodedImageFormat::kPNG, 100)) {
-            exitf(ExitErr::kIO, "failed to save png to \"%s\"", FLAGS_png[0]);
+        save_png(bmp);
+    }
+
+    exit(0);
+}
+
+static void run_raster_benchmark(SkTiledPictureDraw* tiles, SkExecutor* executor,
+                                 std::vector<Sample>* samples) {
+    using clock = std::chrono::high_resolution_clock;
+    const Sample::duration sampleDuration = std::chrono::milliseconds(FLAGS_sampleMs);
+    const clock::duration benchDuration = std::chrono::milliseconds(FLAGS_duration);
+
+    tiles->draw(executor); // Decode images, warm up caches, etc.
+
+    clock::time_point now = clock::now();
+    const clock::time_point endTime = now + benchDuration;
+
+    do {
+        clock::time_point sampleStart = now;
+        samples->emplace_back();
+        Sample& sample = samples->back();
+
+        do {
+            tiles->draw(executor);
+
+            now = clock::now();
+            sample.fDuration = now - sampleStart;
+            ++sample.fFrames;
+        } while (sample.fDuration < sampleDuration);
+    } while (now < endTime || 0 == samples->size() % 2);
+}
+
+static void run_raster(const SkCommandLineConfig* config, sk_sp<SkPicture> skp,
+                       int width, int height, const SkString& srcname) {
+    if (FLAGS_gpuClock || FLAGS_ddl) {
+        exitf(ExitErr::kUsage, "--gpuClock and --ddl are only supported by GPU configs");
+    }
+    if (FLAGS_rasterThreads < 1 || FLAGS_rasterTileSize < 1) {
+        exitf(ExitErr::kUsage, "--rasterThreads and --rasterTileSize must be positive");
+    }
+
+    // Every tile draws straight into its part of one bitmap.
+    SkBitmap bmp;
+    bmp.allocPixels(SkImageInfo::MakeN32Premul(width, height));
+    bmp.eraseColor(SK_ColorTRANSPARENT);
+
+    const int left = SkScalarFloorToInt(skp->cullRect().x()),
+              top  = SkScalarFloorToInt(skp->cullRect().y());
+    SkTiledPictureDraw tiles(std::move(skp));
+    std::vector<std::unique_ptr<SkCanvas>> canvases;
+    for (int y = 0; y < height; y += FLAGS_rasterTileSize) {
+        for (int x = 0; x < width; x += FLAGS_rasterTileSize) {
+            SkIRect bounds = SkIRect::MakeXYWH(x, y, FLAGS_rasterTileSize, FLAGS_rasterTileSize);
+            bounds.intersect(bmp.bounds());
+            SkBitmap tile;
+            bmp.extractSubset(&tile, bounds);
+            canvases.emplace_back(new SkCanvas(tile));
+            tiles.add(canvases.back().get(), bounds.makeOffset(left, top));
         }
     }
 
+    // The main thread draws tiles too while it waits for the pool.
+    std::unique_ptr<SkExecutor> executor;
+    if (FLAGS_rasterThreads > 1) {
+        executor = SkExecutor::MakeFIFOThreadPool(FLAGS_rasterThreads - 1);
+    }
+
+    std::vector<Sample> samples;
+    if (FLAGS_sampleMs > 0) {
+        // +1 because we might take one more sample in order to have an odd number.
+        samples.reserve(1 + (FLAGS_duration + FLAGS_sampleMs - 1) / FLAGS_sampleMs);
+    } else {
+        samples.reserve(2 * FLAGS_duration);
+    }
+    run_raster_benchmark(&tiles, executor.get(), &samples);
+
+    SkString configName = SkStringPrintf("%s_t%i", config->getTag().c_str(), FLAGS_rasterThreads);
+    print_result(samples, configName.c_str(), srcname.c_str());
+
+    // Save a proof (if one was requested).
+    if (!FLAGS_png.isEmpty()) {
+        save_png(bmp);
+    }
+
     exit(0);
 }
 
@@ -534,6 +626,15 @@ static sk_sp<SkPicture> create_skp_from_svg(SkStream* stream, const char* filena
     return nullptr;
 }
 
+static void save_png(const SkBitmap& bmp) {
+    if (!mkdir_p(SkOSPath::Dirname(FLAGS_png[0]))) {
+        exitf(ExitErr::kIO, "failed to create directory for png \"%s\"", FLAGS_png[0]);
+    }
+    if (!sk_tool_utils::EncodeImageToFile(FLAGS_png[0], bmp, SkEncodedImageFormat::kPNG, 100)) {
+        exitf(ExitErr::kIO, "failed to save png to \"%s\"", FLAGS_png[0]);
+    }
+}
+
 bool mkdir_p(const SkString& dirname) {
     if (dirname.isEmpty()) {
         return true;
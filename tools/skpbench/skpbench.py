@@ -63,7 +63,7 @@ __argparse.add_argument('--pr',
 __argparse.add_argument('--nocache',
   action='store_true', help="disable caching of path mask textures")
 __argparse.add_argument('-c', '--config',
-  default='gl', help="comma- or space-separated list of GPU configs")
+  default='gl', help="comma- or space-separated list of GPU configs, and/or 8888")
 __argparse.add_argument('-a', '--resultsfile',
   help="optional file to append results into")
 __argparse.add_argument('--ddl',
@@ -79,6 +79,9 @@ __argparse.add_argument('--gpuThreads',
   type=int, default=-1,
   help="Create this many extra threads to assist with GPU work, including"
        " software path rendering. Defaults to two.")
+__argparse.add_argument('--rasterThreads',
+  help="comma- or space-separated list of thread counts to draw the 8888 "
+       "config on, e.g. '1,2,4,8'. Defaults to one.")
 __argparse.add_argument('srcs',
   nargs='+',
   help=".skp files or directories to expand for .skp files, and/or .svg files")
@@ -178,9 +181,10 @@ class SKPBench:
         return
     raise Exception('Invalid warmup output:\n%s' % output)
 
-  def __init__(self, src, config, max_stddev, best_result=None):
+  def __init__(self, src, config, threads, max_stddev, best_result=None):
     self.src = src
     self.config = config
+    self.threads = threads
     self.max_stddev = max_stddev
     self.best_result = best_result
     self._queue = Queue()
@@ -204,6 +208,8 @@ class SKPBench:
     commandline = self.ARGV + ['--config', self.config,
                                '--src', self.src,
                                '--suppressHeader', 'true']
+    if self.threads:
+      commandline.extend(['--rasterThreads', str(self.threads)])
     if FLAGS.write_path:
       pngfile = _path.join(FLAGS.write_path, self.config,
                            _path.basename(self.src) + '.png')
@@ -271,9 +277,13 @@ def emit_result(line, resultsfile=None):
 
 def run_benchmarks(configs, srcs, hardware, resultsfile=None):
   hasheader = False
-  benches = collections.deque([(src, config, FLAGS.max_stddev)
+  rasterthreads = [int(x) for x in re.split(r'[ ,]', FLAGS.rasterThreads) if x] \
+                  if FLAGS.rasterThreads else [None]
+  benches = collections.deque([(src, config, threads, FLAGS.max_stddev)
                                for src in srcs
-                               for config in configs])
+                               for config in configs
+                               for threads in (rasterthreads
+                                               if config == '8888' else [None])])
   while benches:
     try:
       with hardware:
@@ -302,8 +312,8 @@ def run_benchmarks(configs, srcs, hardware, resultsfile=None):
                        skpbench.best_result.stddev, skpbench.max_stddev,
                        retry_max_stddev),
                       file=sys.stderr)
-              benches.append((skpbench.src, skpbench.config, retry_max_stddev,
-                              skpbench.best_result))
+              benches.append((skpbench.src, skpbench.config, skpbench.threads,
+                              retry_max_stddev, skpbench.best_result))
 
             except HardwareException as exception:
               skpbench.terminate()